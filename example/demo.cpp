@@ -282,6 +282,7 @@ demo_frame::demo_frame(int page) : ui::frame("Boost.UI Demo")
         .on_mouse_leave_event(utility::make_event_handler<ui::mouse_event>("canvas", "mouse leave"))
         .on_context_menu_event(utility::make_event_handler<ui::mouse_event>("canvas", "context menu"))
         .on_mouse_wheel_event(utility::make_event_handler<ui::wheel_event>("canvas", "mouse wheel"))
+        .coalesce_events()
         .on_mouse_drag_event(&this_type::on_canvas_mouse_draw, this)
         .on_context_menu_event(&this_type::on_canvas_context_menu, this)
         ;
@@ -597,9 +598,15 @@ void demo_frame::on_canvas_resize()
 
 void demo_frame::on_canvas_mouse_draw(ui::mouse_event& e)
 {
-    m_canvas.painter()
-        .fill_color(ui::color::red)
-        .fill_rect(e.x() - 1, e.y() - 1, 3, 3);
+    ui::painter painter = m_canvas.painter();
+    painter.fill_color(ui::color::red);
+
+    const std::vector<ui::point>& history = e.history();
+    for ( std::vector<ui::point>::const_iterator iter = history.begin();
+          iter != history.end(); ++iter )
+        painter.fill_rect(iter->x() - 1, iter->y() - 1, 3, 3);
+
+    painter.fill_rect(e.x() - 1, e.y() - 1, 3, 3);
 }
 
 void demo_frame::on_canvas_context_menu(ui::mouse_event& e)
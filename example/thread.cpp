@@ -3,7 +3,7 @@
 // Distributed under the Boost Software License, Version 1.0.
 // See http://www.boost.org/LICENSE_1_0.txt
 
-// Fill text box using multiple worker threads.
+// Fill text box using the pool of worker threads.
 
 #include <boost/ui.hpp>
 #include <boost/bind.hpp>
@@ -31,9 +31,10 @@ public:
 
 private:
     void on_start();
-    void thread_entry(int thread_number, int repeats);
-    void write(std::wstring str);
+    static std::wstring job(int job_number, int repeats);
+    void write(const std::wstring& str);
 
+    ui::thread_pool m_pool;
     ui::text_box m_output_widget;
     ui::string_box m_threads_count_widget;
     ui::string_box m_repeats_widget;
@@ -45,14 +46,15 @@ thread_dialog::thread_dialog() : ui::dialog(
 #else
     "Boost."
 #endif
-    "Thread + Boost.UI Example")
+    "Thread + Boost.UI Example"),
+    m_pool(thread_ns::thread::hardware_concurrency())
 {
     ui::hbox(*this)
         << m_output_widget.create(*this)
             .tooltip("Output")
             .layout().justify().stretch()
         << ( ui::vbox().layout().justify()
-            << ui::label(*this, "Threads count:")
+            << ui::label(*this, "Jobs count:")
                 .layout().margin(1, 1, 0, 1)
             << m_threads_count_widget.create(*this, to_string(
                     100 * thread_ns::thread::hardware_concurrency() ))
@@ -61,7 +63,7 @@ thread_dialog::thread_dialog() : ui::dialog(
                 .layout().margin(1, 1, 0, 1)
             << m_repeats_widget.create(*this, "10")
                 .layout().justify()
-            << ui::button(*this, "&Start threads")
+            << ui::button(*this, "&Start jobs")
                 .on_press(&this_type::on_start, this)
                 .layout().justify()
            )
@@ -72,39 +74,35 @@ thread_dialog::thread_dialog() : ui::dialog(
 
 void thread_dialog::on_start()
 {
-    const int threads_count = boost::lexical_cast<int>(m_threads_count_widget.text());
-    const int repeats       = boost::lexical_cast<int>(m_repeats_widget.text());
+    const int jobs_count = boost::lexical_cast<int>(m_threads_count_widget.text());
+    const int repeats    = boost::lexical_cast<int>(m_repeats_widget.text());
 
     m_output_widget.clear();
 
-    for ( int i = 0; i < threads_count; i++ )
+    for ( int i = 0; i < jobs_count; i++ )
     {
-        // Single thread
-        //thread_entry(i, repeats);
-
-        thread_ns::thread t(&this_type::thread_entry, this, i, repeats);
-        t.detach();
+        // Job is called in the worker thread, its result is written in the UI thread
+        ui::async(m_pool, boost::bind(&this_type::job, i, repeats))
+            .then_on_ui(boost::bind(&this_type::write, this, _1));
     }
 }
 
-void thread_dialog::thread_entry(int thread_number, int repeats)
+std::wstring thread_dialog::job(int job_number, int repeats)
 {
+    std::wostringstream ss;
     for ( int r = 0; r < repeats; r++ )
     {
-        std::wostringstream ss;
-        ss << thread_number << L"-" << r << " ";
+        ss << job_number << L"-" << r << " ";
 
         // Not thread safe
         //write(ss.str());
-
-        // Thread safe
-        ui::call_async( boost::bind(&this_type::write, this, ss.str()) );
     }
+    return ss.str();
 }
 
-void thread_dialog::write(std::wstring str)
+void thread_dialog::write(const std::wstring& str)
 {
-    m_output_widget.text(m_output_widget.text() + str);
+    m_output_widget.append(str);
 }
 
 int ui_main()
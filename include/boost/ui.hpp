@@ -9,6 +9,8 @@
 #define BOOST_UI_HPP
 
 #include <boost/ui/application.hpp>
+#include <boost/ui/async_log.hpp>
+#include <boost/ui/atom.hpp>
 #include <boost/ui/audio.hpp>
 #include <boost/ui/button.hpp>
 #include <boost/ui/canvas.hpp>
@@ -18,19 +20,23 @@
 #include <boost/ui/color_io.hpp>
 #include <boost/ui/combo_box.hpp>
 #include <boost/ui/config.hpp>
+#include <boost/ui/connection.hpp>
 #include <boost/ui/coord.hpp>
 #include <boost/ui/coord_io.hpp>
+#include <boost/ui/coroutine.hpp>
 #include <boost/ui/datetime.hpp>
 #include <boost/ui/def.hpp>
 #include <boost/ui/dialog.hpp>
 #include <boost/ui/event.hpp>
 #include <boost/ui/event_loop.hpp>
+#include <boost/ui/event_trace.hpp>
 #include <boost/ui/font.hpp>
 #include <boost/ui/frame.hpp>
 #include <boost/ui/group_box.hpp>
 #include <boost/ui/hyperlink.hpp>
 #include <boost/ui/image.hpp>
 #include <boost/ui/image_widget.hpp>
+#include <boost/ui/input_record.hpp>
 #include <boost/ui/label.hpp>
 #include <boost/ui/layout.hpp>
 #include <boost/ui/line.hpp>
@@ -47,10 +53,12 @@
 #include <boost/ui/status_bar.hpp>
 #include <boost/ui/stream.hpp>
 #include <boost/ui/string.hpp>
+#include <boost/ui/string_builder.hpp>
 #include <boost/ui/string_io.hpp>
 #include <boost/ui/strings_box.hpp>
 #include <boost/ui/text_box.hpp>
 #include <boost/ui/thread.hpp>
+#include <boost/ui/thread_pool.hpp>
 #include <boost/ui/web_widget.hpp>
 #include <boost/ui/widget.hpp>
 #include <boost/ui/window.hpp>
@@ -127,6 +135,7 @@ Other widgets not support drawing.
 @subsection thread_safety Thread safety
 Boost.UI is @b NOT thread safe library, so you should use @ref boost::ui::call_async() function to synchronize worker threads with main (GUI) thread.
 However you can use @ref log in any thread, it is thread safe.
+Long time calculations could be called in @ref boost::ui::thread_pool using @ref boost::ui::async() function that passes their results to main thread.
 
 @subsection event_loops Event loops
 Boost.UI has own event loops and you can't create other your own event loops inside main (GUI) thread without freezing GUI.
@@ -214,6 +223,7 @@ Read README.md file for build instructions and library details.
 @example spirit.cpp Boost.Spirit usage example
 @example thread.cpp Boost.Thread and std::thread usage example
 @see boost::ui::call_async
+@see boost::ui::thread_pool
 @see <a href="http://en.wikipedia.org/wiki/Thread_(computing)">Thread (Wikipedia)</a>
 @example timer.cpp Boost.Timer usage example
 @see boost::ui::on_timeout
@@ -287,6 +297,11 @@ Read README.md file for build instructions and library details.
 @brief Event loop, event handler related classes and global event handlers
 @details Usage example:
 @snippet cpp11/snippet.cpp event
+
+Exception that leaves an event handler, a posted task or an async call
+is shown by the application and the event loop continues.
+Exceptions are caught once per dispatched event, not per handler,
+so a throwing handler also skips the remaining handlers of the same event.
 @see <a href="http://en.wikipedia.org/wiki/Event_(computing)">Event (Wikipedia)</a>
 @see <a href="http://www.w3.org/TR/uievents/">UI Events (W3C)</a>
 
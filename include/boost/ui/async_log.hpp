@@ -0,0 +1,160 @@
+// Copyright (c) 2018 Kolya Kosenko
+
+// Distributed under the Boost Software License, Version 1.0.
+// See http://www.boost.org/LICENSE_1_0.txt
+
+/// @file async_log.hpp @brief Asynchronous logging backend
+
+#ifndef BOOST_UI_ASYNC_LOG_HPP
+#define BOOST_UI_ASYNC_LOG_HPP
+
+#include <boost/ui/config.hpp>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <boost/ui/log.hpp>
+
+#include <boost/cstdint.hpp>
+#include <boost/core/noncopyable.hpp>
+#include <boost/core/scoped_enum.hpp>
+
+#include <cstddef>
+
+namespace boost {
+namespace ui    {
+
+/// @brief Log message with its attributes
+/// @ingroup log
+struct log_record
+{
+    log_level level;       ///< Severity of the message
+    boost::int64_t time;   ///< Milliseconds since the Epoch in UTC
+    uistring message;      ///< Logged text
+};
+
+/// @brief Destination of log records, see async_log
+/// @ingroup log
+
+class BOOST_UI_DECL log_sink : private boost::noncopyable
+{
+public:
+    virtual ~log_sink() {}
+
+    /// @brief Writes batch of records
+    /// @details Called from the background thread of async_log.
+    virtual void write(const log_record* records, std::size_t count) = 0;
+
+    /// Flushes written records, called when the queue becomes empty
+    virtual void flush() {}
+};
+
+/// @brief Sink that writes log records into the file in UTF-8 encoding
+/// @ingroup log
+
+class BOOST_UI_DECL file_log_sink : public log_sink
+{
+public:
+    /// @brief Opens file for appending
+    /// @throw std::runtime_error if the file can't be opened
+    explicit file_log_sink(const uistring& path);
+    ~file_log_sink();
+
+    void write(const log_record* records, std::size_t count);
+    void flush();
+
+private:
+    class detail_impl;
+    detail_impl* m_impl;
+};
+
+/// @brief Sink that writes log records into the standard error stream
+/// @ingroup log
+
+class BOOST_UI_DECL stderr_log_sink : public log_sink
+{
+public:
+    void write(const log_record* records, std::size_t count);
+    void flush();
+};
+
+/// @brief Sink that passes log records to the native logging
+/// @details Records are shown like by @ref log class.
+/// @ingroup log
+
+class BOOST_UI_DECL native_log_sink : public log_sink
+{
+public:
+    void write(const log_record* records, std::size_t count);
+};
+
+/// @brief Behavior of async_log when its queue is full
+/// @ingroup log
+BOOST_SCOPED_ENUM_DECLARE_BEGIN(log_overflow)
+{
+    drop,  ///< Record is dropped
+    block, ///< Logging thread waits for the free space
+    sample ///< Every sample_rate-th record waits for the free space, others are dropped
+}
+BOOST_SCOPED_ENUM_DECLARE_END(log_overflow)
+
+/// @brief Asynchronous logging backend
+/// @details Logging threads push records into the bounded lock-free queue
+/// without waiting for output. Background thread writes records
+/// into sinks by batches.
+/// If the backend is installed, @ref log objects push records into it
+/// instead of the synchronous native logging.
+/// @ingroup log
+
+class BOOST_UI_DECL async_log : private boost::noncopyable
+{
+public:
+    /// @brief Starts background thread
+    /// @param capacity Maximal count of records in the queue, rounded up to the power of two
+    /// @param overflow Behavior when the queue is full
+    /// @param sample_rate Every sample_rate-th record isn't dropped
+    ///        if @a overflow is log_overflow::sample
+    /// @throw std::runtime_error if thread can't be started
+    explicit async_log(std::size_t capacity = 8192,
+                       log_overflow overflow = log_overflow::drop,
+                       unsigned sample_rate = 100);
+
+    /// Writes remaining records, stops background thread and deletes sinks
+    ~async_log();
+
+    /// Adds sink and takes ownership of it. This function is thread safe.
+    void add_sink(log_sink* sink);
+
+    ///@{ @brief Pushes record into the queue. This function is thread safe.
+    /// @return false if the record is dropped
+    bool push(log_level level, const uistring& message);
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+    bool push(log_level level, uistring&& message);
+#endif
+    ///@}
+
+    /// Waits until records pushed before the call are written into sinks
+    void flush();
+
+    /// Returns count of records that were dropped because the queue was full
+    boost::uint64_t dropped() const;
+
+    /// @brief Routes @ref log output into @a backend, NULL restores native logging
+    /// @details Backend should live until logging threads are stopped.
+    static void install(async_log* backend);
+
+    /// Returns installed backend or NULL
+    static async_log* installed();
+
+private:
+    bool push_record(log_record& record);
+
+    class detail_impl;
+    detail_impl* m_impl;
+};
+
+} // namespace ui
+} // namespace boost
+
+#endif // BOOST_UI_ASYNC_LOG_HPP
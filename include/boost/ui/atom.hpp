@@ -0,0 +1,149 @@
+// Copyright (c) 2018 Kolya Kosenko
+
+// Distributed under the Boost Software License, Version 1.0.
+// See http://www.boost.org/LICENSE_1_0.txt
+
+/// @file atom.hpp @brief Interned string class
+
+#ifndef BOOST_UI_ATOM_HPP
+#define BOOST_UI_ATOM_HPP
+
+#include <boost/ui/config.hpp>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <boost/ui/string.hpp>
+
+namespace boost {
+namespace ui    {
+
+/// @brief Interned immutable string
+/// @details Equal strings share the single reference-counted copy
+/// that is released when the last atom is destroyed.
+/// Atoms are compared and hashed in constant time.
+/// Atom is implicitly converted to @ref uistring,
+/// so it could be passed to functions that take uistring.
+/// This class is thread safe.
+/// @see <a href="http://en.wikipedia.org/wiki/String_interning">String interning (Wikipedia)</a>
+/// @ingroup helper
+
+class BOOST_UI_DECL atom
+{
+public:
+    /// Constructs empty atom
+    atom() BOOST_NOEXCEPT : m_entry(NULL) {}
+
+    ///@{ Finds or adds string into the atom table
+    atom(const uistring& str);
+#ifndef BOOST_UI_NO_CAST_FROM_ASCII
+    atom(const char* str);
+#endif
+    atom(const wchar_t* str);
+    ///@}
+
+    atom(const atom& other) BOOST_NOEXCEPT;
+    atom& operator=(const atom& other) BOOST_NOEXCEPT;
+
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+    atom(atom&& other) BOOST_NOEXCEPT : m_entry(other.m_entry)
+        { other.m_entry = NULL; }
+    atom& operator=(atom&& other) BOOST_NOEXCEPT
+    {
+        swap(other);
+        return *this;
+    }
+#endif
+
+    ~atom();
+
+    /// Exchanges the contents of atoms
+    void swap(atom& other) BOOST_NOEXCEPT
+    {
+        entry* temp = m_entry;
+        m_entry = other.m_entry;
+        other.m_entry = temp;
+    }
+
+    /// Returns interned string
+    const uistring& str() const BOOST_NOEXCEPT;
+
+    /// Returns interned string
+    operator const uistring&() const BOOST_NOEXCEPT { return str(); }
+
+    /// Checks whether the atom is empty
+    bool empty() const BOOST_NOEXCEPT { return m_entry == NULL; }
+
+    /// Returns the hash of the interned string in constant time
+    std::size_t hash() const BOOST_NOEXCEPT;
+
+    ///@{ Compares atoms in constant time
+    bool operator==(const atom& other) const BOOST_NOEXCEPT
+        { return m_entry == other.m_entry; }
+    bool operator!=(const atom& other) const BOOST_NOEXCEPT
+        { return m_entry != other.m_entry; }
+    ///@}
+
+    ///@{ Compares interned strings lexicographically
+    bool operator<(const atom& other) const BOOST_NOEXCEPT
+        { return m_entry != other.m_entry && str() < other.str(); }
+    bool operator<=(const atom& other) const BOOST_NOEXCEPT
+        { return !( other < *this ); }
+    bool operator>(const atom& other) const BOOST_NOEXCEPT
+        { return other < *this; }
+    bool operator>=(const atom& other) const BOOST_NOEXCEPT
+        { return !( *this < other ); }
+    ///@}
+
+    /// Returns count of distinct strings in the atom table
+    static std::size_t table_size();
+
+private:
+    class entry;
+    class table;
+    entry* m_entry;
+
+    void intern(const uistring& str);
+};
+
+/// @brief Exchanges the contents of atoms
+/// @relatesalso boost::ui::atom
+inline void swap(atom& lhs, atom& rhs) BOOST_NOEXCEPT
+{
+    lhs.swap(rhs);
+}
+
+/// @brief Returns the hash of the interned string in constant time
+/// @relatesalso boost::ui::atom
+inline std::size_t hash_value(const atom& value) BOOST_NOEXCEPT
+{
+    return value.hash();
+}
+
+} // namespace ui
+} // namespace boost
+
+namespace std {
+
+#ifndef BOOST_UI_NO_STD_HASH
+
+/// @brief std::hash specialization for @ref boost::ui::atom
+template<>
+struct hash<boost::ui::atom>
+{
+    typedef boost::ui::atom argument_type;
+    typedef std::size_t result_type;
+
+    /// @brief Returns the hash of the interned string
+    std::size_t operator()(const boost::ui::atom& key) const
+    {
+        return key.hash();
+    }
+};
+
+#endif
+
+} // namespace std
+
+#endif // BOOST_UI_ATOM_HPP
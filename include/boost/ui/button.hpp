@@ -42,7 +42,7 @@ public:
     BOOST_UI_DETAIL_HANDLER(press, button);
 
 private:
-    void on_press_raw(const boost::function<void()>& handler);
+    connection on_press_raw(const boost::function<void()>& handler, bool replace);
 
     class detail_impl;
 };
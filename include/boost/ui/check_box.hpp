@@ -78,7 +78,7 @@ protected:
 #endif
 
 private:
-    void on_toggle_raw(const boost::function<void()>& handler);
+    connection on_toggle_raw(const boost::function<void()>& handler, bool replace);
 
     class detail_impl;
     detail_impl* get_impl();
@@ -82,8 +82,8 @@ public:
     ///@}
 
 private:
-    void on_select_raw(const boost::function<void()>& handler);
-    void on_select_event_raw(const boost::function<void(index_event&)>& handler);
+    connection on_select_raw(const boost::function<void()>& handler, bool replace);
+    connection on_select_event_raw(const boost::function<void(index_event&)>& handler, bool replace);
 
     class detail_impl;
     detail_impl* get_impl();
@@ -26,6 +26,13 @@
 
 #endif
 
+//------------------------------------------------------------------------------
+// C++20 coroutines
+
+#if !defined(__cpp_impl_coroutine) || __cpp_impl_coroutine < 201902L
+#define BOOST_UI_NO_COROUTINES
+#endif
+
 //------------------------------------------------------------------------------
 // normalize macros
 
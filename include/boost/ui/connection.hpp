@@ -0,0 +1,201 @@
+// Copyright (c) 2018 Kolya Kosenko
+
+// Distributed under the Boost Software License, Version 1.0.
+// See http://www.boost.org/LICENSE_1_0.txt
+
+/// @file connection.hpp @brief Connection between event and its handler
+
+#ifndef BOOST_UI_CONNECTION_HPP
+#define BOOST_UI_CONNECTION_HPP
+
+#include <boost/ui/config.hpp>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <boost/core/noncopyable.hpp>
+
+namespace boost {
+namespace ui    {
+
+#ifndef DOXYGEN
+
+namespace detail {
+
+// Shared state of the connection between event and its handler,
+// it is used from the UI thread only
+class BOOST_UI_DECL connection_state : private boost::noncopyable
+{
+public:
+    connection_state()
+        : m_refs(0), m_connected(true),
+          m_source(NULL), m_type(0), m_key(NULL) {}
+
+    void add_ref() { ++m_refs; }
+    void release()
+    {
+        if ( --m_refs == 0 )
+            delete this;
+    }
+
+    bool connected() const { return m_connected; }
+    void disconnect();
+
+    // Registers handler that has pending coalesced event
+    // to be delivered before other events of the same source
+    void add_pending();
+    void remove_pending();
+
+protected:
+    virtual ~connection_state();
+
+    // Removes handler from the event source, called once
+    virtual void do_disconnect() = 0;
+
+    // Called when the event source has removed handler itself
+    void detach();
+
+    // Registers connection of the handler of event type
+    // to be disconnected by disconnect_all()
+    void register_source(const void* source, int type, const void* key);
+
+    // Disconnects all registered handlers of the event type with the same key
+    static void disconnect_all(const void* source, int type, const void* key);
+
+    // Delivers pending coalesced events of the source
+    static void deliver_pending(const void* source);
+
+    // Delivers pending coalesced event of this handler
+    virtual void do_deliver_pending() {}
+
+private:
+    void unregister_source();
+
+    long m_refs;
+    bool m_connected;
+
+    const void* m_source;
+    int m_type;
+    const void* m_key;
+};
+
+} // namespace detail
+
+#endif
+
+/// @brief Connection between event and its handler
+/// @details Connection objects are returned by connect_* and replace_*
+/// functions of widgets. Copies of connection refer to the same handler.
+/// Connection should be used from the UI thread only.
+/// @see scoped_connection
+/// @ingroup event
+
+class BOOST_UI_DECL connection
+{
+public:
+    /// Constructs empty connection
+    connection() : m_state(NULL) {}
+
+#ifndef DOXYGEN
+    explicit connection(detail::connection_state* state) : m_state(state)
+        { add_ref(); }
+#endif
+
+    connection(const connection& other) : m_state(other.m_state)
+        { add_ref(); }
+
+    connection& operator=(const connection& other)
+    {
+        connection(other).swap(*this);
+        return *this;
+    }
+
+    ~connection()
+    {
+        if ( m_state )
+            m_state->release();
+    }
+
+    /// @brief Removes handler from the event
+    /// @details Does nothing if the handler is already removed
+    /// or the widget was destroyed. Handler could disconnect itself.
+    void disconnect()
+    {
+        if ( m_state )
+            m_state->disconnect();
+    }
+
+    /// Returns true if handler still receives events
+    bool connected() const
+    {
+        return m_state && m_state->connected();
+    }
+
+    /// Exchanges connections
+    void swap(connection& other) BOOST_NOEXCEPT
+    {
+        detail::connection_state* state = m_state;
+        m_state = other.m_state;
+        other.m_state = state;
+    }
+
+    /// Returns true if connections refer to the same handler
+    friend bool operator==(const connection& lhs, const connection& rhs)
+        { return lhs.m_state == rhs.m_state; }
+
+    /// Returns true if connections refer to different handlers
+    friend bool operator!=(const connection& lhs, const connection& rhs)
+        { return lhs.m_state != rhs.m_state; }
+
+private:
+    void add_ref()
+    {
+        if ( m_state )
+            m_state->add_ref();
+    }
+
+    detail::connection_state* m_state;
+};
+
+/// @brief Connection that removes handler from the event on destruction
+/// @details Assignment of the new connection removes previous handler.
+/// @ingroup event
+
+class BOOST_UI_DECL scoped_connection : public connection,
+                                        private boost::noncopyable
+{
+public:
+    /// Constructs empty connection
+    scoped_connection() {}
+
+    /// Takes responsibility for the handler of @a c
+    scoped_connection(const connection& c) : connection(c) {}
+
+    /// Removes handler from the event
+    ~scoped_connection() { disconnect(); }
+
+    /// Removes previous handler and takes responsibility for the handler of @a c
+    scoped_connection& operator=(const connection& c)
+    {
+        if ( c != *this )
+        {
+            disconnect();
+            connection::operator=(c);
+        }
+        return *this;
+    }
+
+    /// Releases responsibility for the handler without removing it
+    connection release()
+    {
+        connection result;
+        result.swap(*this);
+        return result;
+    }
+};
+
+} // namespace ui
+} // namespace boost
+
+#endif // BOOST_UI_CONNECTION_HPP
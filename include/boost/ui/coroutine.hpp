@@ -0,0 +1,158 @@
+// Copyright (c) 2018 Kolya Kosenko
+
+// Distributed under the Boost Software License, Version 1.0.
+// See http://www.boost.org/LICENSE_1_0.txt
+
+/// @file coroutine.hpp @brief C++20 coroutines support
+
+#ifndef BOOST_UI_COROUTINE_HPP
+#define BOOST_UI_COROUTINE_HPP
+
+#include <boost/ui/config.hpp>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#if !defined(BOOST_UI_NO_COROUTINES) || defined(DOXYGEN)
+
+#include <boost/ui/thread.hpp>
+#include <boost/ui/thread_pool.hpp>
+
+#include <coroutine>
+#include <exception>
+
+namespace boost {
+namespace ui    {
+
+#ifndef DOXYGEN
+
+namespace detail {
+
+// Resumes suspended coroutine in other thread
+class resume_call
+{
+public:
+    explicit resume_call(std::coroutine_handle<> handle) : m_handle(handle) {}
+
+    void operator()() const { m_handle.resume(); }
+
+private:
+    std::coroutine_handle<> m_handle;
+};
+
+// Rethrows exception of the coroutine in UI thread
+class rethrow_call
+{
+public:
+    explicit rethrow_call(std::exception_ptr exception) : m_exception(exception) {}
+
+    void operator()() const { std::rethrow_exception(m_exception); }
+
+private:
+    std::exception_ptr m_exception;
+};
+
+} // namespace detail
+
+#endif
+
+/// @brief Return type of the coroutine that runs without awaiting
+/// @details Coroutine starts immediately and its frame is destroyed when it finishes.
+/// Exception that leaves the coroutine is rethrown in UI thread.
+/// Usage example:
+/// @code
+/// ui::coroutine import_file(ui::thread_pool& pool, ui::progress_bar& bar)
+/// {
+///     co_await ui::resume_on_pool(pool);
+///     const int size = parse();
+///     co_await ui::resume_on_ui();
+///     bar.value(size);
+/// }
+/// @endcode
+/// @see resume_on_ui, resume_on_pool
+/// @ingroup thread
+
+class coroutine
+{
+public:
+#ifndef DOXYGEN
+    struct promise_type
+    {
+        coroutine get_return_object() noexcept { return coroutine(); }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+
+        void unhandled_exception() const
+        {
+            detail::call_async(detail::rethrow_call(std::current_exception()));
+        }
+    };
+#endif
+};
+
+/// @brief Awaitable that resumes the coroutine in UI thread
+/// @see resume_on_ui
+/// @ingroup thread
+
+class ui_awaiter
+{
+public:
+    /// Coroutine isn't suspended if it is already in UI thread
+    bool await_ready() const { return detail::is_ui_thread(); }
+
+    void await_suspend(std::coroutine_handle<> handle) const
+    {
+        detail::call_async(detail::resume_call(handle));
+    }
+
+    void await_resume() const {}
+};
+
+/// @brief Awaitable that resumes the coroutine in some thread of the pool
+/// @see resume_on_pool
+/// @ingroup thread
+
+class pool_awaiter
+{
+public:
+    explicit pool_awaiter(thread_pool& pool) : m_pool(pool) {}
+
+    bool await_ready() const { return false; }
+
+    void await_suspend(std::coroutine_handle<> handle) const
+    {
+        m_pool.post(detail::resume_call(handle));
+    }
+
+    void await_resume() const {}
+
+private:
+    thread_pool& m_pool;
+};
+
+/// @brief Returns awaitable that continues the coroutine in UI thread.
+/// This function is thread safe.
+/// @details Usage: @code co_await ui::resume_on_ui(); @endcode
+/// @ingroup thread
+inline ui_awaiter resume_on_ui()
+{
+    return ui_awaiter();
+}
+
+/// @brief Returns awaitable that continues the coroutine in the @a pool.
+/// This function is thread safe.
+/// @details Usage: @code co_await ui::resume_on_pool(pool); @endcode
+/// @ingroup thread
+inline pool_awaiter resume_on_pool(thread_pool& pool)
+{
+    return pool_awaiter(pool);
+}
+
+} // namespace ui
+} // namespace boost
+
+#endif // BOOST_UI_NO_COROUTINES
+
+#endif // BOOST_UI_COROUTINE_HPP
@@ -136,7 +136,7 @@ private:
     void ymd(int& year, int& month, int& day) const;
     void set_ymd(int year, int month, int day);
 
-    void on_change_raw(const boost::function<void()>& handler);
+    connection on_change_raw(const boost::function<void()>& handler, bool replace);
 
     class detail_impl;
     detail_impl* get_impl();
@@ -272,7 +272,7 @@ private:
         set_time(static_cast<int>(seconds / 3600), (seconds / 60) % 60, seconds % 60);
     }
 
-    void on_change_raw(const boost::function<void()>& handler);
+    connection on_change_raw(const boost::function<void()>& handler, bool replace);
 
     class detail_impl;
     detail_impl* get_impl();
@@ -3,6 +3,8 @@
 // Distributed under the Boost Software License, Version 1.0.
 // See http://www.boost.org/LICENSE_1_0.txt
 
+#include <boost/ui/connection.hpp>
+
 #ifndef BOOST_NO_CXX11_VARIADIC_TEMPLATES
 #include <boost/move/utility.hpp>
 #else
@@ -14,33 +16,69 @@
 #define BOOST_UI_DETAIL_HANDLER(handler, cls) \
     template <class F, class ...Args> \
     cls& on_##handler(F&& f, Args&&... args) \
-        { on_##handler##_raw(std::bind(boost::forward<F>(f), boost::forward<Args>(args)...)); return *this; } \
+        { on_##handler##_raw(std::bind(boost::forward<F>(f), boost::forward<Args>(args)...), false); return *this; } \
+    template <class F, class ...Args> \
+    ::boost::ui::connection connect_##handler(F&& f, Args&&... args) \
+        { return on_##handler##_raw(std::bind(boost::forward<F>(f), boost::forward<Args>(args)...), false); } \
+    template <class F, class ...Args> \
+    ::boost::ui::connection replace_##handler(F&& f, Args&&... args) \
+        { return on_##handler##_raw(std::bind(boost::forward<F>(f), boost::forward<Args>(args)...), true); } \
 
 #define BOOST_UI_DETAIL_HANDLER_EVENT(handler, cls, event) \
     template <class F, class ...Args> \
     cls& on_##handler(F&& f, Args&&... args) \
-        { on_##handler##_raw(std::bind(boost::forward<F>(f), boost::forward<Args>(args)..., std::placeholders::_1)); return *this; } \
+        { on_##handler##_raw(std::bind(boost::forward<F>(f), boost::forward<Args>(args)..., std::placeholders::_1), false); return *this; } \
+    template <class F, class ...Args> \
+    ::boost::ui::connection connect_##handler(F&& f, Args&&... args) \
+        { return on_##handler##_raw(std::bind(boost::forward<F>(f), boost::forward<Args>(args)..., std::placeholders::_1), false); } \
+    template <class F, class ...Args> \
+    ::boost::ui::connection replace_##handler(F&& f, Args&&... args) \
+        { return on_##handler##_raw(std::bind(boost::forward<F>(f), boost::forward<Args>(args)..., std::placeholders::_1), true); } \
 
 #else // defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES)
 
+#define BOOST_UI_DETAIL_HANDLER_CONNECT(handler, name, replace) \
+    ::boost::ui::connection name(const boost::function<void()>& handler) \
+        { return on_##handler##_raw(handler, replace); } \
+    template <class F, class Arg1> \
+    ::boost::ui::connection name(F f, Arg1 a1) \
+        { return on_##handler##_raw(boost::bind(f, a1), replace); } \
+    template <class F, class Arg1, class Arg2> \
+    ::boost::ui::connection name(F f, Arg1 a1, Arg2 a2) \
+        { return on_##handler##_raw(boost::bind(f, a1, a2), replace); } \
+
+#define BOOST_UI_DETAIL_HANDLER_EVENT_CONNECT(handler, name, event, replace) \
+    ::boost::ui::connection name(const boost::function<void(event&)>& handler) \
+        { return on_##handler##_raw(handler, replace); } \
+    template <class F, class Arg1> \
+    ::boost::ui::connection name(F f, Arg1 a1) \
+        { return on_##handler##_raw(boost::bind(f, a1, _1), replace); } \
+    template <class F, class Arg1, class Arg2> \
+    ::boost::ui::connection name(F f, Arg1 a1, Arg2 a2) \
+        { return on_##handler##_raw(boost::bind(f, a1, a2, _1), replace); } \
+
 #define BOOST_UI_DETAIL_HANDLER(handler, cls) \
     cls& on_##handler(const boost::function<void()>& handler) \
-        { on_##handler##_raw(handler); return *this; } \
+        { on_##handler##_raw(handler, false); return *this; } \
     template <class F, class Arg1> \
     cls& on_##handler(F f, Arg1 a1) \
-        { on_##handler##_raw(boost::bind(f, a1)); return *this; } \
+        { on_##handler##_raw(boost::bind(f, a1), false); return *this; } \
     template <class F, class Arg1, class Arg2> \
     cls& on_##handler(F f, Arg1 a1, Arg2 a2) \
-        { on_##handler##_raw(boost::bind(f, a1, a2)); return *this; } \
+        { on_##handler##_raw(boost::bind(f, a1, a2), false); return *this; } \
+    BOOST_UI_DETAIL_HANDLER_CONNECT(handler, connect_##handler, false) \
+    BOOST_UI_DETAIL_HANDLER_CONNECT(handler, replace_##handler, true) \
 
 #define BOOST_UI_DETAIL_HANDLER_EVENT(handler, cls, event) \
     cls& on_##handler(const boost::function<void(event&)>& handler) \
-        { on_##handler##_raw(handler); return *this; } \
+        { on_##handler##_raw(handler, false); return *this; } \
     template <class F, class Arg1> \
     cls& on_##handler(F f, Arg1 a1) \
-        { on_##handler##_raw(boost::bind(f, a1, _1)); return *this; } \
+        { on_##handler##_raw(boost::bind(f, a1, _1), false); return *this; } \
     template <class F, class Arg1, class Arg2> \
     cls& on_##handler(F f, Arg1 a1, Arg2 a2) \
-        { on_##handler##_raw(boost::bind(f, a1, a2, _1)); return *this; } \
+        { on_##handler##_raw(boost::bind(f, a1, a2, _1), false); return *this; } \
+    BOOST_UI_DETAIL_HANDLER_EVENT_CONNECT(handler, connect_##handler, event, false) \
+    BOOST_UI_DETAIL_HANDLER_EVENT_CONNECT(handler, replace_##handler, event, true) \
 
 #endif
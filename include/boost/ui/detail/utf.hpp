@@ -0,0 +1,56 @@
+// Copyright (c) 2017 Kolya Kosenko
+
+// Distributed under the Boost Software License, Version 1.0.
+// See http://www.boost.org/LICENSE_1_0.txt
+
+#ifndef BOOST_UI_DETAIL_UTF_HPP
+#define BOOST_UI_DETAIL_UTF_HPP
+
+#include <boost/ui/config.hpp>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <string>
+#include <cstddef>
+
+namespace boost  {
+namespace ui     {
+namespace detail {
+namespace utf    {
+
+// Unicode transcoders with vectorized ASCII fast path.
+// wchar_t strings are UTF-16 or UTF-32 encoded depending on wchar_t size.
+// Converted string is appended to the result, invalid code unit sequences
+// are replaced with U+FFFD and false is returned in this case.
+
+// Returns length of the leading 7-bit ASCII part of the string
+BOOST_UI_DECL std::size_t ascii_prefix(const char* str, std::size_t size) BOOST_NOEXCEPT;
+
+// Checks whether the string is valid UTF-8
+BOOST_UI_DECL bool valid(const char* str, std::size_t size) BOOST_NOEXCEPT;
+
+BOOST_UI_DECL bool transcode(const char* str, std::size_t size, std::wstring& result);
+BOOST_UI_DECL bool transcode(const wchar_t* str, std::size_t size, std::string& result);
+
+#ifndef BOOST_NO_CXX11_CHAR16_T
+BOOST_UI_DECL bool transcode(const char* str, std::size_t size, std::u16string& result);
+BOOST_UI_DECL bool transcode(const char16_t* str, std::size_t size, std::string& result);
+BOOST_UI_DECL bool transcode(const wchar_t* str, std::size_t size, std::u16string& result);
+BOOST_UI_DECL bool transcode(const char16_t* str, std::size_t size, std::wstring& result);
+#endif
+
+#ifndef BOOST_NO_CXX11_CHAR32_T
+BOOST_UI_DECL bool transcode(const char* str, std::size_t size, std::u32string& result);
+BOOST_UI_DECL bool transcode(const char32_t* str, std::size_t size, std::string& result);
+BOOST_UI_DECL bool transcode(const wchar_t* str, std::size_t size, std::u32string& result);
+BOOST_UI_DECL bool transcode(const char32_t* str, std::size_t size, std::wstring& result);
+#endif
+
+} // namespace utf
+} // namespace detail
+} // namespace ui
+} // namespace boost
+
+#endif // BOOST_UI_DETAIL_UTF_HPP
@@ -20,7 +20,8 @@ public:
         m_enabled(true),
         m_shown(true), m_shown_modified(false), // TODO: Support wxTLWs
         m_window_style_flags_add(0),
-        m_window_style_flags_remove(0)
+        m_window_style_flags_remove(0),
+        m_coalesce_events(false)
     {}
     virtual ~widget_detail_base() {}
 
@@ -39,6 +40,9 @@ public:
     void modify_style_flags(long add, long remove = 0);
     long style_flags(long default_flags = 0);
 
+    void coalesce_events(bool enable) { m_coalesce_events = enable; }
+    bool coalesce_events() const { return m_coalesce_events; }
+
     typedef void* native_handle_type;
     virtual native_handle_type native_handle() = 0;
     virtual const native_handle_type native_handle() const = 0;
@@ -54,6 +58,7 @@ private:
     bool m_enabled, m_shown, m_shown_modified;
     long m_window_style_flags_add;
     long m_window_style_flags_remove;
+    bool m_coalesce_events;
 };
 
 class window_detail_base : public widget_detail_base
@@ -18,6 +18,8 @@
 
 #include <boost/function.hpp>
 
+#include <vector>
+
 namespace boost  {
 namespace ui     {
 
@@ -25,7 +27,10 @@ namespace ui     {
 namespace native {
 
 template <class NativeEvent, class UIEvent>
-class event_functor_event;
+void init_event(UIEvent& uievent, NativeEvent& wxevent);
+
+template <class NativeEvent, class UIEvent, class Filter>
+class coalesced_functor_event;
 
 } // namespace native
 #endif
@@ -68,7 +73,7 @@ private:
 
 #ifndef DOXYGEN
     template <class NativeEvent, class UIEvent>
-    friend class native::event_functor_event;
+    friend void native::init_event(UIEvent& uievent, NativeEvent& wxevent);
 #endif
 };
 
@@ -100,7 +105,7 @@ private:
 
 #ifndef DOXYGEN
     template <class NativeEvent, class UIEvent>
-    friend class native::event_functor_event;
+    friend void native::init_event(UIEvent& uievent, NativeEvent& wxevent);
 #endif
 };
 
@@ -132,7 +137,7 @@ private:
 
 #ifndef DOXYGEN
     template <class NativeEvent, class UIEvent>
-    friend class native::event_functor_event;
+    friend void native::init_event(UIEvent& uievent, NativeEvent& wxevent);
 #endif
 };
 
@@ -161,16 +166,29 @@ public:
     bool middle() const { return m_middle; }
     ///@}
 
+    /// @brief Returns positions of the previous events merged into this event
+    /// @details Positions are ordered from the oldest one, pos() isn't included.
+    /// Vector is empty if events aren't coalesced, see widget::coalesce_events().
+    const std::vector<point>& history() const { return m_history; }
+
 private:
+    void coalesce(const mouse_event& next);
+
     coord_type m_x;
     coord_type m_y;
     bool m_left;
     bool m_right;
     bool m_middle;
+    std::vector<point> m_history;
 
 #ifndef DOXYGEN
     template <class NativeEvent, class UIEvent>
-    friend class native::event_functor_event;
+    friend void native::init_event(UIEvent& uievent, NativeEvent& wxevent);
+
+    template <class NativeEvent, class UIEvent, class Filter>
+    friend class native::coalesced_functor_event;
+
+    friend class wheel_event;
 #endif
 };
 
@@ -180,7 +198,7 @@ private:
 class wheel_event : public mouse_event
 {
 public:
-    wheel_event() : m_horizontal(false), m_delta(0) {}
+    wheel_event() : m_horizontal(false), m_delta_x(0), m_delta_y(0) {}
 
     /// Returns true only if wheel move is horizontal
     bool horizontal() const { return m_horizontal; }
@@ -188,19 +206,27 @@ public:
     /// Returns true only if wheel move is vertical
     bool vertical() const { return !m_horizontal; }
 
-    /// Returns wheel horizontal move delta
-    coord_type delta_x() const { return horizontal() ? m_delta : 0; }
+    /// @brief Returns wheel horizontal move delta
+    /// @details Deltas of coalesced events are summed.
+    coord_type delta_x() const { return m_delta_x; }
 
-    /// Returns wheel vertical move delta
-    coord_type delta_y() const { return vertical() ? m_delta : 0; }
+    /// @brief Returns wheel vertical move delta
+    /// @details Deltas of coalesced events are summed.
+    coord_type delta_y() const { return m_delta_y; }
 
 private:
+    void coalesce(const wheel_event& next);
+
     bool m_horizontal;
-    coord_type m_delta;
+    coord_type m_delta_x;
+    coord_type m_delta_y;
 
 #ifndef DOXYGEN
     template <class NativeEvent, class UIEvent>
-    friend class native::event_functor_event;
+    friend void native::init_event(UIEvent& uievent, NativeEvent& wxevent);
+
+    template <class NativeEvent, class UIEvent, class Filter>
+    friend class native::coalesced_functor_event;
 #endif
 };
 
@@ -0,0 +1,126 @@
+// Copyright (c) 2018 Kolya Kosenko
+
+// Distributed under the Boost Software License, Version 1.0.
+// See http://www.boost.org/LICENSE_1_0.txt
+
+/// @file event_trace.hpp @brief Event handler latency tracing
+
+#ifndef BOOST_UI_EVENT_TRACE_HPP
+#define BOOST_UI_EVENT_TRACE_HPP
+
+#include <boost/ui/config.hpp>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <boost/ui/string.hpp>
+
+#include <boost/cstdint.hpp>
+#include <boost/core/noncopyable.hpp>
+
+#include <cstddef>
+#include <iosfwd>
+#include <typeinfo>
+#include <vector>
+
+namespace boost {
+namespace ui    {
+
+/// @brief Latency statistics of the event handlers of one event of one widget
+/// @see event_trace
+/// @ingroup event
+struct handler_stats
+{
+    /// Count of the histogram buckets
+    BOOST_STATIC_CONSTANT(std::size_t, buckets = 16);
+
+    uistring event;            ///< Event name, e.g. "mouse_move"
+    uistring widget;           ///< Native class name and label of the widget
+    uistring handler;          ///< Type of the handler of the slowest call
+    std::size_t count;         ///< Count of the handler calls
+    boost::int64_t total;      ///< Total duration in microseconds
+    boost::int64_t max;        ///< Maximal duration in microseconds
+    std::size_t slow;          ///< Count of calls that exceeded event_trace::budget()
+
+    /// Call counts by duration, see event_trace::bucket_limit()
+    std::size_t histogram[buckets];
+};
+
+/// @brief Timing of the event handlers
+/// @details Handler calls are timed only while tracing is enabled.
+/// Statistics are collected by the event and the widget.
+/// Handlers that exceed the budget are logged as warnings with the widget,
+/// the event and the handler type.
+/// Functions should be called from the UI thread only.
+/// @ingroup event
+
+class BOOST_UI_DECL event_trace : private boost::noncopyable
+{
+public:
+    /// Starts or stops timing of the event handlers
+    static void enable(bool enabled = true);
+
+    /// Returns true if the event handlers are timed
+    static bool enabled() { return s_enabled; }
+
+    /// @brief Sets maximal duration of the handler call in milliseconds
+    /// @details Zero disables reporting. Default value is 16 milliseconds.
+    static void budget(unsigned milliseconds);
+
+    /// Returns maximal duration of the handler call in milliseconds
+    static unsigned budget();
+
+    /// @brief Sets count of the last handler calls kept for write_chrome_trace()
+    /// @details Default value is 10000, zero disables recording of calls.
+    static void trace_capacity(std::size_t count);
+
+    /// @brief Returns statistics of all timed handlers
+    /// @details Statistics of destroyed widgets are kept,
+    /// the ones with the same widget name and event are merged.
+    static std::vector<handler_stats> snapshot();
+
+    /// Removes collected statistics and recorded calls
+    static void reset();
+
+    /// @brief Writes recorded calls in Chrome trace event JSON format
+    /// @details Output could be opened in chrome://tracing or Perfetto UI.
+    static void write_chrome_trace(std::ostream& os);
+
+    /// @brief Returns upper duration limit of the histogram bucket in microseconds
+    /// @details Limits are doubled from 64 microseconds.
+    /// Returns -1 for the last bucket that has no limit.
+    static boost::int64_t bucket_limit(std::size_t index);
+
+private:
+    event_trace();
+
+    static bool s_enabled;
+};
+
+#ifndef DOXYGEN
+
+namespace detail {
+
+// Times handler call of the native event source
+class BOOST_UI_DECL handler_timer : private boost::noncopyable
+{
+public:
+    handler_timer(void* source, int event_type, const std::type_info& handler);
+    ~handler_timer();
+
+private:
+    void* m_source;
+    int m_event_type;
+    const std::type_info& m_handler;
+    boost::int64_t m_start;
+};
+
+} // namespace detail
+
+#endif
+
+} // namespace ui
+} // namespace boost
+
+#endif // BOOST_UI_EVENT_TRACE_HPP
@@ -8,6 +8,10 @@
 #ifndef BOOST_UI_IMAGE_HPP
 #define BOOST_UI_IMAGE_HPP
 
+#ifdef DOXYGEN
+#define BOOST_UI_USE_FILESYSTEM
+#endif
+
 #include <boost/ui/config.hpp>
 
 #ifdef BOOST_HAS_PRAGMA_ONCE
@@ -15,12 +19,23 @@
 #endif
 
 #include <boost/ui/coord.hpp>
+#include <boost/ui/string.hpp>
+
+#include <boost/core/scoped_enum.hpp>
+#include <boost/function.hpp>
 
 #include <istream>
+#include <ostream>
+
+#ifdef BOOST_UI_USE_FILESYSTEM
+#include <boost/filesystem.hpp>
+#endif
 
 namespace boost {
 namespace ui    {
 
+class image_info;
+
 /// @brief Image class
 /// @see <a href="https://en.wikipedia.org/wiki/Digital_image">Digital image (Wikipedia)</a>
 /// @ingroup graphics
@@ -30,6 +45,18 @@ class BOOST_UI_DECL image
     class impl;
 
 public:
+    /// @brief Enumeration of image file formats
+    /// @see <a href="https://en.wikipedia.org/wiki/Image_file_formats">Image file formats (Wikipedia)</a>
+    BOOST_SCOPED_ENUM_DECLARE_BEGIN(format)
+    {
+        png,  ///< Portable Network Graphics
+        jpeg, ///< JPEG File Interchange Format
+        bmp,  ///< Windows and OS/2 bitmap
+        gif,  ///< Graphics Interchange Format
+        ico   ///< Windows icon and cursor
+    }
+    BOOST_SCOPED_ENUM_DECLARE_END(format)
+
     image();
 #ifndef DOXYGEN
     image(const image& other);
@@ -42,6 +69,37 @@ public:
     /// @see <a href="https://en.wikipedia.org/wiki/Image_file_formats">Image file formats (Wikipedia)</a>
     image& load(std::istream& s);
 
+    /// @brief Saves image into the stream
+    /// @param s Output stream
+    /// @param f Image file format
+    /// @param compression Compression level from 0 (fastest, best quality)
+    /// to 100 (smallest size), or -1 to use format default.
+    /// It is ignored for uncompressed formats
+    /// @throw std::runtime_error On invalid image or image save failure
+    const image& save(std::ostream& s, format f, int compression = -1) const;
+
+    /// @brief Saves image into the stream in the worker thread
+    /// @details Image pixels are copied in the calling (UI) thread,
+    /// then they are encoded and written in the worker thread,
+    /// and then @a handler is called in the UI thread with true on success.
+    /// Stream should be alive until @a handler call.
+    /// @throw std::runtime_error On invalid image or worker thread start failure
+    /// @see save()
+    void save_async(std::ostream& s, format f, int compression,
+                    const boost::function<void(bool)>& handler) const;
+
+    ///@{ @brief Reads image format, size, bit depth and frames count
+    /// from the image file headers without image pixels decoding
+    /// @details Returns invalid @ref image_info if image format isn't recognized
+    /// @throw std::runtime_error If file can't be opened
+    /// @see BOOST_UI_USE_FILESYSTEM
+    static image_info probe(std::istream& s);
+    static image_info probe(const uistring& filename);
+#ifdef BOOST_UI_USE_FILESYSTEM
+    static image_info probe(const boost::filesystem::path& filename);
+#endif
+    ///@}
+
     /// @brief Returns standard freedesktop.org (XDG) icon by name
     /// @see <a href="https://specifications.freedesktop.org/icon-naming-spec/icon-naming-spec-latest.html#names">
     /// freedesktop.org Icon Naming Specification</a>
@@ -75,6 +133,58 @@ private:
     impl* m_impl;
 };
 
+/// @brief Image properties that are stored in image file headers
+/// @see image::probe()
+/// @ingroup graphics
+
+class image_info
+{
+public:
+    image_info() : m_valid(false), m_format(image::format::png),
+        m_width(0), m_height(0), m_bits_per_pixel(0), m_frames(0) {}
+
+    /// Returns true only if image format was recognized
+    bool valid() const { return m_valid; }
+
+    /// Returns image file format
+    image::format get_format() const { return m_format; }
+
+    /// Returns image width
+    coord_type width() const { return m_width; }
+
+    /// Returns image height
+    coord_type height() const { return m_height; }
+
+    /// Returns image size
+    size dimensions() const
+        { return size(width(), height()); }
+
+    /// Returns count of bits per pixel or 0 if it is unknown
+    int bits_per_pixel() const { return m_bits_per_pixel; }
+
+    /// Returns count of images (animation frames or icon sizes) in the file
+    std::size_t frames() const { return m_frames; }
+
+private:
+    bool m_valid;
+    image::format m_format;
+    coord_type m_width;
+    coord_type m_height;
+    int m_bits_per_pixel;
+    std::size_t m_frames;
+
+#ifndef DOXYGEN
+    friend class native_helper;
+#endif
+};
+
+#ifdef BOOST_UI_USE_FILESYSTEM
+inline image_info image::probe(const boost::filesystem::path& filename)
+{
+    return probe(uistring(filename.wstring()));
+}
+#endif
+
 } // namespace ui
 } // namespace boost
 
@@ -0,0 +1,110 @@
+// Copyright (c) 2018 Kolya Kosenko
+
+// Distributed under the Boost Software License, Version 1.0.
+// See http://www.boost.org/LICENSE_1_0.txt
+
+/// @file input_record.hpp @brief Input events recording and replay
+
+#ifndef BOOST_UI_INPUT_RECORD_HPP
+#define BOOST_UI_INPUT_RECORD_HPP
+
+#include <boost/ui/config.hpp>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <boost/ui/string.hpp>
+
+#include <boost/core/noncopyable.hpp>
+#include <boost/function.hpp>
+
+#include <cstddef>
+
+namespace boost {
+namespace ui    {
+
+class widget;
+
+/// @brief Records mouse, wheel and keyboard events delivered to the widget
+/// and its children
+/// @details Events are recorded with their timestamps and the path
+/// of the target widget in the widget tree.
+/// Recorded events could be replayed by input_player.
+/// Should be used from the UI thread only.
+/// @see input_player
+/// @ingroup event
+
+class BOOST_UI_DECL input_recorder : private boost::noncopyable
+{
+public:
+    /// Starts recording of the events of @a root widget and its children
+    explicit input_recorder(widget& root);
+
+    /// Stops recording
+    ~input_recorder();
+
+    /// Stops recording, recorded events are kept
+    void stop();
+
+    /// Returns true if events are recorded
+    bool is_recording() const;
+
+    /// Returns count of the recorded events
+    std::size_t size() const;
+
+    /// @brief Writes recorded events into the binary file
+    /// @throw std::runtime_error if the file can't be written
+    void save(const uistring& path) const;
+
+private:
+    class native_impl;
+    native_impl* m_impl;
+};
+
+/// @brief Replays events recorded by input_recorder
+/// @details Events are sent to the Boost.UI event handlers of the widgets
+/// that are found by their paths in the widget tree of the same structure.
+/// Event loop runs between replayed events, so the widgets are repainted.
+/// Native widgets don't receive replayed events as an user input.
+/// Should be used from the UI thread only.
+/// @see input_recorder
+/// @ingroup event
+
+class BOOST_UI_DECL input_player : private boost::noncopyable
+{
+public:
+    /// @brief Loads events from the file written by input_recorder::save()
+    /// @throw std::runtime_error if the file can't be read or has wrong format
+    explicit input_player(const uistring& path);
+
+    /// Stops replay
+    ~input_player();
+
+    /// Returns count of the loaded events
+    std::size_t size() const;
+
+    /// @brief Starts replay of the events to @a root widget and its children
+    /// @param root Widget that was passed to input_recorder
+    /// @param speed Pace relative to the recording,
+    ///        zero replays events without delays
+    void play(widget& root, double speed = 1.0);
+
+    /// Stops replay
+    void stop();
+
+    /// Returns true if events are replayed
+    bool is_playing() const;
+
+    /// Sets handler that is called after the last event is replayed
+    input_player& on_finish(const boost::function<void()>& handler);
+
+private:
+    class native_impl;
+    native_impl* m_impl;
+};
+
+} // namespace ui
+} // namespace boost
+
+#endif // BOOST_UI_INPUT_RECORD_HPP
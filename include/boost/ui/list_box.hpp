@@ -91,11 +91,11 @@ public:
     ///@}
 
 private:
-    void on_select_raw(const boost::function<void()>& handler);
-    void on_select_event_raw(const boost::function<void(index_event&)>& handler);
+    connection on_select_raw(const boost::function<void()>& handler, bool replace);
+    connection on_select_event_raw(const boost::function<void(index_event&)>& handler, bool replace);
 
-    void on_activate_raw(const boost::function<void()>& handler);
-    void on_activate_event_raw(const boost::function<void(index_event&)>& handler);
+    connection on_activate_raw(const boost::function<void()>& handler, bool replace);
+    connection on_activate_event_raw(const boost::function<void(index_event&)>& handler, bool replace);
 
     class detail_impl;
     detail_impl* get_impl();
@@ -15,6 +15,10 @@
 #endif
 
 #include <locale>
+#include <string>
+#include <vector>
+
+#include <boost/ui/string.hpp>
 
 namespace boost {
 namespace ui    {
@@ -28,6 +32,53 @@ BOOST_UI_DECL std::locale getloc();
 // @ingroup locale
 //std::locale imbue(const std::locale& loc);
 
+/// @brief Compares strings according to the locale collation rules
+/// @details Sort keys are compared with std::string comparison
+/// in the same order as strings are collated, so the locale is used
+/// only once per string instead of once per comparison.
+/// This class is thread safe.
+/// @see <a href="http://en.wikipedia.org/wiki/Collation">Collation (Wikipedia)</a>
+/// @ingroup locale
+
+class BOOST_UI_DECL collator
+{
+public:
+    /// Creates collator for the current user interface locale, see getloc()
+    collator();
+
+    /// Creates collator for the specified locale
+    explicit collator(const std::locale& loc);
+
+    /// Returns the locale of this collator
+    const std::locale& getloc() const { return m_locale; }
+
+    /// @brief Returns binary sort key of the string
+    /// @details Keys of different strings are ordered by
+    /// std::string::compare() as strings are collated.
+    std::string sort_key(const uistring& str) const;
+
+    /// Returns negative value, zero or positive value if @a lhs is
+    /// collated before, same or after @a rhs
+    int compare(const uistring& lhs, const uistring& rhs) const;
+
+    /// Checks whether @a lhs is collated before @a rhs
+    bool operator()(const uistring& lhs, const uistring& rhs) const
+        { return compare(lhs, rhs) < 0; }
+
+    /// Sorts strings using precomputed sort keys
+    void sort(std::vector<uistring>& strings) const;
+
+    /// @brief Sorts strings using precomputed sort keys in several threads
+    /// @details If @a threads is zero, the count of hardware threads is used.
+    /// Strings are sorted in the calling thread
+    /// if threads aren't supported.
+    void parallel_sort(std::vector<uistring>& strings, unsigned threads = 0) const;
+
+private:
+    std::locale m_locale;
+    const std::collate<wchar_t>* m_collate;
+};
+
 } // namespace ui
 } // namespace boost
 
@@ -16,11 +16,82 @@
 
 #include <boost/ui/string.hpp>
 
-#include <sstream> // for std::ostringstream
+#include <boost/core/scoped_enum.hpp>
+#include <boost/core/noncopyable.hpp>
+#include <boost/current_function.hpp>
+
+#include <cstring>
+#include <cwchar>
+#include <ostream>
+#include <sstream>
+
+#ifdef DOXYGEN
+
+/// @brief Log messages less severe than this level are removed at compile time
+/// @details Value is one of BOOST_UI_LOG_LEVEL_* macros,
+/// BOOST_UI_LOG_LEVEL_TRACE by default.
+/// @ingroup log
+#define BOOST_UI_LOG_MIN_LEVEL
+
+#endif // DOXYGEN
+
+#ifndef DOXYGEN
+#define BOOST_UI_LOG_LEVEL_FATAL   0
+#define BOOST_UI_LOG_LEVEL_ERROR   1
+#define BOOST_UI_LOG_LEVEL_WARNING 2
+#define BOOST_UI_LOG_LEVEL_INFO    3
+#define BOOST_UI_LOG_LEVEL_VERBOSE 4
+#define BOOST_UI_LOG_LEVEL_DEBUG   5
+#define BOOST_UI_LOG_LEVEL_TRACE   6
+#endif
+
+#ifndef BOOST_UI_LOG_MIN_LEVEL
+#define BOOST_UI_LOG_MIN_LEVEL BOOST_UI_LOG_LEVEL_TRACE
+#endif
 
 namespace boost {
 namespace ui    {
 
+/// @brief Severity of log messages
+/// @ingroup log
+BOOST_SCOPED_ENUM_DECLARE_BEGIN(log_level)
+{
+    fatal,   ///< See log::fatal
+    error,   ///< See log::error
+    warning, ///< See log::warning
+    info,    ///< See log::info
+    verbose, ///< See log::verbose
+    debug,   ///< See log::debug
+    trace    ///< See log::trace
+}
+BOOST_SCOPED_ENUM_DECLARE_END(log_level)
+
+#ifndef DOXYGEN
+
+namespace detail {
+
+// Formats value using the stream that is reused by the current thread
+class BOOST_UI_DECL log_formatter : private boost::noncopyable
+{
+public:
+    log_formatter();
+    ~log_formatter();
+
+    std::ostream& stream();
+    const char* data() const;
+    std::size_t size() const;
+
+    class buffer;
+
+private:
+    buffer* m_buffer;
+    bool m_owned;
+};
+
+} // namespace detail
+
+#endif
+
 /// @brief Logging stream class with output into provided @ref uistring
 /// @ingroup log
 
@@ -47,23 +118,27 @@ public:
 #ifndef BOOST_UI_NO_CAST_FROM_ASCII
     log_string& operator<<(char value);
     log_string& operator<<(const char* value)
-        { return operator<<(std::string(value)); }
-    log_string& operator<<(const std::string& value);
+        { return append_string(value, std::strlen(value)); }
+    log_string& operator<<(const std::string& value)
+        { return append_string(value.data(), value.size()); }
 #endif
     log_string& operator<<(wchar_t value);
     log_string& operator<<(const wchar_t* value)
-        { return operator<<(std::wstring(value)); }
-    log_string& operator<<(const std::wstring& value);
+        { return append_string(value, std::wcslen(value)); }
+    log_string& operator<<(const std::wstring& value)
+        { return append_string(value.data(), value.size()); }
     log_string& operator<<(const uistring& value);
 
 #ifndef BOOST_UI_NO_CAST_FROM_ASCII
     template <class T>
     log_string& operator<<(const T& value)
     {
-        std::ostringstream ss;
-        ss << std::boolalpha << value;
-        raw(ss.str());
-        return *this;
+        if ( !m_enabled )
+            return *this;
+
+        detail::log_formatter formatter;
+        formatter.stream() << value;
+        return append_raw(formatter.data(), formatter.size());
     }
 #endif
     ///@}
@@ -71,12 +146,25 @@ public:
     /// Logs string without quotes
     log_string& raw(const uistring& value);
 
+protected:
+#ifndef DOXYGEN
+    log_string(uistring& str, bool enabled);
+    bool is_enabled() const { return m_enabled; }
+    void disable() { m_enabled = false; }
+#endif
+
 private:
     void append_space();
+#ifndef BOOST_UI_NO_CAST_FROM_ASCII
+    log_string& append_string(const char* str, std::size_t size);
+    log_string& append_raw(const char* str, std::size_t size);
+#endif
+    log_string& append_string(const wchar_t* str, std::size_t size);
 
     uistring& m_string;
     bool m_spaces;
     bool m_quotes;
+    bool m_enabled;
 };
 
 /// @brief Logging stream class
@@ -85,9 +173,52 @@ private:
 class BOOST_UI_DECL log : public log_string
 {
 public:
-    log() : log_string(m_string), m_level(debug_level) {}
+    log() : log_string(m_string, level_enabled(debug_level)), m_level(debug_level),
+            m_file(NULL), m_line(-1), m_function(NULL)
+        { acquire_buffer(); }
     ~log();
 
+    /// @brief Sets the least severe level of logged messages
+    /// @details Less severe messages are neither formatted nor logged.
+    /// This function is thread safe.
+    static void min_level(log_level level);
+
+    /// Returns the least severe level of logged messages
+    static log_level min_level();
+
+    /// Checks whether messages of the @a level are logged
+    static bool enabled(log_level level);
+
+    /// @brief Logs caller location in the source code
+    /// @details Messages with known location are throttled,
+    /// see repeat_window() and rate_limit().
+    log& location(const char* file, int line = -1, const char* fn = NULL);
+
+    /// @brief Suppresses repeated messages from the same source code location
+    /// @details Message is suppressed if the previous message from its location
+    /// has the same text and was logged less than @a milliseconds ago.
+    /// Count of suppressed messages is logged before the next message
+    /// from the location, or by the next throttled message from any location
+    /// after the window is over. Zero value disables suppression
+    /// and logs pending counts. Fatal errors are never suppressed.
+    /// This function is thread safe.
+    static void repeat_window(unsigned milliseconds);
+
+    /// @brief Limits rate of messages from every source code location
+    /// @details Every location logs up to @a burst messages at once and then
+    /// up to @a rate messages per second. Messages over the limit
+    /// are neither formatted nor logged, their count is logged before the next
+    /// message from the location, or by the next throttled message
+    /// from any location when the location could log again.
+    /// Zero @a rate disables the limit and logs pending counts.
+    /// Fatal errors are never suppressed. This function is thread safe.
+    static void rate_limit(unsigned rate, unsigned burst = 1);
+
+    /// @brief Logs pending counts of suppressed messages
+    /// @details Called when the application exits and when the installed
+    /// async_log is destroyed. This function is thread safe.
+    static void flush_suppressed();
+
     class fatal;
     class error;
     class warning;
@@ -104,14 +235,26 @@ protected:
         verbose_level, debug_level, trace_level
     };
 
-    log(level_values level) : log_string(m_string), m_level(level) {}
+    log(level_values level) : log_string(m_string, level_enabled(level)), m_level(level),
+            m_file(NULL), m_line(-1), m_function(NULL)
+        { acquire_buffer(); }
 #endif
 
 private:
     void flush();
+    void acquire_buffer();
+    static bool level_enabled(level_values level);
+    static void write(level_values level, uistring& message, bool movable);
+    static void write_summary(level_values level, const char* file, int line,
+                              const char* fn, unsigned long suppressed);
+    static void write_suppressed(bool all);
 
     uistring m_string;
     level_values m_level;
+    bool m_pooled;
+    const char* m_file;
+    int m_line;
+    const char* m_function;
 };
 
 /// @brief Logs current file, line and function
@@ -119,6 +262,43 @@ private:
 /// @ingroup log
 #define BOOST_UI_LOG ::boost::ui::log().location(__FILE__, __LINE__, BOOST_CURRENT_FUNCTION)
 
+#ifndef DOXYGEN
+
+namespace detail {
+
+// Turns log expression into void expression
+struct log_voidify
+{
+    void operator&(log_string&) {}
+};
+
+} // namespace detail
+
+#define BOOST_UI_DETAIL_LOG(level, LEVEL) \
+    !( BOOST_UI_LOG_LEVEL_##LEVEL <= BOOST_UI_LOG_MIN_LEVEL && \
+       ::boost::ui::log::enabled(::boost::ui::log_level::level) ) ? (void)0 : \
+    ::boost::ui::detail::log_voidify() & \
+    ::boost::ui::log::level().location(__FILE__, __LINE__, BOOST_CURRENT_FUNCTION)
+
+#endif
+
+///@{
+/// @brief Logs current file, line and function with the specified level
+/// @details Logged values aren't evaluated if the level is disabled
+/// at runtime using log::min_level() or at compile time
+/// using BOOST_UI_LOG_MIN_LEVEL. Usage example:
+/// @code BOOST_UI_LOG_DEBUG << "value" << compute(); @endcode
+/// @relates boost::ui::log
+/// @ingroup log
+#define BOOST_UI_LOG_FATAL   BOOST_UI_DETAIL_LOG(fatal, FATAL)
+#define BOOST_UI_LOG_ERROR   BOOST_UI_DETAIL_LOG(error, ERROR)
+#define BOOST_UI_LOG_WARNING BOOST_UI_DETAIL_LOG(warning, WARNING)
+#define BOOST_UI_LOG_INFO    BOOST_UI_DETAIL_LOG(info, INFO)
+#define BOOST_UI_LOG_VERBOSE BOOST_UI_DETAIL_LOG(verbose, VERBOSE)
+#define BOOST_UI_LOG_DEBUG   BOOST_UI_DETAIL_LOG(debug, DEBUG)
+#define BOOST_UI_LOG_TRACE   BOOST_UI_DETAIL_LOG(trace, TRACE)
+///@}
+
 /// @brief Shows error and abort immediately
 /// @ingroup log
 class log::fatal : public log
@@ -152,7 +152,7 @@ public:
     ///@}
 
 private:
-    void on_press_raw(const boost::function<void()>& handler);
+    connection on_press_raw(const boost::function<void()>& handler, bool replace);
 
     class native_impl;
     native_impl* m_impl;
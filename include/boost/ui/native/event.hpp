@@ -8,9 +8,14 @@
 
 #include <boost/ui/native/config.hpp>
 #include <boost/ui/native/widget.hpp>
+#include <boost/ui/connection.hpp>
+#include <boost/ui/event_trace.hpp>
 
 #include <wx/window.h>
 
+#include <algorithm> // std::swap
+#include <typeinfo>
+
 namespace boost  {
 namespace ui     {
 namespace native {
@@ -22,12 +27,17 @@ public:
     bool operator()(NativeEvent& wxevent) { return true; }
 };
 
-template <class NativeEvent>
+// Initializes UI event from the native one, specialized for every pair of events
+template <class NativeEvent, class UIEvent>
+void init_event(UIEvent& uievent, NativeEvent& wxevent);
+
+// Filter type is known at compile time and is stored by value,
+// so events are dispatched without type erasure of the filter
+template <class NativeEvent, class Filter>
 class event_functor
 {
 public:
-    event_functor(const boost::function<void()>& handler,
-                  const boost::function<bool(NativeEvent&)>& filter)
+    event_functor(const boost::function<void()>& handler, const Filter& filter)
         : m_handler(handler), m_filter(filter)
     {}
 
@@ -41,31 +51,388 @@ public:
         m_handler();
     }
 
+    const std::type_info& handler_type() const { return m_handler.target_type(); }
+
 private:
     const boost::function<void()> m_handler;
-    const boost::function<bool(NativeEvent&)> m_filter;
+    Filter m_filter;
 };
 
+// Calls deliver() of the coalescing functor if its connection is alive
+template <class Functor>
+class deliver_call
+{
+public:
+    deliver_call(Functor* functor, detail::connection_state* c)
+        : m_functor(functor), m_connection(c) {}
+
+    void operator()()
+    {
+        if ( m_connection.connected() )
+            m_functor->deliver_pending();
+    }
 
-template <class EventTag>
-void bind_helper(widget& w, EventTag eventType,
-                 const boost::function<void()>& handler,
-                 const boost::function<bool(typename EventTag::EventClass&)>& filter
-                     = empty_filter<typename EventTag::EventClass>())
+private:
+    Functor* m_functor;
+    connection m_connection;
+};
+
+// Base class of functors that deliver pending event
+// at most once per event loop iteration
+template <class Derived>
+class coalesced_functor_base
+{
+public:
+    coalesced_functor_base()
+        : m_source(NULL), m_event_type(0), m_connection(NULL), m_pending(false) {}
+
+    void attach(wxEvtHandler* source, int event_type, detail::connection_state* c)
+    {
+        m_source = source;
+        m_event_type = event_type;
+        m_connection = c;
+    }
+
+    void deliver_pending()
+    {
+        // Pending event could be delivered before other event of the source
+        if ( !m_pending )
+            return;
+
+        if ( m_connection )
+            m_connection->remove_pending();
+
+        Derived* derived = static_cast<Derived*>(this);
+
+        if ( event_trace::enabled() )
+        {
+            const detail::handler_timer timer(m_source, m_event_type,
+                                              derived->handler_type());
+            derived->deliver();
+        }
+        else
+            derived->deliver();
+    }
+
+protected:
+    bool pending() const { return m_pending; }
+
+    void schedule()
+    {
+        m_pending = true;
+
+#ifdef wxHAS_CALL_AFTER
+        if ( m_source && m_connection )
+        {
+            // Pending call is discarded with the event source
+            m_connection->add_pending();
+            m_source->CallAfter(deliver_call<Derived>(
+                static_cast<Derived*>(this), m_connection));
+            return;
+        }
+#endif
+
+        deliver_pending();
+    }
+
+    void delivered() { m_pending = false; }
+
+private:
+    wxEvtHandler* m_source;
+    int m_event_type;
+    detail::connection_state* m_connection;
+    bool m_pending;
+};
+
+template <class NativeEvent, class Filter>
+class coalesced_functor
+    : public coalesced_functor_base< coalesced_functor<NativeEvent, Filter> >
+{
+public:
+    coalesced_functor(const boost::function<void()>& handler,
+                      const Filter& filter)
+        : m_handler(handler), m_filter(filter)
+    {}
+
+    void operator()(NativeEvent& wxevent)
+    {
+        wxevent.Skip();
+
+        if ( !m_filter(wxevent) )
+            return;
+
+        if ( !this->pending() )
+            this->schedule();
+    }
+
+    void deliver()
+    {
+        this->delivered();
+        m_handler();
+    }
+
+    const std::type_info& handler_type() const { return m_handler.target_type(); }
+
+private:
+    const boost::function<void()> m_handler;
+    Filter m_filter;
+};
+
+template <class NativeEvent, class UIEvent, class Filter>
+class coalesced_functor_event
+    : public coalesced_functor_base< coalesced_functor_event<NativeEvent, UIEvent, Filter> >
+{
+public:
+    coalesced_functor_event(const boost::function<void(UIEvent&)>& handler,
+                            const Filter& filter)
+        : m_handler(handler), m_filter(filter)
+    {}
+
+    void operator()(NativeEvent& wxevent)
+    {
+        wxevent.Skip();
+
+        if ( !m_filter(wxevent) )
+            return;
+
+        UIEvent uievent;
+        init_event(uievent, wxevent);
+
+        if ( this->pending() )
+        {
+            m_event.coalesce(uievent);
+            return;
+        }
+
+        m_event = uievent;
+        this->schedule();
+    }
+
+    void deliver()
+    {
+        this->delivered();
+
+        UIEvent uievent;
+        std::swap(uievent, m_event);
+        m_handler(uievent);
+    }
+
+    const std::type_info& handler_type() const { return m_handler.target_type(); }
+
+private:
+    const boost::function<void(UIEvent&)> m_handler;
+    Filter m_filter;
+    UIEvent m_event;
+};
+
+// Passes event source and connection to the coalescing functors
+template <class Functor>
+void attach_functor(Functor&, wxEvtHandler*, int, detail::connection_state*)
+{
+}
+
+template <class NativeEvent, class Filter>
+void attach_functor(coalesced_functor<NativeEvent, Filter>& functor,
+                    wxEvtHandler* source, int event_type, detail::connection_state* c)
+{
+    functor.attach(source, event_type, c);
+}
+
+template <class NativeEvent, class UIEvent, class Filter>
+void attach_functor(coalesced_functor_event<NativeEvent, UIEvent, Filter>& functor,
+                    wxEvtHandler* source, int event_type, detail::connection_state* c)
+{
+    functor.attach(source, event_type, c);
+}
+
+// Delivers pending event of the coalescing functors
+template <class Functor>
+void deliver_functor(Functor&)
+{
+}
+
+template <class NativeEvent, class Filter>
+void deliver_functor(coalesced_functor<NativeEvent, Filter>& functor)
+{
+    functor.deliver_pending();
+}
+
+template <class NativeEvent, class UIEvent, class Filter>
+void deliver_functor(coalesced_functor_event<NativeEvent, UIEvent, Filter>& functor)
+{
+    functor.deliver_pending();
+}
+
+// Coalescing functors call handlers later, they time handlers themselves
+template <class Functor>
+bool deferred_functor(const Functor&)
+{
+    return false;
+}
+
+template <class NativeEvent, class Filter>
+bool deferred_functor(const coalesced_functor<NativeEvent, Filter>&)
+{
+    return true;
+}
+
+template <class NativeEvent, class UIEvent, class Filter>
+bool deferred_functor(const coalesced_functor_event<NativeEvent, UIEvent, Filter>&)
+{
+    return true;
+}
+
+// Functor that is bound to the event source.
+// The same functor is used to unbind handler.
+template <class Connection>
+class connection_functor
+{
+public:
+    explicit connection_functor(Connection* c) : m_connection(c), m_bound(false) {}
+
+    // Copy is stored by the event source
+    connection_functor(const connection_functor& other)
+        : m_connection(other.m_connection), m_bound(true)
+    {
+        m_connection->add_ref();
+        m_connection->bound();
+    }
+
+    ~connection_functor()
+    {
+        if ( m_bound )
+        {
+            m_connection->unbound();
+            m_connection->release();
+        }
+    }
+
+    template <class NativeEvent>
+    void operator()(NativeEvent& wxevent)
+    {
+        // Handler could disconnect itself and destroy this functor
+        const connection hold(m_connection);
+        m_connection->call(wxevent);
+    }
+
+private:
+    connection_functor& operator=(const connection_functor&);
+
+    Connection* m_connection;
+    bool m_bound;
+};
+
+template <class EventTag, class Functor>
+class event_connection : public detail::connection_state
+{
+    typedef event_connection<EventTag, Functor> this_type;
+
+public:
+    event_connection(wxEvtHandler* source, const EventTag& eventType,
+                     const Functor& functor)
+        : m_source(source), m_event_type(eventType), m_functor(functor),
+          m_anchor(this), m_bound_count(0)
+    {}
+
+    // Binds handler, handlers with the same key are removed if replace is true
+    void bind(const void* key, bool replace)
+    {
+        if ( replace )
+            disconnect_all(m_source, m_event_type, key);
+
+        register_source(m_source, m_event_type, key);
+        m_source->Bind(m_event_type, m_anchor);
+    }
+
+    void bound() { ++m_bound_count; }
+    void unbound()
+    {
+        // Event source is destroyed or handler is unbound
+        if ( --m_bound_count == 0 )
+            detach();
+    }
+
+    template <class NativeEvent>
+    void call(NativeEvent& wxevent)
+    {
+        const bool deferred = deferred_functor(m_functor);
+
+        // Coalesced events of the source happened before this one
+        if ( !deferred )
+            deliver_pending(m_source);
+
+        if ( event_trace::enabled() && !deferred )
+        {
+            const detail::handler_timer timer(m_source, m_event_type,
+                                              m_functor.handler_type());
+            m_functor(wxevent);
+        }
+        else
+            m_functor(wxevent);
+    }
+
+    Functor& functor() { return m_functor; }
+
+protected:
+    void do_deliver_pending() { deliver_functor(m_functor); }
+
+    void do_disconnect()
+    {
+        if ( m_bound_count )
+            m_source->Unbind(m_event_type, m_anchor);
+    }
+
+private:
+    wxEvtHandler* m_source;
+    const EventTag m_event_type;
+    Functor m_functor;
+    const connection_functor<this_type> m_anchor;
+    long m_bound_count;
+};
+
+template <class EventTag, class Functor>
+connection bind_connection(widget& w, EventTag eventType, const Functor& functor,
+                           const std::type_info& filter_type, bool replace)
 {
     wxWindow* impl = from_widget(w);
-    wxCHECK_RET(impl, "Widget should be created");
+    wxCHECK_MSG(impl, connection(), "Widget should be created");
 
-    impl->Bind(eventType, event_functor<
-        typename EventTag::EventClass>(handler, filter));
+    event_connection<EventTag, Functor>* c =
+        new event_connection<EventTag, Functor>(impl, eventType, functor);
+    const connection result(c);
+    attach_functor(c->functor(), impl, eventType, c);
+
+    // Handlers with the same filter type replace each other
+    c->bind(&filter_type, replace);
+
+    return result;
 }
 
-template <class NativeEvent, class UIEvent>
+template <class EventTag, class Filter>
+connection bind_helper(widget& w, EventTag eventType,
+                       const boost::function<void()>& handler,
+                       const Filter& filter, bool replace)
+{
+    return bind_connection(w, eventType,
+        event_functor<typename EventTag::EventClass, Filter>(handler, filter),
+        typeid(Filter), replace);
+}
+
+template <class EventTag>
+connection bind_helper(widget& w, EventTag eventType,
+                       const boost::function<void()>& handler,
+                       bool replace = false)
+{
+    return bind_helper(w, eventType, handler,
+        empty_filter<typename EventTag::EventClass>(), replace);
+}
+
+template <class NativeEvent, class UIEvent, class Filter>
 class event_functor_event
 {
 public:
     event_functor_event(const boost::function<void(UIEvent&)>& handler,
-                        const boost::function<bool(NativeEvent&)>& filter)
+                        const Filter& filter)
         : m_handler(handler), m_filter(filter)
     {}
 
@@ -77,28 +444,72 @@ public:
             return;
 
         UIEvent uievent;
-        init(uievent, wxevent);
+        init_event(uievent, wxevent);
         m_handler(uievent);
     }
 
-private:
-    void init(UIEvent& uievent, NativeEvent& wxevent);
+    const std::type_info& handler_type() const { return m_handler.target_type(); }
 
+private:
     const boost::function<void(UIEvent&)> m_handler;
-    const boost::function<bool(NativeEvent&)> m_filter;
+    Filter m_filter;
 };
 
+template <class EventTag, class UIEvent, class Filter>
+connection bind_event_helper(widget& w, EventTag eventType,
+                             const boost::function<void(UIEvent&)>& handler,
+                             const Filter& filter, bool replace)
+{
+    return bind_connection(w, eventType,
+        event_functor_event<typename EventTag::EventClass, UIEvent, Filter>(handler, filter),
+        typeid(Filter), replace);
+}
+
 template <class EventTag, class UIEvent>
-void bind_event_helper(widget& w, EventTag eventType,
-                       const boost::function<void(UIEvent&)>& handler,
-                       const boost::function<bool(typename EventTag::EventClass&)>& filter
-                           = empty_filter<typename EventTag::EventClass>())
+connection bind_event_helper(widget& w, EventTag eventType,
+                             const boost::function<void(UIEvent&)>& handler,
+                             bool replace = false)
 {
-    wxWindow* impl = from_widget(w);
-    wxCHECK_RET(impl, "Widget should be created");
+    return bind_event_helper(w, eventType, handler,
+        empty_filter<typename EventTag::EventClass>(), replace);
+}
 
-    impl->Bind(eventType, event_functor_event<
-        typename EventTag::EventClass, UIEvent>(handler, filter));
+template <class EventTag, class Filter>
+connection bind_coalesced_helper(widget& w, EventTag eventType,
+                                 const boost::function<void()>& handler,
+                                 const Filter& filter, bool replace)
+{
+    return bind_connection(w, eventType,
+        coalesced_functor<typename EventTag::EventClass, Filter>(handler, filter),
+        typeid(Filter), replace);
+}
+
+template <class EventTag>
+connection bind_coalesced_helper(widget& w, EventTag eventType,
+                                 const boost::function<void()>& handler,
+                                 bool replace = false)
+{
+    return bind_coalesced_helper(w, eventType, handler,
+        empty_filter<typename EventTag::EventClass>(), replace);
+}
+
+template <class EventTag, class UIEvent, class Filter>
+connection bind_coalesced_event_helper(widget& w, EventTag eventType,
+                                       const boost::function<void(UIEvent&)>& handler,
+                                       const Filter& filter, bool replace)
+{
+    return bind_connection(w, eventType,
+        coalesced_functor_event<typename EventTag::EventClass, UIEvent, Filter>(handler, filter),
+        typeid(Filter), replace);
+}
+
+template <class EventTag, class UIEvent>
+connection bind_coalesced_event_helper(widget& w, EventTag eventType,
+                                       const boost::function<void(UIEvent&)>& handler,
+                                       bool replace = false)
+{
+    return bind_coalesced_event_helper(w, eventType, handler,
+        empty_filter<typename EventTag::EventClass>(), replace);
 }
 
 } // namespace native
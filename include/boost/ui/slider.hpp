@@ -57,8 +57,8 @@ private:
         { check_range(value, min(), max()); }
     static void check_range(value_type value, value_type min, value_type max);
 
-    void on_slide_raw(const boost::function<void()>& handler);
-    void on_slide_end_raw(const boost::function<void()>& handler);
+    connection on_slide_raw(const boost::function<void()>& handler, bool replace);
+    connection on_slide_end_raw(const boost::function<void()>& handler, bool replace);
 
     class detail_impl;
     detail_impl* get_impl();
@@ -15,13 +15,57 @@
 #endif
 
 #include <sstream>
+#include <streambuf>
+#include <string>
 
 #include <boost/ui/string.hpp>
 
 namespace boost {
 namespace ui    {
 
+#ifndef DOXYGEN
+
+namespace detail {
+
+// Stream buffer that collects characters in the fixed array
+// and appends them to the string
+class uistring_streambuf : public std::wstreambuf
+{
+public:
+    explicit uistring_streambuf(uistring& str) : m_str(str)
+        { setp(m_chars, m_chars + chars_size); }
+
+protected:
+    int_type overflow(int_type ch)
+    {
+        sync();
+        if ( !traits_type::eq_int_type(ch, traits_type::eof()) )
+        {
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    int sync()
+    {
+        m_str.append(pbase(), pptr() - pbase());
+        setp(m_chars, m_chars + chars_size);
+        return 0;
+    }
+
+private:
+    enum { chars_size = 64 };
+    wchar_t m_chars[chars_size];
+    uistring& m_str;
+};
+
+} // namespace detail
+
+#endif
+
 /// @brief Output string stream that collects data for UI
+/// @details Data is formatted directly into the single growable buffer.
 /// @ingroup helper
 
 class BOOST_UI_DECL uiostringstream
@@ -42,49 +86,50 @@ public:
     ///@{ @brief Inserts data into stream
     uiostringstream& operator<<(short value)
     {
-        m_buffer += to_uistring(value);
+        append_number(m_buffer, static_cast<int>(value));
         return *this;
     }
     uiostringstream& operator<<(unsigned short value)
     {
-        m_buffer += to_uistring(value);
+        append_number(m_buffer, static_cast<unsigned int>(value));
         return *this;
     }
     uiostringstream& operator<<(int value)
     {
-        m_buffer += to_uistring(value);
+        append_number(m_buffer, value);
         return *this;
     }
     uiostringstream& operator<<(unsigned int value)
     {
-        m_buffer += to_uistring(value);
+        append_number(m_buffer, value);
         return *this;
     }
     uiostringstream& operator<<(long value)
     {
-        m_buffer += to_uistring(value);
+        append_number(m_buffer, value);
         return *this;
     }
     uiostringstream& operator<<(unsigned long value)
     {
-        m_buffer += to_uistring(value);
+        append_number(m_buffer, value);
         return *this;
     }
     uiostringstream& operator<<(long long value)
     {
-        m_buffer += to_uistring(value);
+        append_number(m_buffer, value);
         return *this;
     }
     uiostringstream& operator<<(unsigned long long value)
     {
-        m_buffer += to_uistring(value);
+        append_number(m_buffer, value);
         return *this;
     }
     uiostringstream& operator<<(float value);
     uiostringstream& operator<<(double value);
+    uiostringstream& operator<<(long double value);
     uiostringstream& operator<<(bool value)
     {
-        m_buffer += ascii(value ? "1" : "0");
+        m_buffer.append(1, value ? L'1' : L'0');
         return *this;
     }
     uiostringstream& operator<<(char value)
@@ -94,12 +139,12 @@ public:
     }
     uiostringstream& operator<<(const char* value)
     {
-        m_buffer += value;
+        m_buffer.append(value, std::char_traits<char>::length(value));
         return *this;
     }
     uiostringstream& operator<<(const std::string& value)
     {
-        m_buffer += value;
+        m_buffer.append(value.data(), value.size());
         return *this;
     }
     uiostringstream& operator<<(wchar_t value)
@@ -109,12 +154,12 @@ public:
     }
     uiostringstream& operator<<(const wchar_t* value)
     {
-        m_buffer += value;
+        m_buffer.append(value, std::char_traits<wchar_t>::length(value));
         return *this;
     }
     uiostringstream& operator<<(const std::wstring& value)
     {
-        m_buffer += value;
+        m_buffer.append(value.data(), value.size());
         return *this;
     }
 #ifndef BOOST_NO_CXX11_CHAR16_T
@@ -125,12 +170,12 @@ public:
     }
     uiostringstream& operator<<(const char16_t* value)
     {
-        m_buffer += value;
+        m_buffer.append(value, std::char_traits<char16_t>::length(value));
         return *this;
     }
     uiostringstream& operator<<(const std::u16string& value)
     {
-        m_buffer += value;
+        m_buffer.append(value.data(), value.size());
         return *this;
     }
 #endif
@@ -142,25 +187,37 @@ public:
     }
     uiostringstream& operator<<(const char32_t* value)
     {
-        m_buffer += value;
+        m_buffer.append(value, std::char_traits<char32_t>::length(value));
         return *this;
     }
     uiostringstream& operator<<(const std::u32string& value)
     {
-        m_buffer += value;
+        m_buffer.append(value.data(), value.size());
         return *this;
     }
 #endif
+    uiostringstream& operator<<(const uistring& value)
+    {
+        m_buffer += value;
+        return *this;
+    }
     template <class T>
     uiostringstream& operator<<(const T& value)
     {
-        std::wostringstream ss;
-        ss << value;
-        m_buffer += ss.str();
+        detail::uistring_streambuf buf(m_buffer);
+        std::wostream os(&buf);
+        os << value;
+        buf.pubsync();
         return *this;
     }
     ///@}
 
+    /// @brief Reserves storage for the collected data
+    void reserve(uistring::size_type capacity) { m_buffer.reserve(capacity); }
+
+    /// @brief Clears collected data, allocated storage is kept for reuse
+    void clear() BOOST_NOEXCEPT { m_buffer.clear(); }
+
     /// @brief Exchanges contents of the streams
     void swap(uiostringstream& other) { m_buffer.swap(other.m_buffer); }
 
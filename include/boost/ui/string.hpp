@@ -15,11 +15,18 @@
 #endif
 
 #include <string>
+#include <cstring> // for std::memcpy(), std::strlen()
+
+#include <boost/core/scoped_enum.hpp>
 
 #ifndef BOOST_NO_CXX11_HDR_INITIALIZER_LIST
 #include <initializer_list>
 #endif
 
+#ifndef BOOST_NO_CXX17_HDR_STRING_VIEW
+#include <string_view>
+#endif
+
 #ifndef BOOST_UI_NO_STD_HASH
 #include <functional>
 #endif
@@ -44,6 +51,7 @@ namespace boost {
 namespace ui    {
 
 /// @brief Helper class to convert string between UI and application logic only
+/// @details Short strings are stored inline in UTF-8 encoding without heap allocation.
 /// @ingroup helper
 
 class BOOST_UI_DECL uistring
@@ -52,15 +60,15 @@ public:
     /// Unsigned integral type
     typedef std::size_t size_type;
 
-    uistring();
+    uistring() BOOST_NOEXCEPT { init(); }
 
     ///@{ Constructs uistring from other uistring
     uistring(const uistring& other);
 #ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
-    uistring(uistring&& other)
+    uistring(uistring&& other) BOOST_NOEXCEPT
     {
-        init();
-        swap(other);
+        std::memcpy(m_short, other.m_short, sizeof m_short);
+        other.init();
     }
 #endif
     ///@}
@@ -68,7 +76,15 @@ public:
 #ifndef BOOST_UI_NO_CAST_FROM_ASCII
     ///@{ Constructs uistring from narrow char* string using current locale encoding
     uistring(const char* str);
+    uistring(const char* str, size_type size);
     uistring(const std::string& str);
+#ifndef BOOST_NO_CXX17_HDR_STRING_VIEW
+    uistring(std::string_view str)
+    {
+        init();
+        append(str.data(), str.size());
+    }
+#endif
 #ifndef BOOST_NO_CXX11_HDR_INITIALIZER_LIST
     uistring(std::initializer_list<char> list)
     {
@@ -81,7 +97,15 @@ public:
 
     ///@{ Constructs uistring from Unicode wide char string
     uistring(const wchar_t* str);
+    uistring(const wchar_t* str, size_type size);
     uistring(const std::wstring& str);
+#ifndef BOOST_NO_CXX17_HDR_STRING_VIEW
+    uistring(std::wstring_view str)
+    {
+        init();
+        append(str.data(), str.size());
+    }
+#endif
 #ifndef BOOST_NO_CXX11_HDR_INITIALIZER_LIST
     uistring(std::initializer_list<wchar_t> list)
     {
@@ -93,8 +117,28 @@ public:
 
     ///@{ Constructs uistring from UTF-16 string
 #ifndef BOOST_NO_CXX11_CHAR16_T
-    uistring(const char16_t* str) { init(std::u16string(str)); }
-    uistring(const std::u16string& str) { init(str); }
+    uistring(const char16_t* str)
+    {
+        init();
+        append(str, std::char_traits<char16_t>::length(str));
+    }
+    uistring(const char16_t* str, size_type size)
+    {
+        init();
+        append(str, size);
+    }
+    uistring(const std::u16string& str)
+    {
+        init();
+        append(str.data(), str.size());
+    }
+#ifndef BOOST_NO_CXX17_HDR_STRING_VIEW
+    uistring(std::u16string_view str)
+    {
+        init();
+        append(str.data(), str.size());
+    }
+#endif
 #ifndef BOOST_NO_CXX11_HDR_INITIALIZER_LIST
     uistring(std::initializer_list<char16_t> list)
     {
@@ -107,8 +151,28 @@ public:
 
     ///@{ Constructs uistring from UTF-32 string
 #ifndef BOOST_NO_CXX11_CHAR32_T
-    uistring(const char32_t* str) { init(std::u32string(str)); }
-    uistring(const std::u32string& str) { init(str); }
+    uistring(const char32_t* str)
+    {
+        init();
+        append(str, std::char_traits<char32_t>::length(str));
+    }
+    uistring(const char32_t* str, size_type size)
+    {
+        init();
+        append(str, size);
+    }
+    uistring(const std::u32string& str)
+    {
+        init();
+        append(str.data(), str.size());
+    }
+#ifndef BOOST_NO_CXX17_HDR_STRING_VIEW
+    uistring(std::u32string_view str)
+    {
+        init();
+        append(str.data(), str.size());
+    }
+#endif
 #ifndef BOOST_NO_CXX11_HDR_INITIALIZER_LIST
     uistring(std::initializer_list<char32_t> list)
     {
@@ -125,12 +189,12 @@ public:
     uistring& assign(const uistring& other);
     uistring& operator=(const uistring& other) { return assign(other); }
 #ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
-    uistring& assign(uistring&& other)
+    uistring& assign(uistring&& other) BOOST_NOEXCEPT
     {
         swap(other);
         return *this;
     }
-    uistring& operator=(uistring&& other)
+    uistring& operator=(uistring&& other) BOOST_NOEXCEPT
     {
         // return assign(other); // not works
         swap(other);
@@ -158,6 +222,21 @@ public:
     ///@{ Appends characters to the end of string
     uistring& append(const uistring& str);
     uistring& operator+=(const uistring& str) { return append(str); }
+#ifndef BOOST_UI_NO_CAST_FROM_ASCII
+    uistring& append(const char* str, size_type size);
+#endif
+    uistring& append(const wchar_t* str, size_type size);
+#ifndef BOOST_NO_CXX11_CHAR16_T
+    uistring& append(const char16_t* str, size_type size);
+#endif
+#ifndef BOOST_NO_CXX11_CHAR32_T
+    uistring& append(const char32_t* str, size_type size);
+#endif
+#ifndef BOOST_NO_CXX17_HDR_STRING_VIEW
+    template <class CharT>
+    uistring& append(std::basic_string_view<CharT> str)
+        { return append(str.data(), str.size()); }
+#endif
 #ifndef BOOST_UI_NO_CAST_FROM_ASCII
     uistring& append(size_type count, char ch);
 #endif
@@ -168,7 +247,12 @@ public:
 #endif
 #ifndef BOOST_NO_CXX11_CHAR32_T
     uistring& append(size_type count, char32_t ch)
-        { return append(count, static_cast<wchar_t>(ch)); }
+    {
+        while ( count-- )
+            append(&ch, 1);
+
+        return *this;
+    }
 #endif
 #ifndef BOOST_NO_CXX11_HDR_INITIALIZER_LIST
 #ifndef BOOST_UI_NO_CAST_FROM_ASCII
@@ -194,28 +278,23 @@ public:
 #ifndef BOOST_NO_CXX11_CHAR16_T
     uistring& append(std::initializer_list<char16_t> list)
     {
-        for ( std::initializer_list<char16_t>::const_iterator i = list.begin();
-             i != list.end(); ++i )
-             push_back(*i);
-
-        return *this;
+        return append(list.begin(), list.size());
     }
     uistring& operator+=(std::initializer_list<char16_t> list) { return append(list); }
 #endif
 #ifndef BOOST_NO_CXX11_CHAR32_T
     uistring& append(std::initializer_list<char32_t> list)
     {
-        for ( std::initializer_list<char32_t>::const_iterator i = list.begin();
-             i != list.end(); ++i )
-             push_back(*i);
-
-        return *this;
+        return append(list.begin(), list.size());
     }
     uistring& operator+=(std::initializer_list<char32_t> list) { return append(list); }
 #endif
 #endif
     ///@}
 
+    /// Inserts characters at the beginning of string
+    uistring& prepend(const uistring& str);
+
     ///@{ Appends character to the end of string
 #ifndef BOOST_UI_NO_CAST_FROM_ASCII
     void push_back(char ch);
@@ -228,7 +307,7 @@ public:
     uistring& operator+=(char16_t ch) { push_back(ch); return *this; }
 #endif
 #ifndef BOOST_NO_CXX11_CHAR32_T
-    void push_back(char32_t ch) { push_back(static_cast<wchar_t>(ch)); }
+    void push_back(char32_t ch) { append(&ch, 1); }
     uistring& operator+=(char32_t ch) { push_back(ch); return *this; }
 #endif
     ///@}
@@ -250,14 +329,25 @@ public:
     ///@}
 
     /// Exchanges the contents of strings
-    void swap(const uistring& other);
+    void swap(uistring& other) BOOST_NOEXCEPT
+    {
+        char temp[sizeof m_short];
+        std::memcpy(temp, m_short, sizeof temp);
+        std::memcpy(m_short, other.m_short, sizeof m_short);
+        std::memcpy(other.m_short, temp, sizeof temp);
+    }
 
     /// Checks whether the string is empty
     bool empty() const BOOST_NOEXCEPT;
 
-    /// Clears the contents
+    /// Clears the contents, allocated storage is kept for reuse
     void clear() BOOST_NOEXCEPT;
 
+    /// @brief Reserves storage for appending
+    /// @details Texts larger than a few megabytes are stored in chunks,
+    /// so the reservation is limited by the chunk threshold.
+    void reserve(size_type capacity);
+
     /// Requests the removal of unused capacity
     void shrink_to_fit();
 
@@ -276,6 +366,14 @@ public:
     /// Returns UTF-8 encoded string
     std::string u8string() const;
 
+#ifndef BOOST_NO_CXX17_HDR_STRING_VIEW
+    /// @brief Returns view of UTF-8 encoded string
+    /// @details Doesn't copy the string if it is already stored contiguously
+    /// in UTF-8 encoding, otherwise transcodes it into the @a buffer and returns
+    /// view of the @a buffer. View is invalidated by string or @a buffer modification.
+    std::string_view u8_view(std::string& buffer) const;
+#endif
+
 #ifndef BOOST_UI_NO_STRING_DESTRUCTIVE
     /// @brief Returns 7-bit ASCII encoded string
     /// Replaces 8-bit items with underscore symbol (_)
@@ -290,62 +388,67 @@ public:
 
 #ifndef BOOST_NO_CXX11_CHAR16_T
     ///@brief Returns UTF-16 std::u16string
-    std::u16string u16string() const
-        { return xstring<std::u16string>(); }
+    std::u16string u16string() const;
 #endif
 
 #ifndef BOOST_NO_CXX11_CHAR32_T
     ///@{ Returns UTF-32 std::u32string
-    std::u32string u32string() const
-        { return xstring<std::u32string>(); }
+    std::u32string u32string() const;
     ///@}
 #endif
 
     /// Implementation-defined string type
     typedef void* native_handle_type;
 
-    ///@{ Returns the implementation-defined underlying string handle
-    native_handle_type native_handle() { return m_impl; }
-    const native_handle_type native_handle() const { return m_impl; }
-    ///@}
+    /// @brief Returns the implementation-defined underlying string handle
+    /// @details Inline stored short string is moved into the heap allocated
+    /// implementation-defined string. Handle is invalidated by string modification.
+    native_handle_type native_handle();
+
+    /// @brief Returns the implementation-defined underlying string handle
+    /// without modification of the string
+    /// @details Returns NULL if the string is stored inline
+    /// or its heap allocated storage isn't contiguous.
+    /// Handle is invalidated by string modification.
+    const native_handle_type native_handle() const;
 
 private:
-    void init();
-    void init(const std::wstring& str);
+    class impl;
 
-    static uistring make_from_utf8(const char* str);
-    static uistring make_from_ascii(const char* str);
+    enum { short_capacity = 23, long_tag = 0xFF };
 
-    template <class String>
-    void init(const String& str)
-    {
-        std::wstring wstr;
-        wstr.reserve(str.size());
-        for ( typename String::const_iterator iter = str.begin();
-                iter != str.end(); ++iter )
-             wstr.push_back(static_cast<wchar_t>(*iter));
-        init(wstr);
-    }
+    void init() BOOST_NOEXCEPT { m_short[short_capacity] = 0; }
 
-    template <class String>
-    String xstring() const
+    bool is_short() const BOOST_NOEXCEPT
+        { return static_cast<unsigned char>(m_short[short_capacity]) != long_tag; }
+    size_type short_size() const BOOST_NOEXCEPT
+        { return static_cast<unsigned char>(m_short[short_capacity]); }
+    void set_short_size(size_type size) BOOST_NOEXCEPT
+        { m_short[short_capacity] = static_cast<char>(size); }
+    void set_long(impl* p) BOOST_NOEXCEPT
     {
-        const std::wstring wstr = wstring();
-        String result;
-        result.reserve(wstr.size());
-        for ( std::wstring::const_iterator iter = wstr.begin();
-                iter != wstr.end(); ++iter )
-             result.push_back(*iter);
-        return result;
+        m_impl = p;
+        m_short[short_capacity] = static_cast<char>(long_tag);
     }
+    void reset() BOOST_NOEXCEPT;
+    impl& native_impl();
+
+    static uistring make_from_utf8(const char* str, size_type size);
+    static uistring make_from_ascii(const char* str, size_type size);
 
-    class impl;
-    impl* m_impl;
+
+    // Short string is UTF-8 encoded and its size is stored in the last byte,
+    // long_tag in the last byte means heap allocated implementation-defined string
+    union
+    {
+        impl* m_impl;
+        char m_short[short_capacity + 1];
+    };
 
 #ifndef DOXYGEN
     friend class native_helper;
-    friend uistring u8uistring(const char* str);
-    friend uistring asciiuistring(const char* str);
+    friend uistring u8uistring(const char* str, size_type size);
+    friend uistring asciiuistring(const char* str, size_type size);
 #endif
 };
 
@@ -389,18 +492,32 @@ inline std::u32string uistring::basic_string() const { return u32string(); }
 
 ///@{ @brief Constructs @ref uistring from UTF-8 encoded string
 ///   @relatesalso boost::ui::uistring
-inline uistring u8uistring(const char* str) { return uistring::make_from_utf8(str); }
-inline uistring u8uistring(const std::string& str) { return u8uistring(str.c_str()); }
+inline uistring u8uistring(const char* str, uistring::size_type size)
+    { return uistring::make_from_utf8(str, size); }
+inline uistring u8uistring(const char* str) { return u8uistring(str, std::strlen(str)); }
+inline uistring u8uistring(const std::string& str) { return u8uistring(str.data(), str.size()); }
+inline uistring utf8(const char* str, uistring::size_type size) { return u8uistring(str, size); }
 inline uistring utf8(const char* str) { return u8uistring(str); }
-inline uistring utf8(const std::string& str) { return u8uistring(str.c_str()); }
+inline uistring utf8(const std::string& str) { return u8uistring(str); }
+#ifndef BOOST_NO_CXX17_HDR_STRING_VIEW
+inline uistring u8uistring(std::string_view str) { return u8uistring(str.data(), str.size()); }
+inline uistring utf8(std::string_view str) { return u8uistring(str); }
+#endif
 ///@}
 
 ///@{ @brief Constructs @ref uistring from 7-bit ASCII encoded string
 ///   @relatesalso boost::ui::uistring
-inline uistring asciiuistring(const char* str) { return uistring::make_from_ascii(str); }
-inline uistring asciiuistring(const std::string& str) { return asciiuistring(str.c_str()); }
+inline uistring asciiuistring(const char* str, uistring::size_type size)
+    { return uistring::make_from_ascii(str, size); }
+inline uistring asciiuistring(const char* str) { return asciiuistring(str, std::strlen(str)); }
+inline uistring asciiuistring(const std::string& str) { return asciiuistring(str.data(), str.size()); }
+inline uistring ascii(const char* str, uistring::size_type size) { return asciiuistring(str, size); }
 inline uistring ascii(const char* str) { return asciiuistring(str); }
-inline uistring ascii(const std::string& str) { return asciiuistring(str.c_str()); }
+inline uistring ascii(const std::string& str) { return asciiuistring(str); }
+#ifndef BOOST_NO_CXX17_HDR_STRING_VIEW
+inline uistring asciiuistring(std::string_view str) { return asciiuistring(str.data(), str.size()); }
+inline uistring ascii(std::string_view str) { return asciiuistring(str); }
+#endif
 ///@}
 
 ///@{ @brief Concatenates two strings or the string and the character
@@ -419,10 +536,7 @@ inline uistring operator+(uistring&& lhs, const uistring& rhs)
 }
 inline uistring operator+(const uistring& lhs, uistring&& rhs)
 {
-    uistring result(lhs);
-    result.append(std::move(rhs));
-    rhs.clear(); // TODO: Remove
-    return result;
+    return std::move(rhs.prepend(lhs));
 }
 inline uistring operator+(uistring&& lhs, uistring&& rhs)
 {
@@ -584,7 +698,53 @@ inline uistring operator+(uistring&& lhs, const char32_t* rhs)
 
 ///@}
 
+/// @brief Notation of numbers for @ref append_number
+/// @relatesalso boost::ui::uistring
+BOOST_SCOPED_ENUM_DECLARE_BEGIN(number_format)
+{
+    general,    ///< Fixed or scientific notation, whichever is shorter
+    fixed,      ///< Fixed-point notation
+    scientific, ///< Scientific notation
+    hex         ///< Hexadecimal notation
+}
+BOOST_SCOPED_ENUM_DECLARE_END(number_format)
+
+///@{ @brief Appends integer value to @ref uistring
+///   @details Integer is written in decimal notation
+///   or in hexadecimal notation if @a f is number_format::hex.
+///   @relatesalso boost::ui::uistring
+BOOST_UI_DECL uistring& append_number(uistring& str, int value,
+                                      number_format f = number_format::general);
+BOOST_UI_DECL uistring& append_number(uistring& str, unsigned int value,
+                                      number_format f = number_format::general);
+BOOST_UI_DECL uistring& append_number(uistring& str, long value,
+                                      number_format f = number_format::general);
+BOOST_UI_DECL uistring& append_number(uistring& str, unsigned long value,
+                                      number_format f = number_format::general);
+BOOST_UI_DECL uistring& append_number(uistring& str, long long value,
+                                      number_format f = number_format::general);
+BOOST_UI_DECL uistring& append_number(uistring& str, unsigned long long value,
+                                      number_format f = number_format::general);
+///@}
+
+///@{ @brief Appends floating-point value to @ref uistring
+///   @details If @a precision is negative, value is written with
+///   the shortest representation that is read back to the same value.
+///   @relatesalso boost::ui::uistring
+BOOST_UI_DECL uistring& append_number(uistring& str, float value,
+                                      number_format f = number_format::general,
+                                      int precision = -1);
+BOOST_UI_DECL uistring& append_number(uistring& str, double value,
+                                      number_format f = number_format::general,
+                                      int precision = -1);
+BOOST_UI_DECL uistring& append_number(uistring& str, long double value,
+                                      number_format f = number_format::general,
+                                      int precision = -1);
+///@}
+
 ///@{ @brief Converts numeric value to @ref uistring
+///   @details Floating-point value is written with
+///   the shortest representation that is read back to the same value.
 ///   @relatesalso boost::ui::uistring
 BOOST_UI_DECL uistring to_uistring(int value);
 BOOST_UI_DECL uistring to_uistring(unsigned int value);
@@ -598,6 +758,8 @@ BOOST_UI_DECL uistring to_uistring(long double value);
 ///@}
 
 /// @brief Returns hash of @ref uistring for boost::hash
+/// @details Hashes UTF-8 representation without allocation
+/// and caches the result for long strings.
 /// @relatesalso boost::ui::uistring
 BOOST_UI_DECL std::size_t hash_value(const uistring& value);
 
@@ -616,12 +778,14 @@ inline void swap(boost::ui::uistring& a, boost::ui::uistring& b) { a.swap(b); }
 /// @brief std::hash specialization for @ref boost::ui::uistring
 template<>
 struct hash<boost::ui::uistring>
-    : public std::unary_function<boost::ui::uistring, std::size_t>
 {
+    typedef boost::ui::uistring argument_type;
+    typedef std::size_t result_type;
+
     /// @brief Calculates the hash of the @ref boost::ui::uistring
     std::size_t operator()(const boost::ui::uistring& key) const
     {
-        return std::hash<std::wstring>()(key.wstring());
+        return boost::ui::hash_value(key);
     }
 };
 
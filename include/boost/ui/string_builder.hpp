@@ -0,0 +1,131 @@
+// Copyright (c) 2018 Kolya Kosenko
+
+// Distributed under the Boost Software License, Version 1.0.
+// See http://www.boost.org/LICENSE_1_0.txt
+
+/// @file string_builder.hpp @brief String builder class
+
+#ifndef BOOST_UI_STRING_BUILDER_HPP
+#define BOOST_UI_STRING_BUILDER_HPP
+
+#include <boost/ui/config.hpp>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <boost/ui/string.hpp>
+
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+#include <utility>
+#endif
+
+namespace boost {
+namespace ui    {
+
+/// @brief Assembles large text from pieces without quadratic copying
+/// @details Text larger than a few megabytes is stored in chunks,
+/// appended pieces aren't moved when the text grows.
+/// Resulting string is moved out by str() or release() without copying.
+/// @see uistring
+/// @ingroup helper
+
+class uistring_builder
+{
+public:
+    typedef uistring::size_type size_type;
+
+    /// Creates empty builder
+    uistring_builder() {}
+
+    /// Creates empty builder and reserves storage for @a capacity characters
+    explicit uistring_builder(size_type capacity) { reserve(capacity); }
+
+    /// Reserves storage for appending
+    void reserve(size_type capacity) { m_buffer.reserve(capacity); }
+
+    ///@{ Appends characters to the end of text
+    uistring_builder& append(const uistring& str)
+    {
+        m_buffer.append(str);
+        return *this;
+    }
+#ifndef BOOST_UI_NO_CAST_FROM_ASCII
+    uistring_builder& append(const char* str, size_type size)
+    {
+        m_buffer.append(str, size);
+        return *this;
+    }
+    uistring_builder& append(size_type count, char ch)
+    {
+        m_buffer.append(count, ch);
+        return *this;
+    }
+#endif
+    uistring_builder& append(const wchar_t* str, size_type size)
+    {
+        m_buffer.append(str, size);
+        return *this;
+    }
+    uistring_builder& append(size_type count, wchar_t ch)
+    {
+        m_buffer.append(count, ch);
+        return *this;
+    }
+#ifndef BOOST_NO_CXX11_CHAR16_T
+    uistring_builder& append(const char16_t* str, size_type size)
+    {
+        m_buffer.append(str, size);
+        return *this;
+    }
+#endif
+#ifndef BOOST_NO_CXX11_CHAR32_T
+    uistring_builder& append(const char32_t* str, size_type size)
+    {
+        m_buffer.append(str, size);
+        return *this;
+    }
+#endif
+    uistring_builder& operator+=(const uistring& str) { return append(str); }
+    uistring_builder& operator<<(const uistring& str) { return append(str); }
+    ///@}
+
+    /// Appends formatted number, see @ref append_number
+    template <class T>
+    uistring_builder& append_number(T value, number_format format = number_format::general)
+    {
+        ui::append_number(m_buffer, value, format);
+        return *this;
+    }
+
+    /// Checks whether the text is empty
+    bool empty() const { return m_buffer.empty(); }
+
+    /// Clears the text
+    void clear() { m_buffer.clear(); }
+
+    ///@{ Returns assembled text, moves it out of the rvalue builder
+#ifndef BOOST_NO_CXX11_REF_QUALIFIERS
+    uistring str() const& { return m_buffer; }
+    uistring str() && { return std::move(m_buffer); }
+#else
+    uistring str() const { return m_buffer; }
+#endif
+    ///@}
+
+    /// Moves assembled text out of the builder and clears the builder
+    uistring release()
+    {
+        uistring result;
+        result.swap(m_buffer);
+        return result;
+    }
+
+private:
+    uistring m_buffer;
+};
+
+} // namespace ui
+} // namespace boost
+
+#endif // BOOST_UI_STRING_BUILDER_HPP
@@ -37,6 +37,10 @@ public:
     /// Returns text from the editor
     uistring text() const;
 
+    /// @brief Appends text to the end of the editor
+    /// @details Doesn't copy current text, unlike text(text() + str)
+    text_box_base& append(const uistring& text);
+
     ///@{ Connects text edit handler
     BOOST_UI_DETAIL_HANDLER(edit, text_box_base);
     ///@}
@@ -51,7 +55,7 @@ protected:
 #endif
 
 private:
-    void on_edit_raw(const boost::function<void()>& handler);
+    connection on_edit_raw(const boost::function<void()>& handler, bool replace);
 
     class detail_impl;
     detail_impl* get_impl();
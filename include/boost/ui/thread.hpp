@@ -15,23 +15,49 @@
 #endif
 
 #include <boost/function.hpp>
+#include <boost/core/scoped_enum.hpp>
 
 #ifndef BOOST_NO_CXX11_VARIADIC_TEMPLATES
 #include <boost/move/utility.hpp> // boost::forward()
 #endif
 
+#if defined(BOOST_NO_CXX11_HDR_FUTURE) || defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES) \
+    || defined(BOOST_NO_CXX11_DECLTYPE)
+#define BOOST_UI_NO_CALL_ASYNC_FUTURE
+#else
+#include <future>
+#include <memory>
+#endif
+
 namespace boost  {
 namespace ui     {
 
+/// @brief Priority of the task that is called by ui::post()
+/// @ingroup thread
+BOOST_SCOPED_ENUM_DECLARE_BEGIN(task_priority)
+{
+    high,   ///< Task is called before the pending events
+    normal, ///< Task is called after the pending events, yields to the user input
+    idle    ///< Task is called only if there are no pending events and user input
+}
+BOOST_SCOPED_ENUM_DECLARE_END(task_priority)
+
 #ifndef DOXYGEN
 
 namespace detail {
 BOOST_UI_DECL void call_async(const boost::function<void()>& fn);
+BOOST_UI_DECL void call_async_latest(const void* key, const boost::function<void()>& fn);
+BOOST_UI_DECL bool process_async_calls();
+BOOST_UI_DECL bool is_ui_thread();
+BOOST_UI_DECL void post(task_priority priority, const boost::function<void()>& fn);
+BOOST_UI_DECL void on_idle(const boost::function<bool()>& fn);
 } // namespace detail
 
 #endif
 
 /// @brief Calls @a f in the idle time in UI thread. This function is thread safe.
+/// @details Calls are queued without locks and called by batches
+/// in the posting order.
 /// @see <a href="http://en.wikipedia.org/wiki/Thread_safety">Thread safety (Wikipedia)</a>
 /// @ingroup thread
 
@@ -48,6 +74,116 @@ inline void call_async(const boost::function<void()>& fn)
 }
 #endif
 
+/// @brief Calls @a f in UI thread, replaces pending call with the same @a key.
+/// This function is thread safe.
+/// @details Only the last pending call of every key is called, once per event loop iteration.
+/// Calls of different keys are called in the order of the first pending call of every key.
+/// It is useful for updates of the progress bars, status texts, etc.
+/// that are posted faster than UI thread shows them.
+/// Usually @a key is the address of the updated widget.
+/// @see call_async
+/// @ingroup thread
+
+#ifndef BOOST_NO_CXX11_VARIADIC_TEMPLATES
+template <class F, class ...Args>
+void call_async_latest(const void* key, F&& f, Args&&... args)
+{
+    detail::call_async_latest(key, std::bind(boost::forward<F>(f), boost::forward<Args>(args)...));
+}
+#else
+inline void call_async_latest(const void* key, const boost::function<void()>& fn)
+{
+    detail::call_async_latest(key, fn);
+}
+#endif
+
+#ifndef BOOST_UI_NO_CALL_ASYNC_FUTURE
+
+#ifndef DOXYGEN
+
+namespace detail {
+
+// Calls shared packaged task, boost::function requires copyable function
+template <class R>
+class packaged_call
+{
+public:
+    explicit packaged_call(const std::shared_ptr< std::packaged_task<R()> >& task)
+        : m_task(task) {}
+
+    void operator()() { (*m_task)(); }
+
+private:
+    std::shared_ptr< std::packaged_task<R()> > m_task;
+};
+
+} // namespace detail
+
+#endif
+
+/// @brief Calls @a f in UI thread and returns future of its result.
+/// This function is thread safe.
+/// @details Future receives the exception if @a f throws.
+/// Future shouldn't be waited in UI thread, it isn't ready until UI thread is free.
+/// @see call_async
+/// @ingroup thread
+
+template <class F, class ...Args>
+auto call_async_future(F&& f, Args&&... args)
+    -> std::future<decltype(std::bind(boost::forward<F>(f), boost::forward<Args>(args)...)())>
+{
+    typedef decltype(std::bind(boost::forward<F>(f), boost::forward<Args>(args)...)()) result_type;
+
+    const std::shared_ptr< std::packaged_task<result_type()> > task =
+        std::make_shared< std::packaged_task<result_type()> >(
+            std::bind(boost::forward<F>(f), boost::forward<Args>(args)...));
+    std::future<result_type> result = task->get_future();
+    detail::call_async(detail::packaged_call<result_type>(task));
+    return result;
+}
+
+#endif
+
+/// @brief Calls @a f in UI thread with the @a priority. This function is thread safe.
+/// @details Tasks of the same priority are called in the posting order.
+/// Tasks of the normal and idle priorities are called by time slices,
+/// the rest of the tasks is postponed if the user input is pending.
+/// @see call_async
+/// @ingroup thread
+
+#ifndef BOOST_NO_CXX11_VARIADIC_TEMPLATES
+template <class F, class ...Args>
+void post(task_priority priority, F&& f, Args&&... args)
+{
+    detail::post(priority, std::bind(boost::forward<F>(f), boost::forward<Args>(args)...));
+}
+#else
+inline void post(task_priority priority, const boost::function<void()>& fn)
+{
+    detail::post(priority, fn);
+}
+#endif
+
+/// @brief Repeatedly calls @a f in UI thread while it returns true
+/// and there is no pending user input. This function is thread safe.
+/// @details Each call should do a small chunk of the background work
+/// and return true if some work remains.
+/// Chunks are called by short time slices between the events,
+/// so the background work doesn't delay the user input.
+/// @ingroup thread
+
+#ifndef BOOST_NO_CXX11_VARIADIC_TEMPLATES
+template <class F, class ...Args>
+void on_idle(F&& f, Args&&... args)
+{
+    detail::on_idle(std::bind(boost::forward<F>(f), boost::forward<Args>(args)...));
+}
+#else
+inline void on_idle(const boost::function<bool()>& fn)
+{
+    detail::on_idle(fn);
+}
+#endif
 
 } // namespace ui
 } // namespace boost
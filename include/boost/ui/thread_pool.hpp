@@ -0,0 +1,312 @@
+// Copyright (c) 2018 Kolya Kosenko
+
+// Distributed under the Boost Software License, Version 1.0.
+// See http://www.boost.org/LICENSE_1_0.txt
+
+/// @file thread_pool.hpp @brief Thread pool with continuations in UI thread
+
+#ifndef BOOST_UI_THREAD_POOL_HPP
+#define BOOST_UI_THREAD_POOL_HPP
+
+#include <boost/ui/config.hpp>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#pragma once
+#endif
+
+#include <boost/ui/thread.hpp>
+
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/optional.hpp>
+#include <boost/exception_ptr.hpp>
+#include <boost/core/noncopyable.hpp>
+#include <boost/utility/result_of.hpp>
+
+#include <cstddef>
+
+namespace boost {
+namespace ui    {
+
+/// @brief Fixed count of worker threads that call posted functions
+/// @details Functions are called in the posting order by the first free thread.
+/// Use ui::async() to continue with the result in UI thread.
+/// @see <a href="http://en.wikipedia.org/wiki/Thread_pool">Thread pool (Wikipedia)</a>
+/// @ingroup thread
+
+class BOOST_UI_DECL thread_pool : private boost::noncopyable
+{
+public:
+    /// @brief Starts worker threads
+    /// @param threads_count Count of threads, zero means count of processors
+    /// @throw std::runtime_error if thread can't be started
+    explicit thread_pool(std::size_t threads_count = 0);
+
+    /// Waits until all posted functions are called and stops threads
+    ~thread_pool();
+
+    /// Calls @a fn in some worker thread. This function is thread safe.
+    void post(const boost::function<void()>& fn);
+
+    /// Calls @a fn in some worker thread. This function is thread safe.
+    void execute(const boost::function<void()>& fn) { post(fn); }
+
+    /// Returns count of worker threads
+    std::size_t size() const;
+
+private:
+    class detail_impl;
+    detail_impl* m_impl;
+};
+
+template <class R>
+class task;
+
+#ifndef DOXYGEN
+
+namespace detail {
+
+// Shared state of the task, reference counted from UI thread only
+class task_state_base : private boost::noncopyable
+{
+public:
+    task_state_base() : m_refs(0), m_finished(false), m_delivered(false) {}
+    virtual ~task_state_base() {}
+
+    void add_ref() { ++m_refs; }
+    void release()
+    {
+        if ( --m_refs == 0 )
+            delete this;
+    }
+
+    bool finished() const { return m_finished; }
+
+    // Called in UI thread after the work is done
+    void finish()
+    {
+        m_finished = true;
+        try
+        {
+            try_deliver();
+        }
+        catch ( ... )
+        {
+            release();
+            throw;
+        }
+        release();
+    }
+
+protected:
+    // Calls handler if the work is done and handler is set
+    void try_deliver()
+    {
+        if ( !m_finished || m_delivered || !has_handler() )
+            return;
+
+        m_delivered = true;
+
+        // Exception of the work is thrown in UI thread
+        if ( m_exception )
+            boost::rethrow_exception(m_exception);
+
+        deliver();
+    }
+
+    virtual bool has_handler() const = 0;
+    virtual void deliver() = 0;
+
+    boost::exception_ptr m_exception;
+
+private:
+    long m_refs;
+    bool m_finished;
+    bool m_delivered;
+};
+
+template <class R>
+class task_state : public task_state_base
+{
+public:
+    typedef boost::function<void(const R&)> handler_type;
+
+    template <class F>
+    void run(F& work)
+    {
+        try
+        {
+            m_value = work();
+        }
+        catch ( ... )
+        {
+            m_exception = boost::current_exception();
+        }
+    }
+
+    void then(const handler_type& handler)
+    {
+        m_handler = handler;
+        try_deliver();
+    }
+
+private:
+    virtual bool has_handler() const { return !m_handler.empty(); }
+    virtual void deliver() { m_handler(*m_value); }
+
+    boost::optional<R> m_value;
+    handler_type m_handler;
+};
+
+template <>
+class task_state<void> : public task_state_base
+{
+public:
+    typedef boost::function<void()> handler_type;
+
+    template <class F>
+    void run(F& work)
+    {
+        try
+        {
+            work();
+        }
+        catch ( ... )
+        {
+            m_exception = boost::current_exception();
+        }
+    }
+
+    void then(const handler_type& handler)
+    {
+        m_handler = handler;
+        try_deliver();
+    }
+
+private:
+    virtual bool has_handler() const { return !m_handler.empty(); }
+    virtual void deliver() { m_handler(); }
+
+    handler_type m_handler;
+};
+
+// Calls the work in the worker thread and finishes the task in UI thread
+template <class R, class F>
+class task_work
+{
+public:
+    task_work(task_state<R>* state, const F& work) : m_state(state), m_work(work) {}
+
+    void operator()()
+    {
+        m_state->run(m_work);
+        ui::detail::call_async(boost::bind(&task_state_base::finish,
+                                           static_cast<task_state_base*>(m_state)));
+    }
+
+private:
+    task_state<R>* m_state;
+    F m_work;
+};
+
+} // namespace detail
+
+#endif
+
+/// @brief Result of the work that is called by ui::async()
+/// @details Task should be used from the UI thread only.
+/// Copies of task refer to the same work.
+/// @tparam R Type of the work result
+/// @ingroup thread
+
+template <class R>
+class task
+{
+    typedef detail::task_state<R> state_type;
+
+public:
+    /// Type of the continuation, it receives const R& or nothing if R is void
+    typedef typename state_type::handler_type handler_type;
+
+    /// Constructs empty task
+    task() : m_state(NULL) {}
+
+#ifndef DOXYGEN
+    explicit task(state_type* state) : m_state(state) { add_ref(); }
+#endif
+
+    task(const task& other) : m_state(other.m_state) { add_ref(); }
+
+    task& operator=(const task& other)
+    {
+        task(other).swap(*this);
+        return *this;
+    }
+
+    ~task()
+    {
+        if ( m_state )
+            m_state->release();
+    }
+
+    /// @brief Sets @a handler that is called in UI thread with the work result
+    /// @details Handler is called immediately if the result is already received.
+    /// If the work throws, the exception is rethrown in UI thread instead.
+    task& then_on_ui(const handler_type& handler)
+    {
+        if ( m_state )
+            m_state->then(handler);
+        return *this;
+    }
+
+    /// Returns true if the work result is received in UI thread
+    bool ready() const
+    {
+        return m_state && m_state->finished();
+    }
+
+    /// Exchanges tasks
+    void swap(task& other) BOOST_NOEXCEPT
+    {
+        state_type* state = m_state;
+        m_state = other.m_state;
+        other.m_state = state;
+    }
+
+private:
+    void add_ref()
+    {
+        if ( m_state )
+            m_state->add_ref();
+    }
+
+    state_type* m_state;
+};
+
+/// @brief Calls @a work in the @a pool and returns its task
+/// @details Function should be called from the UI thread.
+/// Usage example:
+/// @code
+/// ui::async(pool, load_file).then_on_ui(show_file);
+/// @endcode
+/// @ingroup thread
+
+template <class F>
+task<typename boost::result_of<F()>::type> async(thread_pool& pool, const F& work)
+{
+    typedef typename boost::result_of<F()>::type result_type;
+
+    detail::task_state<result_type>* state = new detail::task_state<result_type>;
+    task<result_type> result(state);
+
+    // Reference is released by task_state_base::finish() in UI thread
+    state->add_ref();
+    pool.post(detail::task_work<result_type, F>(state, work));
+
+    return result;
+}
+
+} // namespace ui
+} // namespace boost
+
+#endif // BOOST_UI_THREAD_POOL_HPP
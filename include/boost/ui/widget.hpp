@@ -126,6 +126,15 @@ public:
     /// Returns font
     ui::font font() const;
 
+    /// @brief Coalesces high-frequency events for handlers connected later
+    /// @details Resize, mouse move, mouse drag and mouse wheel handlers
+    /// that are connected after this call receive at most one event
+    /// per event loop iteration. Merged mouse event has the latest position
+    /// and keeps positions of the previous events in mouse_event::history(),
+    /// wheel deltas are summed. Pending merged events are delivered
+    /// before other events of the same widget, so the order is kept.
+    widget& coalesce_events(bool enable = true);
+
     ///@{ Connects widget resize handler
     BOOST_UI_DETAIL_HANDLER(resize, widget);
     ///@}
@@ -194,46 +203,47 @@ protected:
 
 private:
     void delete_last_detail_impl();
-
-    void on_resize_raw(const boost::function<void()>& hanlder);
-
-    void on_key_press_raw(const boost::function<void()>& handler);
-    void on_key_press_event_raw(const boost::function<void(key_event&)>& handler);
-    void on_key_down_raw(const boost::function<void()>& handler);
-    void on_key_down_event_raw(const boost::function<void(key_event&)>& handler);
-    void on_key_up_raw(const boost::function<void()>& handler);
-    void on_key_up_event_raw(const boost::function<void(key_event&)>& handler);
-
-    void on_left_mouse_down_raw(const boost::function<void()>& handler);
-    void on_left_mouse_down_event_raw(const boost::function<void(mouse_event&)>& handler);
-    void on_left_mouse_up_raw(const boost::function<void()>& handler);
-    void on_left_mouse_up_event_raw(const boost::function<void(mouse_event&)>& handler);
-    void on_right_mouse_down_raw(const boost::function<void()>& handler);
-    void on_right_mouse_down_event_raw(const boost::function<void(mouse_event&)>& handler);
-    void on_right_mouse_up_raw(const boost::function<void()>& handler);
-    void on_right_mouse_up_event_raw(const boost::function<void(mouse_event&)>& handler);
-    void on_middle_mouse_down_raw(const boost::function<void()>& handler);
-    void on_middle_mouse_down_event_raw(const boost::function<void(mouse_event&)>& handler);
-    void on_middle_mouse_up_raw(const boost::function<void()>& handler);
-    void on_middle_mouse_up_event_raw(const boost::function<void(mouse_event&)>& handler);
-    void on_left_mouse_double_click_raw(const boost::function<void()>& handler);
-    void on_left_mouse_double_click_event_raw(const boost::function<void(mouse_event&)>& handler);
-    void on_right_mouse_double_click_raw(const boost::function<void()>& handler);
-    void on_right_mouse_double_click_event_raw(const boost::function<void(mouse_event&)>& handler);
-    void on_middle_mouse_double_click_raw(const boost::function<void()>& handler);
-    void on_middle_mouse_double_click_event_raw(const boost::function<void(mouse_event&)>& handler);
-    void on_mouse_move_raw(const boost::function<void()>& handler);
-    void on_mouse_move_event_raw(const boost::function<void(mouse_event&)>& handler);
-    void on_mouse_drag_raw(const boost::function<void()>& handler);
-    void on_mouse_drag_event_raw(const boost::function<void(mouse_event&)>& handler);
-    void on_mouse_enter_raw(const boost::function<void()>& handler);
-    void on_mouse_enter_event_raw(const boost::function<void(mouse_event&)>& handler);
-    void on_mouse_leave_raw(const boost::function<void()>& handler);
-    void on_mouse_leave_event_raw(const boost::function<void(mouse_event&)>& handler);
-    void on_context_menu_raw(const boost::function<void()>& handler);
-    void on_context_menu_event_raw(const boost::function<void(mouse_event&)>& handler);
-    void on_mouse_wheel_raw(const boost::function<void()>& handler);
-    void on_mouse_wheel_event_raw(const boost::function<void(wheel_event&)>& handler);
+    bool coalescing() const;
+
+    connection on_resize_raw(const boost::function<void()>& hanlder, bool replace);
+
+    connection on_key_press_raw(const boost::function<void()>& handler, bool replace);
+    connection on_key_press_event_raw(const boost::function<void(key_event&)>& handler, bool replace);
+    connection on_key_down_raw(const boost::function<void()>& handler, bool replace);
+    connection on_key_down_event_raw(const boost::function<void(key_event&)>& handler, bool replace);
+    connection on_key_up_raw(const boost::function<void()>& handler, bool replace);
+    connection on_key_up_event_raw(const boost::function<void(key_event&)>& handler, bool replace);
+
+    connection on_left_mouse_down_raw(const boost::function<void()>& handler, bool replace);
+    connection on_left_mouse_down_event_raw(const boost::function<void(mouse_event&)>& handler, bool replace);
+    connection on_left_mouse_up_raw(const boost::function<void()>& handler, bool replace);
+    connection on_left_mouse_up_event_raw(const boost::function<void(mouse_event&)>& handler, bool replace);
+    connection on_right_mouse_down_raw(const boost::function<void()>& handler, bool replace);
+    connection on_right_mouse_down_event_raw(const boost::function<void(mouse_event&)>& handler, bool replace);
+    connection on_right_mouse_up_raw(const boost::function<void()>& handler, bool replace);
+    connection on_right_mouse_up_event_raw(const boost::function<void(mouse_event&)>& handler, bool replace);
+    connection on_middle_mouse_down_raw(const boost::function<void()>& handler, bool replace);
+    connection on_middle_mouse_down_event_raw(const boost::function<void(mouse_event&)>& handler, bool replace);
+    connection on_middle_mouse_up_raw(const boost::function<void()>& handler, bool replace);
+    connection on_middle_mouse_up_event_raw(const boost::function<void(mouse_event&)>& handler, bool replace);
+    connection on_left_mouse_double_click_raw(const boost::function<void()>& handler, bool replace);
+    connection on_left_mouse_double_click_event_raw(const boost::function<void(mouse_event&)>& handler, bool replace);
+    connection on_right_mouse_double_click_raw(const boost::function<void()>& handler, bool replace);
+    connection on_right_mouse_double_click_event_raw(const boost::function<void(mouse_event&)>& handler, bool replace);
+    connection on_middle_mouse_double_click_raw(const boost::function<void()>& handler, bool replace);
+    connection on_middle_mouse_double_click_event_raw(const boost::function<void(mouse_event&)>& handler, bool replace);
+    connection on_mouse_move_raw(const boost::function<void()>& handler, bool replace);
+    connection on_mouse_move_event_raw(const boost::function<void(mouse_event&)>& handler, bool replace);
+    connection on_mouse_drag_raw(const boost::function<void()>& handler, bool replace);
+    connection on_mouse_drag_event_raw(const boost::function<void(mouse_event&)>& handler, bool replace);
+    connection on_mouse_enter_raw(const boost::function<void()>& handler, bool replace);
+    connection on_mouse_enter_event_raw(const boost::function<void(mouse_event&)>& handler, bool replace);
+    connection on_mouse_leave_raw(const boost::function<void()>& handler, bool replace);
+    connection on_mouse_leave_event_raw(const boost::function<void(mouse_event&)>& handler, bool replace);
+    connection on_context_menu_raw(const boost::function<void()>& handler, bool replace);
+    connection on_context_menu_event_raw(const boost::function<void(mouse_event&)>& handler, bool replace);
+    connection on_mouse_wheel_raw(const boost::function<void()>& handler, bool replace);
+    connection on_mouse_wheel_event_raw(const boost::function<void(wheel_event&)>& handler, bool replace);
 
     detail::widget_detail_base* m_detail_impl;
     detail::shared_count m_shared_count;
@@ -38,7 +38,7 @@ private:
 
 #ifndef DOXYGEN
     template <class NativeEvent, class UIEvent>
-    friend class native::event_functor_event;
+    friend void native::init_event(UIEvent& uievent, NativeEvent& wxevent);
 #endif
 };
 
@@ -73,8 +73,8 @@ public:
     ///@}
 
 private:
-    void on_close_raw(const boost::function<void()>& handler);
-    void on_close_event_raw(const boost::function<void(close_event&)>& handler);
+    connection on_close_raw(const boost::function<void()>& handler, bool replace);
+    connection on_close_event_raw(const boost::function<void(close_event&)>& handler, bool replace);
 };
 } // namespace ui
 } // namespace boost
@@ -8,7 +8,9 @@
 #include <boost/ui/native/config.hpp>
 
 #include <boost/ui/application.hpp>
+#include <boost/ui/log.hpp>
 #include <boost/ui/string.hpp>
+#include <boost/ui/thread.hpp>
 #include <boost/ui/native/string.hpp>
 #include <boost/ui/detail/memcheck.hpp>
 
@@ -17,9 +19,13 @@
 
 #include <sstream>
 #include <map>
+#include <deque>
 
 #include <wx/app.h>
+#include <wx/evtloop.h>
 #include <wx/msgdlg.h>
+#include <wx/stopwatch.h>
+#include <wx/thread.h>
 #include <wx/timer.h>
 
 #include <boost/ui/native/winmain.cpp>
@@ -104,11 +110,12 @@ void show_exception(const char* where)
     show_exception_raw(ss.str(), "Unknown exception");
 }
 
-void safe_call(const boost::function<void()>& fn, const char* where)
+// Shows the exception that is being handled, called from a catch block
+void show_current_exception(const char* where)
 {
     try
     {
-        fn();
+        throw;
     }
     catch ( boost::exception& e )
     {
@@ -146,9 +153,158 @@ void safe_call(const boost::function<void()>& fn, const char* where)
     {
         show_exception(where);
     }
+}
 
+void safe_call(const boost::function<void()>& fn, const char* where)
+{
+    try
+    {
+        fn();
+    }
+    catch ( ... )
+    {
+        show_current_exception(where);
+    }
+}
+
+const char* const event_handler_where = " in a Boost.UI event handler";
+
+// Maximal duration of the normal and idle tasks in one loop iteration
+const long task_time_slice = 10; // milliseconds
+
+bool input_pending()
+{
+    wxEventLoopBase* loop = wxEventLoopBase::GetActive();
+    return loop && loop->Pending();
 }
 
+// Queues of the tasks posted by ui::post() and ui::on_idle()
+class task_scheduler
+{
+public:
+    typedef boost::function<void()> task_type;
+    typedef boost::function<bool()> idle_handler_type;
+
+    void post(boost::ui::task_priority priority, const task_type& fn)
+    {
+        wxCriticalSectionLocker locker(m_lock);
+        m_tasks[index(priority)].push_back(fn);
+    }
+
+    void on_idle(const idle_handler_type& fn)
+    {
+        wxCriticalSectionLocker locker(m_lock);
+        m_idle_handlers.push_back(fn);
+    }
+
+    // Calls the high priority tasks posted before the call
+    void run_high()
+    {
+        for ( std::size_t count = size(boost::ui::task_priority::high); count; count-- )
+        {
+            if ( !run_task(boost::ui::task_priority::high) )
+                break;
+        }
+    }
+
+    // Calls the normal priority tasks until the user input or the time slice end
+    void run_normal()
+    {
+        const wxStopWatch sw;
+        for ( std::size_t count = size(boost::ui::task_priority::normal); count; count-- )
+        {
+            if ( sw.Time() >= task_time_slice || input_pending() )
+                break;
+
+            if ( !run_task(boost::ui::task_priority::normal) )
+                break;
+        }
+    }
+
+    // Calls the idle tasks and chunks of the idle handlers
+    // until the user input or the time slice end
+    void run_idle()
+    {
+        const wxStopWatch sw;
+        while ( sw.Time() < task_time_slice && !input_pending() )
+        {
+            if ( run_task(boost::ui::task_priority::idle) )
+                continue;
+
+            if ( !run_idle_handler() )
+                break;
+        }
+    }
+
+    bool empty()
+    {
+        wxCriticalSectionLocker locker(m_lock);
+        for ( std::size_t i = 0; i < priorities_count; i++ )
+        {
+            if ( !m_tasks[i].empty() )
+                return false;
+        }
+        return m_idle_handlers.empty();
+    }
+
+private:
+    static std::size_t index(boost::ui::task_priority priority)
+    {
+        return static_cast<std::size_t>(boost::native_value(priority));
+    }
+
+    std::size_t size(boost::ui::task_priority priority)
+    {
+        wxCriticalSectionLocker locker(m_lock);
+        return m_tasks[index(priority)].size();
+    }
+
+    bool run_task(boost::ui::task_priority priority)
+    {
+        task_type fn;
+        {
+            wxCriticalSectionLocker locker(m_lock);
+            std::deque<task_type>& tasks = m_tasks[index(priority)];
+            if ( tasks.empty() )
+                return false;
+
+            fn.swap(tasks.front());
+            tasks.pop_front();
+        }
+
+        fn();
+        return true;
+    }
+
+    // Handlers are called in turn, finished handler is removed
+    bool run_idle_handler()
+    {
+        idle_handler_type fn;
+        {
+            wxCriticalSectionLocker locker(m_lock);
+            if ( m_idle_handlers.empty() )
+                return false;
+
+            fn.swap(m_idle_handlers.front());
+            m_idle_handlers.pop_front();
+        }
+
+        if ( fn() )
+        {
+            wxCriticalSectionLocker locker(m_lock);
+            m_idle_handlers.push_back(idle_handler_type());
+            m_idle_handlers.back().swap(fn);
+        }
+        return true;
+    }
+
+    BOOST_STATIC_CONSTANT(std::size_t, priorities_count = 3);
+
+    wxCriticalSection m_lock;
+    std::deque<task_type> m_tasks[priorities_count];
+    std::deque<idle_handler_type> m_idle_handlers;
+};
+
 } // unnamed namespace
 
 class boost_ui_app : public wxApp
@@ -157,6 +313,7 @@ class boost_ui_app : public wxApp
     typedef wxApp        base_type;
 
 public:
+    boost_ui_app() : m_async_calls(false) {}
     virtual ~boost_ui_app();
     virtual bool OnInit() wxOVERRIDE;
     virtual int OnRun() wxOVERRIDE;
@@ -168,13 +325,26 @@ public:
     }
 #endif
 
+#if wxUSE_EXCEPTIONS
+    virtual bool OnExceptionInMainLoop() wxOVERRIDE;
+#else
     virtual void CallEventHandler(wxEvtHandler* handler,
                                   wxEventFunctor& functor,
                                   wxEvent& event) const wxOVERRIDE;
+#endif
+
+    virtual void ProcessPendingEvents() wxOVERRIDE;
+    virtual bool ProcessIdle() wxOVERRIDE;
 
     void on_timeout(int milliseconds, const boost::function<void()>& fn);
 
+    void post(boost::ui::task_priority priority, const boost::function<void()>& fn);
+    void on_idle(const boost::function<bool()>& fn);
+
 private:
+    task_scheduler m_scheduler;
+    bool m_async_calls; // Some ui::call_async() calls aren't called yet
+
 #if wxUSE_TIMER
     void on_timer(wxTimerEvent& event);
 
@@ -183,13 +353,6 @@ private:
 #endif
 
     void OnRunHere(int &result);
-
-    void CallEventHandlerBase(wxEvtHandler* handler,
-                              wxEventFunctor& functor,
-                              wxEvent& event) const
-    {
-        base_type::CallEventHandler(handler, functor, event);
-    }
 };
 
 boost_ui_app::~boost_ui_app()
@@ -225,16 +388,107 @@ int boost_ui_app::OnRun()
     safe_call(boost::bind(&this_type::OnRunHere, this,
                           boost::ref(result)),
               " in the main Boost.UI function, terminating");
+
+    // Counts of messages suppressed before exit aren't lost
+    boost::ui::log::flush_suppressed();
     return result;
 }
 
+// Event handlers are called without a per handler exception guard.
+// Exceptions are caught once per dispatched native event by wxWidgets,
+// that calls OnExceptionInMainLoop(), and once per loop iteration
+// for every stage of pending and idle processing: high priority tasks,
+// async calls, pending events, normal priority tasks, idle events and idle tasks.
+// So an exception skips the rest of its stage only, but a throwing handler
+// also skips the remaining handlers of the same event.
+// If wxWidgets is built without exceptions support, it doesn't catch them
+// and every handler is guarded by CallEventHandler().
+
+#if wxUSE_EXCEPTIONS
+bool boost_ui_app::OnExceptionInMainLoop()
+{
+    show_current_exception(event_handler_where);
+    return true; // Continue the main loop
+}
+#else
 void boost_ui_app::CallEventHandler(wxEvtHandler* handler,
                                     wxEventFunctor& functor,
                                     wxEvent& event) const
 {
-    safe_call(boost::bind(&this_type::CallEventHandlerBase, this,
-                          handler, boost::ref(functor), boost::ref(event)),
-              " in a Boost.UI event handler");
+    try
+    {
+        base_type::CallEventHandler(handler, functor, event);
+    }
+    catch ( ... )
+    {
+        show_current_exception(event_handler_where);
+    }
+}
+#endif
+
+void boost_ui_app::ProcessPendingEvents()
+{
+    try
+    {
+        m_scheduler.run_high();
+    }
+    catch ( ... )
+    {
+        show_current_exception(event_handler_where);
+    }
+
+    try
+    {
+        m_async_calls = true; // Calls remain if a call throws
+        m_async_calls = boost::ui::detail::process_async_calls();
+    }
+    catch ( ... )
+    {
+        show_current_exception(event_handler_where);
+    }
+
+    try
+    {
+        base_type::ProcessPendingEvents();
+    }
+    catch ( ... )
+    {
+        show_current_exception(event_handler_where);
+    }
+
+    try
+    {
+        m_scheduler.run_normal();
+    }
+    catch ( ... )
+    {
+        show_current_exception(event_handler_where);
+    }
+}
+
+bool boost_ui_app::ProcessIdle()
+{
+    bool more = false;
+    try
+    {
+        more = base_type::ProcessIdle();
+    }
+    catch ( ... )
+    {
+        show_current_exception(event_handler_where);
+    }
+
+    try
+    {
+        m_scheduler.run_idle();
+    }
+    catch ( ... )
+    {
+        show_current_exception(event_handler_where);
+    }
+
+    // Remaining tasks are called in the next idle time
+    return more || m_async_calls || !m_scheduler.empty();
 }
 
 void boost_ui_app::on_timeout(int milliseconds, const boost::function<void()>& fn)
@@ -251,6 +505,19 @@ void boost_ui_app::on_timeout(int milliseconds, const boost::function<void()>& f
 #endif
 }
 
+void boost_ui_app::post(boost::ui::task_priority priority,
+                        const boost::function<void()>& fn)
+{
+    m_scheduler.post(priority, fn);
+    wxWakeUpIdle();
+}
+
+void boost_ui_app::on_idle(const boost::function<bool()>& fn)
+{
+    m_scheduler.on_idle(fn);
+    wxWakeUpIdle();
+}
+
 #if wxUSE_TIMER
 void boost_ui_app::on_timer(wxTimerEvent& event)
 {
@@ -335,6 +602,31 @@ void on_timeout(int milliseconds, const boost::function<void()>& fn)
     wxGetApp().on_timeout(milliseconds, fn);
 }
 
+void post(task_priority priority, const boost::function<void()>& fn)
+{
+    if ( wxApp::GetInstance() )
+    {
+        wxGetApp().post(priority, fn);
+        return;
+    }
+
+    wxFAIL;
+    fn();
+}
+
+void on_idle(const boost::function<bool()>& fn)
+{
+    if ( wxApp::GetInstance() )
+    {
+        wxGetApp().on_idle(fn);
+        return;
+    }
+
+    wxFAIL;
+    while ( fn() )
+        ;
+}
+
 void sleep_for_milliseconds(unsigned long milliseconds)
 {
     wxMilliSleep(milliseconds);
@@ -0,0 +1,588 @@
+// Copyright (c) 2018 Kolya Kosenko
+
+// Distributed under the Boost Software License, Version 1.0.
+// See http://www.boost.org/LICENSE_1_0.txt
+
+#define BOOST_UI_SOURCE
+
+#include <boost/ui/native/config.hpp>
+
+#include <boost/ui/async_log.hpp>
+#include <boost/ui/native/string.hpp>
+#include <boost/ui/detail/memcheck.hpp>
+
+#include <boost/throw_exception.hpp>
+
+#include <wx/thread.h>
+#include <wx/ffile.h>
+#include <wx/datetime.h>
+#include <wx/time.h>
+#include <wx/log.h>
+
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept> // std::runtime_error
+
+#ifndef BOOST_NO_CXX11_HDR_ATOMIC
+#include <atomic>
+#endif
+
+namespace boost {
+namespace ui    {
+
+namespace {
+
+const char* level_name(log_level level)
+{
+    switch ( boost::native_value(level) )
+    {
+        case log_level::fatal:   return "fatal";
+        case log_level::error:   return "error";
+        case log_level::warning: return "warning";
+        case log_level::info:    return "info";
+        case log_level::verbose: return "verbose";
+        case log_level::debug:   return "debug";
+        case log_level::trace:   return "trace";
+    }
+    return "";
+}
+
+// Formats record as "YYYY-MM-DD HH:MM:SS.mmm [level] message\n" in UTF-8
+void format_record(const log_record& record, std::string& result)
+{
+    const wxDateTime time = wxDateTime(wxLongLong(record.time));
+    result = time.Format(wxS("%Y-%m-%d %H:%M:%S.%l"), wxDateTime::UTC).ToStdString();
+    result += " [";
+    result += level_name(record.level);
+    result += "] ";
+    result += record.message.u8string();
+    result += '\n';
+}
+
+void move_record(log_record& from, log_record& to)
+{
+    to.level = from.level;
+    to.time = from.time;
+    to.message.swap(from.message);
+    from.message.clear();
+}
+
+// Value that is shared between threads
+class shared_value
+{
+public:
+    explicit shared_value(boost::uint64_t value = 0) : m_value(value) {}
+
+#ifndef BOOST_NO_CXX11_HDR_ATOMIC
+    boost::uint64_t load() const { return m_value.load(); }
+    void store(boost::uint64_t value) { m_value.store(value); }
+    boost::uint64_t exchange(boost::uint64_t value) { return m_value.exchange(value); }
+    boost::uint64_t add(boost::uint64_t value = 1) { return m_value.fetch_add(value) + value; }
+    boost::uint64_t sub(boost::uint64_t value = 1) { return m_value.fetch_sub(value) - value; }
+
+private:
+    std::atomic<boost::uint64_t> m_value;
+#else
+    boost::uint64_t load() const
+    {
+        wxCriticalSectionLocker locker(m_lock);
+        return m_value;
+    }
+    void store(boost::uint64_t value)
+    {
+        wxCriticalSectionLocker locker(m_lock);
+        m_value = value;
+    }
+    boost::uint64_t exchange(boost::uint64_t value)
+    {
+        wxCriticalSectionLocker locker(m_lock);
+        std::swap(m_value, value);
+        return value;
+    }
+    boost::uint64_t add(boost::uint64_t value = 1)
+    {
+        wxCriticalSectionLocker locker(m_lock);
+        return m_value += value;
+    }
+    boost::uint64_t sub(boost::uint64_t value = 1)
+    {
+        wxCriticalSectionLocker locker(m_lock);
+        return m_value -= value;
+    }
+
+private:
+    mutable wxCriticalSection m_lock;
+    boost::uint64_t m_value;
+#endif
+};
+
+// Bounded multiple producers single consumer queue.
+// Each cell has sequence number that shows whether the cell
+// is ready for writing by the producer or for reading by the consumer.
+// See http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+class record_queue
+{
+public:
+    explicit record_queue(std::size_t capacity)
+        : m_cells(capacity), m_mask(capacity - 1)
+    {
+#ifndef BOOST_NO_CXX11_HDR_ATOMIC
+        for ( std::size_t i = 0; i < capacity; i++ )
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        m_dequeue.value = 0;
+        m_enqueue.value.store(0, std::memory_order_relaxed);
+#else
+        m_dequeue = 0;
+        m_size = 0;
+#endif
+    }
+
+    // Moves record into the queue, returns false if the queue is full
+    bool push(log_record& record)
+    {
+#ifndef BOOST_NO_CXX11_HDR_ATOMIC
+        std::size_t pos = m_enqueue.value.load(std::memory_order_relaxed);
+        for ( ;; )
+        {
+            cell& c = m_cells[pos & m_mask];
+            const std::size_t sequence = c.sequence.load(std::memory_order_acquire);
+            const std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence - pos);
+            if ( diff == 0 )
+            {
+                if ( m_enqueue.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed) )
+                {
+                    move_record(record, c.record);
+                    c.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if ( diff < 0 )
+                return false;
+            else
+                pos = m_enqueue.value.load(std::memory_order_relaxed);
+        }
+#else
+        wxCriticalSectionLocker locker(m_lock);
+        if ( m_size == m_cells.size() )
+            return false;
+
+        move_record(record, m_cells[( m_dequeue + m_size ) & m_mask].record);
+        m_size++;
+        return true;
+#endif
+    }
+
+    // Moves record from the queue, returns false if the queue is empty.
+    // Should be called from the single consumer thread.
+    bool pop(log_record& record)
+    {
+#ifndef BOOST_NO_CXX11_HDR_ATOMIC
+        std::size_t& pos = m_dequeue.value;
+        cell& c = m_cells[pos & m_mask];
+        if ( c.sequence.load(std::memory_order_acquire) != pos + 1 )
+            return false;
+
+        move_record(c.record, record);
+        c.sequence.store(pos + m_mask + 1, std::memory_order_release);
+        pos++;
+        return true;
+#else
+        wxCriticalSectionLocker locker(m_lock);
+        if ( m_size == 0 )
+            return false;
+
+        move_record(m_cells[m_dequeue & m_mask].record, record);
+        m_dequeue++;
+        m_size--;
+        return true;
+#endif
+    }
+
+    // Checks whether the queue has record for the consumer
+    bool ready() const
+    {
+#ifndef BOOST_NO_CXX11_HDR_ATOMIC
+        const std::size_t pos = m_dequeue.value;
+        return m_cells[pos & m_mask].sequence.load() == pos + 1;
+#else
+        wxCriticalSectionLocker locker(m_lock);
+        return m_size != 0;
+#endif
+    }
+
+private:
+    struct cell
+    {
+#ifndef BOOST_NO_CXX11_HDR_ATOMIC
+        std::atomic<std::size_t> sequence;
+#endif
+        log_record record;
+    };
+
+    // Value is padded on both sides, so it doesn't share the cache line
+    // with other data even if the queue is allocated without extended alignment
+    template <class T>
+    struct padded
+    {
+        char before[64];
+        T value;
+        char after[64];
+    };
+
+    std::vector<cell> m_cells;
+    const std::size_t m_mask;
+
+#ifndef BOOST_NO_CXX11_HDR_ATOMIC
+    // Producers and consumer positions are on different cache lines
+    padded<std::size_t> m_dequeue;
+    padded< std::atomic<std::size_t> > m_enqueue;
+#else
+    std::size_t m_dequeue;
+    mutable wxCriticalSection m_lock;
+    std::size_t m_size;
+#endif
+};
+
+std::size_t round_up_power_of_2(std::size_t value)
+{
+    std::size_t result = 2;
+    while ( result < value )
+        result *= 2;
+    return result;
+}
+
+#ifndef BOOST_NO_CXX11_HDR_ATOMIC
+std::atomic<async_log*> g_installed(NULL);
+#else
+async_log* volatile g_installed = NULL;
+#endif
+
+} // unnamed namespace
+
+class async_log::detail_impl : public wxThread, private detail::memcheck
+{
+public:
+    detail_impl(std::size_t capacity, log_overflow overflow, unsigned sample_rate)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_queue(round_up_power_of_2(capacity)),
+          m_overflow(overflow),
+          m_sample_rate(std::max(sample_rate, 1u)),
+          m_flushed(m_flush_lock)
+    {}
+
+    ~detail_impl()
+    {
+        for ( std::vector<log_sink*>::iterator iter = m_sinks.begin();
+              iter != m_sinks.end(); ++iter )
+            delete *iter;
+    }
+
+    void wakeup()
+    {
+        if ( m_sleeping.exchange(0) )
+            m_wakeup.Post();
+    }
+
+    record_queue m_queue;
+    const log_overflow m_overflow;
+    const unsigned m_sample_rate;
+
+    shared_value m_pushed;
+    shared_value m_written;
+    shared_value m_dropped;
+    shared_value m_overflows;
+    shared_value m_sleeping;
+    shared_value m_stop;
+    wxSemaphore m_wakeup;
+
+    // Signalled after records are written if flush() waits for them
+    shared_value m_flushing;
+    wxMutex m_flush_lock;
+    wxCondition m_flushed;
+
+    wxCriticalSection m_sinks_lock;
+    std::vector<log_sink*> m_sinks;
+
+protected:
+    virtual ExitCode Entry() wxOVERRIDE
+    {
+        enum { batch_size = 256 };
+        std::vector<log_record> batch(batch_size);
+        bool written = false;
+        for ( ;; )
+        {
+            std::size_t count = 0;
+            while ( count < batch_size && m_queue.pop(batch[count]) )
+                count++;
+
+            if ( count != 0 )
+            {
+                write(&batch[0], count);
+                m_written.add(count);
+                if ( m_flushing.load() )
+                {
+                    wxMutexLocker locker(m_flush_lock);
+                    m_flushed.Broadcast();
+                }
+                for ( std::size_t i = 0; i < count; i++ )
+                    batch[i].message.clear();
+                written = true;
+                continue;
+            }
+
+            if ( written )
+            {
+                flush_sinks();
+                written = false;
+            }
+            if ( m_stop.load() )
+                break;
+
+            // Producers post the semaphore if the consumer is sleeping
+            m_sleeping.store(1);
+            if ( !m_queue.ready() && !m_stop.load() )
+                m_wakeup.WaitTimeout(100);
+            m_sleeping.store(0);
+        }
+        return 0;
+    }
+
+private:
+    void write(const log_record* records, std::size_t count)
+    {
+        wxCriticalSectionLocker locker(m_sinks_lock);
+        for ( std::vector<log_sink*>::iterator iter = m_sinks.begin();
+              iter != m_sinks.end(); ++iter )
+        {
+            try
+            {
+                (*iter)->write(records, count);
+            }
+            catch(...)
+            {
+                // Sink errors can't be reported by logging
+            }
+        }
+    }
+
+    void flush_sinks()
+    {
+        wxCriticalSectionLocker locker(m_sinks_lock);
+        for ( std::vector<log_sink*>::iterator iter = m_sinks.begin();
+              iter != m_sinks.end(); ++iter )
+        {
+            try
+            {
+                (*iter)->flush();
+            }
+            catch(...)
+            {
+            }
+        }
+    }
+};
+
+async_log::async_log(std::size_t capacity, log_overflow overflow, unsigned sample_rate)
+    : m_impl(new detail_impl(capacity, overflow, sample_rate))
+{
+    if ( m_impl->Run() != wxTHREAD_NO_ERROR )
+    {
+        delete m_impl;
+        BOOST_THROW_EXCEPTION(std::runtime_error("ui::async_log: unable to run thread"));
+    }
+}
+
+async_log::~async_log()
+{
+    if ( installed() == this )
+    {
+        log::flush_suppressed();
+        install(NULL);
+    }
+
+    m_impl->m_stop.store(1);
+    m_impl->m_wakeup.Post();
+    m_impl->Wait();
+
+    delete m_impl;
+}
+
+void async_log::add_sink(log_sink* sink)
+{
+    wxCHECK_RET(sink, "Invalid sink");
+
+    wxCriticalSectionLocker locker(m_impl->m_sinks_lock);
+    m_impl->m_sinks.push_back(sink);
+}
+
+bool async_log::push(log_level level, const uistring& message)
+{
+    log_record record;
+    record.level = level;
+    record.message = message;
+    return push_record(record);
+}
+
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+
+bool async_log::push(log_level level, uistring&& message)
+{
+    log_record record;
+    record.level = level;
+    record.message.swap(message);
+    return push_record(record);
+}
+
+#endif
+
+bool async_log::push_record(log_record& record)
+{
+    record.time = wxGetUTCTimeMillis().GetValue();
+
+    if ( !m_impl->m_queue.push(record) )
+    {
+        switch ( boost::native_value(m_impl->m_overflow) )
+        {
+            case log_overflow::sample:
+                if ( m_impl->m_overflows.add() % m_impl->m_sample_rate != 0 )
+                {
+                    m_impl->m_dropped.add();
+                    return false;
+                }
+                // Sampled record waits like in the block mode
+                // Falls through
+            case log_overflow::block:
+                do
+                {
+                    m_impl->wakeup();
+                    wxThread::Yield();
+                }
+                while ( !m_impl->m_queue.push(record) );
+                break;
+
+            default:
+                m_impl->m_dropped.add();
+                return false;
+        }
+    }
+
+    m_impl->m_pushed.add();
+    m_impl->wakeup();
+    return true;
+}
+
+void async_log::flush()
+{
+    const boost::uint64_t pushed = m_impl->m_pushed.load();
+    if ( m_impl->m_written.load() >= pushed )
+        return;
+
+    // Writer thread checks m_flushing after m_written is increased,
+    // so the signal isn't lost between the check and the wait
+    wxMutexLocker locker(m_impl->m_flush_lock);
+    m_impl->m_flushing.add();
+    while ( m_impl->m_written.load() < pushed )
+    {
+        m_impl->wakeup();
+        m_impl->m_flushed.Wait();
+    }
+    m_impl->m_flushing.sub();
+}
+
+boost::uint64_t async_log::dropped() const
+{
+    return m_impl->m_dropped.load();
+}
+
+void async_log::install(async_log* backend)
+{
+    g_installed = backend;
+}
+
+async_log* async_log::installed()
+{
+    return g_installed;
+}
+
+class file_log_sink::detail_impl : public wxFFile, private detail::memcheck
+{
+public:
+    std::string m_line;
+};
+
+file_log_sink::file_log_sink(const uistring& path) : m_impl(new detail_impl)
+{
+    if ( !m_impl->Open(native::from_uistring(path), "ab") )
+    {
+        delete m_impl;
+        BOOST_THROW_EXCEPTION(std::runtime_error("ui::file_log_sink: unable to open file"));
+    }
+}
+
+file_log_sink::~file_log_sink()
+{
+    delete m_impl;
+}
+
+void file_log_sink::write(const log_record* records, std::size_t count)
+{
+    for ( std::size_t i = 0; i < count; i++ )
+    {
+        format_record(records[i], m_impl->m_line);
+        m_impl->Write(m_impl->m_line.data(), m_impl->m_line.size());
+    }
+}
+
+void file_log_sink::flush()
+{
+    m_impl->Flush();
+}
+
+void stderr_log_sink::write(const log_record* records, std::size_t count)
+{
+    std::string line;
+    for ( std::size_t i = 0; i < count; i++ )
+    {
+        format_record(records[i], line);
+        std::fwrite(line.data(), 1, line.size(), stderr);
+    }
+}
+
+void stderr_log_sink::flush()
+{
+    std::fflush(stderr);
+}
+
+void native_log_sink::write(const log_record* records, std::size_t count)
+{
+    for ( std::size_t i = 0; i < count; i++ )
+    {
+        const wxString message = native::from_uistring(records[i].message);
+        switch ( boost::native_value(records[i].level) )
+        {
+            case log_level::fatal: // Application isn't terminated from the log thread
+            case log_level::error:
+                wxLogError(wxS("%s"), message);
+                break;
+            case log_level::warning:
+                wxLogWarning(wxS("%s"), message);
+                break;
+            case log_level::info:
+                wxLogMessage(wxS("%s"), message);
+                break;
+            case log_level::verbose:
+                wxLogVerbose(wxS("%s"), message);
+                break;
+            case log_level::debug:
+                wxLogDebug(wxS("%s"), message);
+                break;
+            case log_level::trace:
+                wxLogTrace(wxS("%s"), message);
+                break;
+        }
+    }
+}
+
+} // namespace ui
+} // namespace boost
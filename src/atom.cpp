@@ -0,0 +1,181 @@
+// Copyright (c) 2018 Kolya Kosenko
+
+// Distributed under the Boost Software License, Version 1.0.
+// See http://www.boost.org/LICENSE_1_0.txt
+
+#define BOOST_UI_SOURCE
+
+#include <boost/ui/native/config.hpp>
+
+#include <boost/ui/atom.hpp>
+#include <boost/ui/detail/memcheck.hpp>
+
+#include <wx/thread.h>
+
+#include <map>
+
+#ifndef BOOST_NO_CXX11_HDR_ATOMIC
+#include <atomic>
+#endif
+
+namespace boost {
+namespace ui    {
+
+class atom::entry : private detail::memcheck
+{
+public:
+    entry(const uistring& value, std::size_t hash)
+        : m_value(value), m_hash(hash), m_refs(1) {}
+
+    const uistring m_value;
+    const std::size_t m_hash;
+#ifndef BOOST_NO_CXX11_HDR_ATOMIC
+    std::atomic<std::size_t> m_refs;
+#else
+    std::size_t m_refs; // Guarded by the table lock
+#endif
+};
+
+// Atoms are found by string hash and then compared by value
+class atom::table
+{
+public:
+    typedef std::multimap<std::size_t, entry*> map_type;
+    typedef map_type::iterator iterator;
+
+    wxCriticalSection m_lock;
+    map_type m_entries;
+
+    // Table is never destroyed to outlive atoms with static storage duration
+    static table& instance()
+    {
+        static table* result = new table;
+        return *result;
+    }
+};
+
+atom::atom(const uistring& str)
+{
+    intern(str);
+}
+
+#ifndef BOOST_UI_NO_CAST_FROM_ASCII
+
+atom::atom(const char* str)
+{
+    intern(str);
+}
+
+#endif
+
+atom::atom(const wchar_t* str)
+{
+    intern(str);
+}
+
+void atom::intern(const uistring& str)
+{
+    if ( str.empty() )
+    {
+        m_entry = NULL;
+        return;
+    }
+
+    const std::size_t hash = hash_value(str);
+    table& atoms = table::instance();
+
+    wxCriticalSectionLocker locker(atoms.m_lock);
+
+    const std::pair<table::iterator, table::iterator> range = atoms.m_entries.equal_range(hash);
+    for ( table::iterator iter = range.first; iter != range.second; ++iter )
+    {
+        if ( iter->second->m_value == str )
+        {
+            m_entry = iter->second;
+            ++m_entry->m_refs;
+            return;
+        }
+    }
+
+    m_entry = new entry(str, hash);
+    atoms.m_entries.insert(range.second, std::make_pair(hash, m_entry));
+}
+
+atom::atom(const atom& other) BOOST_NOEXCEPT : m_entry(other.m_entry)
+{
+    if ( !m_entry )
+        return;
+
+#ifndef BOOST_NO_CXX11_HDR_ATOMIC
+    // Other atom holds the reference, so the entry can't be removed
+    m_entry->m_refs.fetch_add(1, std::memory_order_relaxed);
+#else
+    wxCriticalSectionLocker locker(table::instance().m_lock);
+    ++m_entry->m_refs;
+#endif
+}
+
+atom& atom::operator=(const atom& other) BOOST_NOEXCEPT
+{
+    atom(other).swap(*this);
+    return *this;
+}
+
+atom::~atom()
+{
+    if ( !m_entry )
+        return;
+
+#ifndef BOOST_NO_CXX11_HDR_ATOMIC
+    // Last reference is released under the lock,
+    // so the entry can't be found by intern() concurrently
+    std::size_t refs = m_entry->m_refs.load(std::memory_order_relaxed);
+    while ( refs > 1 )
+    {
+        if ( m_entry->m_refs.compare_exchange_weak(refs, refs - 1,
+                                                   std::memory_order_release,
+                                                   std::memory_order_relaxed) )
+            return;
+    }
+#endif
+
+    table& atoms = table::instance();
+    wxCriticalSectionLocker locker(atoms.m_lock);
+
+    if ( --m_entry->m_refs != 0 )
+        return;
+
+    const std::pair<table::iterator, table::iterator> range = atoms.m_entries.equal_range(m_entry->m_hash);
+    for ( table::iterator iter = range.first; iter != range.second; ++iter )
+    {
+        if ( iter->second == m_entry )
+        {
+            atoms.m_entries.erase(iter);
+            break;
+        }
+    }
+
+    delete m_entry;
+}
+
+const uistring& atom::str() const BOOST_NOEXCEPT
+{
+    static const uistring empty_string;
+    return m_entry ? m_entry->m_value : empty_string;
+}
+
+std::size_t atom::hash() const BOOST_NOEXCEPT
+{
+    static const std::size_t empty_hash = hash_value(uistring());
+    return m_entry ? m_entry->m_hash : empty_hash;
+}
+
+std::size_t atom::table_size()
+{
+    table& atoms = table::instance();
+    wxCriticalSectionLocker locker(atoms.m_lock);
+    return atoms.m_entries.size();
+}
+
+} // namespace ui
+} // namespace boost
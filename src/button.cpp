@@ -39,10 +39,12 @@ button& button::create(widget& parent, const uistring& label)
     return *this;
 }
 
-void button::on_press_raw(const boost::function<void()>& handler)
+connection button::on_press_raw(const boost::function<void()>& handler, bool replace)
 {
 #if wxUSE_BUTTON
-    native::bind_helper(*this, wxEVT_BUTTON, handler);
+    return native::bind_helper(*this, wxEVT_BUTTON, handler, replace);
+#else
+    return connection();
 #endif
 }
 
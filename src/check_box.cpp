@@ -146,10 +146,12 @@ bool check_box_base::is_indeterminate() const
 #endif
 }
 
-void check_box_base::on_toggle_raw(const boost::function<void()>& handler)
+connection check_box_base::on_toggle_raw(const boost::function<void()>& handler, bool replace)
 {
 #if wxUSE_CHECKBOX
-    native::bind_helper(*this, wxEVT_CHECKBOX, handler);
+    return native::bind_helper(*this, wxEVT_CHECKBOX, handler, replace);
+#else
+    return connection();
 #endif
 }
 
@@ -108,17 +108,21 @@ index_type choice::current_selection_index() const
 #endif
 }
 
-void choice::on_select_raw(const boost::function<void()>& handler)
+connection choice::on_select_raw(const boost::function<void()>& handler, bool replace)
 {
 #if wxUSE_CHOICE
-    native::bind_helper(*this, wxEVT_CHOICE, handler);
+    return native::bind_helper(*this, wxEVT_CHOICE, handler, replace);
+#else
+    return connection();
 #endif
 }
 
-void choice::on_select_event_raw(const boost::function<void(index_event&)>& handler)
+connection choice::on_select_event_raw(const boost::function<void(index_event&)>& handler, bool replace)
 {
 #if wxUSE_CHOICE
-    native::bind_event_helper(*this, wxEVT_CHOICE, handler);
+    return native::bind_event_helper(*this, wxEVT_CHOICE, handler, replace);
+#else
+    return connection();
 #endif
 }
 
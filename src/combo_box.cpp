@@ -110,17 +110,21 @@ uistring combo_box::text() const
 #endif
 }
 
-void combo_box::on_select_raw(const boost::function<void()>& handler)
+connection combo_box::on_select_raw(const boost::function<void()>& handler, bool replace)
 {
 #if wxUSE_COMBOBOX
-    native::bind_helper(*this, wxEVT_COMBOBOX, handler);
+    return native::bind_helper(*this, wxEVT_COMBOBOX, handler, replace);
+#else
+    return connection();
 #endif
 }
 
-void combo_box::on_select_event_raw(const boost::function<void(index_event&)>& handler)
+connection combo_box::on_select_event_raw(const boost::function<void(index_event&)>& handler, bool replace)
 {
 #if wxUSE_COMBOBOX
-    native::bind_event_helper(*this, wxEVT_COMBOBOX, handler);
+    return native::bind_event_helper(*this, wxEVT_COMBOBOX, handler, replace);
+#else
+    return connection();
 #endif
 }
 
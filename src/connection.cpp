@@ -0,0 +1,175 @@
+// Copyright (c) 2018 Kolya Kosenko
+
+// Distributed under the Boost Software License, Version 1.0.
+// See http://www.boost.org/LICENSE_1_0.txt
+
+#define BOOST_UI_SOURCE
+
+#include <boost/ui/native/config.hpp>
+
+#include <boost/ui/connection.hpp>
+
+#include <algorithm> // std::find
+#include <map>
+#include <vector>
+
+namespace boost  {
+namespace ui     {
+namespace detail {
+
+namespace {
+
+// Connections of every event source
+typedef std::multimap<const void*, connection_state*> registry_type;
+
+registry_type& get_registry()
+{
+    static registry_type registry;
+    return registry;
+}
+
+// Handlers with pending coalesced events in the order of scheduling
+typedef std::vector<connection_state*> pending_type;
+
+pending_type& get_pending()
+{
+    static pending_type pending;
+    return pending;
+}
+
+} // unnamed namespace
+
+connection_state::~connection_state()
+{
+    unregister_source();
+}
+
+void connection_state::disconnect()
+{
+    if ( !m_connected )
+        return;
+
+    m_connected = false;
+    unregister_source();
+
+    // Event source could release last reference
+    add_ref();
+    do_disconnect();
+    release();
+}
+
+void connection_state::detach()
+{
+    m_connected = false;
+    unregister_source();
+}
+
+void connection_state::register_source(const void* source, int type, const void* key)
+{
+    unregister_source();
+
+    m_source = source;
+    m_type = type;
+    m_key = key;
+
+    get_registry().insert(registry_type::value_type(source, this));
+}
+
+void connection_state::unregister_source()
+{
+    remove_pending();
+
+    if ( !m_source )
+        return;
+
+    registry_type& registry = get_registry();
+    const std::pair<registry_type::iterator, registry_type::iterator>
+        range = registry.equal_range(m_source);
+    for ( registry_type::iterator iter = range.first; iter != range.second; ++iter )
+    {
+        if ( iter->second == this )
+        {
+            registry.erase(iter);
+            break;
+        }
+    }
+
+    m_source = NULL;
+}
+
+void connection_state::disconnect_all(const void* source, int type, const void* key)
+{
+    // Handlers are disconnected after search because registry is modified
+    std::vector<connection_state*> states;
+
+    const std::pair<registry_type::iterator, registry_type::iterator>
+        range = get_registry().equal_range(source);
+    for ( registry_type::iterator iter = range.first; iter != range.second; ++iter )
+    {
+        connection_state* state = iter->second;
+        if ( state->m_type == type && state->m_key == key )
+        {
+            state->add_ref();
+            states.push_back(state);
+        }
+    }
+
+    for ( std::vector<connection_state*>::iterator iter = states.begin();
+          iter != states.end(); ++iter )
+    {
+        (*iter)->disconnect();
+        (*iter)->release();
+    }
+}
+
+void connection_state::add_pending()
+{
+    get_pending().push_back(this);
+}
+
+void connection_state::remove_pending()
+{
+    pending_type& pending = get_pending();
+    pending_type::iterator iter = std::find(pending.begin(), pending.end(), this);
+    if ( iter != pending.end() )
+        pending.erase(iter);
+}
+
+void connection_state::deliver_pending(const void* source)
+{
+    pending_type& pending = get_pending();
+    if ( pending.empty() )
+        return;
+
+    // Handlers are called after search because pending list is modified
+    std::vector<connection_state*> states;
+    for ( pending_type::iterator iter = pending.begin(); iter != pending.end(); ++iter )
+    {
+        connection_state* state = *iter;
+        if ( state->m_source == source )
+        {
+            state->add_ref();
+            states.push_back(state);
+        }
+    }
+
+    for ( std::size_t i = 0; i < states.size(); i++ )
+    {
+        try
+        {
+            if ( states[i]->m_connected )
+                states[i]->do_deliver_pending();
+        }
+        catch ( ... )
+        {
+            for ( std::size_t j = i; j < states.size(); j++ )
+                states[j]->release();
+            throw;
+        }
+        states[i]->release();
+    }
+}
+
+} // namespace detail
+} // namespace ui
+} // namespace boost
@@ -179,10 +179,12 @@ void date_picker::set_ymd(int year, int month, int day)
 #endif
 }
 
-void date_picker::on_change_raw(const boost::function<void()>& handler)
+connection date_picker::on_change_raw(const boost::function<void()>& handler, bool replace)
 {
 #if wxUSE_DATEPICKCTRL
-    native::bind_helper(*this, wxEVT_DATE_CHANGED, handler);
+    return native::bind_helper(*this, wxEVT_DATE_CHANGED, handler, replace);
+#else
+    return connection();
 #endif
 }
 
@@ -384,10 +386,12 @@ time_picker& time_picker::set_time(int hours, int minutes, int seconds)
 }
 
 
-void time_picker::on_change_raw(const boost::function<void()>& handler)
+connection time_picker::on_change_raw(const boost::function<void()>& handler, bool replace)
 {
 #if wxUSE_TIMEPICKCTRL
-    native::bind_helper(*this, wxEVT_TIME_CHANGED, handler);
+    return native::bind_helper(*this, wxEVT_TIME_CHANGED, handler, replace);
+#else
+    return connection();
 #endif
 }
 
@@ -20,21 +20,41 @@ mouse_event::mouse_event() : m_x(-1), m_y(-1),
 {
 }
 
+void mouse_event::coalesce(const mouse_event& next)
+{
+    m_history.push_back(pos());
+
+    m_x = next.m_x;
+    m_y = next.m_y;
+    m_left   = next.m_left;
+    m_right  = next.m_right;
+    m_middle = next.m_middle;
+}
+
+void wheel_event::coalesce(const wheel_event& next)
+{
+    mouse_event::coalesce(next);
+
+    m_horizontal = next.m_horizontal;
+    m_delta_x += next.m_delta_x;
+    m_delta_y += next.m_delta_y;
+}
+
 namespace native {
 
 template <>
-void event_functor_event<wxCommandEvent, event>::init(event& uievent, wxCommandEvent& wxevent)
+void init_event<wxCommandEvent, event>(event& uievent, wxCommandEvent& wxevent)
 {
 }
 
 template <>
-void event_functor_event<wxCommandEvent, index_event>::init(index_event& uievent, wxCommandEvent& wxevent)
+void init_event<wxCommandEvent, index_event>(index_event& uievent, wxCommandEvent& wxevent)
 {
     uievent.m_index = wxevent.GetInt();
 }
 
 template <>
-void event_functor_event<wxKeyEvent, key_event>::init(key_event& uievent, wxKeyEvent& wxevent)
+void init_event<wxKeyEvent, key_event>(key_event& uievent, wxKeyEvent& wxevent)
 {
     uievent.m_code = wxevent.GetKeyCode();
 
@@ -49,7 +69,7 @@ void event_functor_event<wxKeyEvent, key_event>::init(key_event& uievent, wxKeyE
 }
 
 template <>
-void event_functor_event<wxMouseEvent, mouse_event>::init(mouse_event& uievent, wxMouseEvent& wxevent)
+void init_event<wxMouseEvent, mouse_event>(mouse_event& uievent, wxMouseEvent& wxevent)
 {
     uievent.m_x = wxevent.GetX();
     uievent.m_y = wxevent.GetY();
@@ -59,7 +79,7 @@ void event_functor_event<wxMouseEvent, mouse_event>::init(mouse_event& uievent,
 }
 
 template <>
-void event_functor_event<wxMouseEvent, wheel_event>::init(wheel_event& uievent, wxMouseEvent& wxevent)
+void init_event<wxMouseEvent, wheel_event>(wheel_event& uievent, wxMouseEvent& wxevent)
 {
     uievent.m_x = wxevent.GetX();
     uievent.m_y = wxevent.GetY();
@@ -68,13 +88,14 @@ void event_functor_event<wxMouseEvent, wheel_event>::init(wheel_event& uievent,
     uievent.m_middle = wxevent.MiddleIsDown() || wxevent.MiddleUp();
 
     uievent.m_horizontal = wxevent.GetWheelAxis() == wxMOUSE_WHEEL_HORIZONTAL;
-    uievent.m_delta = wxevent.GetWheelRotation();
     if ( uievent.m_horizontal )
-        uievent.m_delta = -uievent.m_delta;
+        uievent.m_delta_x = -wxevent.GetWheelRotation();
+    else
+        uievent.m_delta_y = wxevent.GetWheelRotation();
 }
 
 template <>
-void event_functor_event<wxContextMenuEvent, mouse_event>::init(mouse_event& uievent, wxContextMenuEvent& wxevent)
+void init_event<wxContextMenuEvent, mouse_event>(mouse_event& uievent, wxContextMenuEvent& wxevent)
 {
     wxPoint pos = wxevent.GetPosition();
 
@@ -0,0 +1,491 @@
+// Copyright (c) 2018 Kolya Kosenko
+
+// Distributed under the Boost Software License, Version 1.0.
+// See http://www.boost.org/LICENSE_1_0.txt
+
+#define BOOST_UI_SOURCE
+
+#include <boost/ui/native/config.hpp>
+
+#include <boost/ui/event_trace.hpp>
+#include <boost/ui/log.hpp>
+#include <boost/ui/native/string.hpp>
+
+#include <boost/core/demangle.hpp>
+
+#include <wx/window.h>
+#include <wx/event.h>
+#include <wx/stopwatch.h>
+#include <wx/textctrl.h>
+#include <wx/dateevt.h>
+
+#include <list>
+#include <map>
+#include <set>
+#include <ostream>
+#include <climits> // INT_MIN
+#include <cstdio>
+
+namespace boost {
+namespace ui    {
+
+namespace {
+
+// Upper duration limit of the first histogram bucket in microseconds
+const boost::int64_t first_bucket_limit = 64;
+
+const char* event_name(int event_type)
+{
+#define BOOST_UI_EVENT_NAME(type, name) \
+    if ( event_type == type ) \
+        return name;
+
+    BOOST_UI_EVENT_NAME(wxEVT_SIZE,                "resize")
+    BOOST_UI_EVENT_NAME(wxEVT_CLOSE_WINDOW,        "close")
+    BOOST_UI_EVENT_NAME(wxEVT_CHAR,                "key_press")
+    BOOST_UI_EVENT_NAME(wxEVT_KEY_DOWN,            "key_down")
+    BOOST_UI_EVENT_NAME(wxEVT_KEY_UP,              "key_up")
+    BOOST_UI_EVENT_NAME(wxEVT_LEFT_DOWN,           "left_mouse_down")
+    BOOST_UI_EVENT_NAME(wxEVT_LEFT_UP,             "left_mouse_up")
+    BOOST_UI_EVENT_NAME(wxEVT_LEFT_DCLICK,         "left_mouse_double_click")
+    BOOST_UI_EVENT_NAME(wxEVT_RIGHT_DOWN,          "right_mouse_down")
+    BOOST_UI_EVENT_NAME(wxEVT_RIGHT_UP,            "right_mouse_up")
+    BOOST_UI_EVENT_NAME(wxEVT_RIGHT_DCLICK,        "right_mouse_double_click")
+    BOOST_UI_EVENT_NAME(wxEVT_MIDDLE_DOWN,         "middle_mouse_down")
+    BOOST_UI_EVENT_NAME(wxEVT_MIDDLE_UP,           "middle_mouse_up")
+    BOOST_UI_EVENT_NAME(wxEVT_MIDDLE_DCLICK,       "middle_mouse_double_click")
+    BOOST_UI_EVENT_NAME(wxEVT_MOTION,              "mouse_move")
+    BOOST_UI_EVENT_NAME(wxEVT_ENTER_WINDOW,        "mouse_enter")
+    BOOST_UI_EVENT_NAME(wxEVT_LEAVE_WINDOW,        "mouse_leave")
+    BOOST_UI_EVENT_NAME(wxEVT_MOUSEWHEEL,          "mouse_wheel")
+    BOOST_UI_EVENT_NAME(wxEVT_CONTEXT_MENU,        "context_menu")
+    BOOST_UI_EVENT_NAME(wxEVT_BUTTON,              "press")
+    BOOST_UI_EVENT_NAME(wxEVT_CHECKBOX,            "toggle")
+    BOOST_UI_EVENT_NAME(wxEVT_CHOICE,              "select")
+    BOOST_UI_EVENT_NAME(wxEVT_COMBOBOX,            "select")
+    BOOST_UI_EVENT_NAME(wxEVT_LISTBOX,             "select")
+    BOOST_UI_EVENT_NAME(wxEVT_LISTBOX_DCLICK,      "activate")
+    BOOST_UI_EVENT_NAME(wxEVT_SLIDER,              "slide")
+    BOOST_UI_EVENT_NAME(wxEVT_SCROLL_THUMBRELEASE, "slide_end")
+#if wxUSE_TEXTCTRL
+    BOOST_UI_EVENT_NAME(wxEVT_TEXT,                "edit")
+#endif
+#if wxUSE_DATEPICKCTRL
+    BOOST_UI_EVENT_NAME(wxEVT_DATE_CHANGED,        "change")
+#endif
+#if wxUSE_TIMEPICKCTRL
+    BOOST_UI_EVENT_NAME(wxEVT_TIME_CHANGED,        "change")
+#endif
+
+#undef BOOST_UI_EVENT_NAME
+
+    return NULL;
+}
+
+uistring event_string(int event_type)
+{
+    const char* name = event_name(event_type);
+    if ( name )
+        return asciiuistring(name);
+
+    char buffer[32];
+    std::sprintf(buffer, "event %d", event_type);
+    return asciiuistring(buffer);
+}
+
+// Native class name of the event source with the window label
+uistring widget_string(void* source)
+{
+    wxEvtHandler* handler = static_cast<wxEvtHandler*>(source);
+    wxString result = handler->GetClassInfo()->GetClassName();
+
+    wxWindow* window = wxDynamicCast(handler, wxWindow);
+    if ( window )
+    {
+        const wxString label = window->GetLabel();
+        if ( !label.empty() )
+            result << wxS(" \"") << label << wxS('"');
+    }
+
+    return native::to_uistring(result);
+}
+
+uistring handler_string(const std::type_info& handler)
+{
+    const std::string name = boost::core::demangle(handler.name());
+    return asciiuistring(name.c_str(), name.size());
+}
+
+struct trace_entry
+{
+    handler_stats stats;
+    const std::type_info* slowest;
+    int event_type;
+    bool retired; // Event source is destroyed
+};
+
+// Handler call recorded for the Chrome trace
+struct trace_call
+{
+    boost::int64_t start;
+    boost::int64_t duration;
+    const trace_entry* entry;
+    const std::type_info* handler;
+};
+
+class trace_data
+{
+public:
+    trace_data() : m_budget(16), m_capacity(10000), m_next(0) {}
+
+    unsigned budget() const { return m_budget; }
+    void budget(unsigned milliseconds) { m_budget = milliseconds; }
+
+    void capacity(std::size_t count)
+    {
+        m_capacity = count;
+        clear_calls();
+    }
+
+    boost::int64_t now() const
+    {
+        return m_clock.TimeInMicro().GetValue();
+    }
+
+    // Creates statistics while the event source is alive
+    void prepare(void* source, int event_type)
+    {
+        const key_type key(source, event_type);
+        if ( m_live.find(key) != m_live.end() )
+            return;
+
+        m_entries.push_back(trace_entry());
+        trace_entry& entry = m_entries.back();
+        entry.stats.event = event_string(event_type);
+        entry.stats.widget = widget_string(source);
+        entry.stats.count = 0;
+        entry.stats.total = 0;
+        entry.stats.max = 0;
+        entry.stats.slow = 0;
+        for ( std::size_t i = 0; i < handler_stats::buckets; i++ )
+            entry.stats.histogram[i] = 0;
+        entry.slowest = NULL;
+        entry.event_type = event_type;
+        entry.retired = false;
+        m_live[key] = --m_entries.end();
+
+        watch(source);
+    }
+
+    void add(void* source, int event_type, const std::type_info& handler,
+             boost::int64_t start, boost::int64_t duration);
+
+    std::vector<handler_stats> snapshot() const;
+
+    void reset()
+    {
+        m_live.clear();
+        m_entries.clear();
+        clear_calls();
+    }
+
+    void write_chrome_trace(std::ostream& os) const;
+
+private:
+    void clear_calls()
+    {
+        m_calls.clear();
+        m_next = 0;
+    }
+
+    // Removes destroyed event source from the lookup,
+    // so the source created at the same address has its own statistics
+    void watch(void* source);
+    void on_destroy(wxWindowDestroyEvent& event);
+    void retire(void* source);
+
+    // Entries aren't moved, calls refer to them
+    typedef std::list<trace_entry> entries_type;
+    entries_type m_entries;
+
+    // Entries of alive event sources
+    typedef std::pair<void*, int> key_type;
+    typedef std::map<key_type, entries_type::iterator> live_type;
+    live_type m_live;
+
+    std::set<void*> m_watched;
+
+    unsigned m_budget;
+
+    // Ring buffer of the last handler calls
+    std::vector<trace_call> m_calls;
+    std::size_t m_capacity;
+    std::size_t m_next;
+
+    wxStopWatch m_clock;
+};
+
+trace_data& get_trace_data()
+{
+    static trace_data data;
+    return data;
+}
+
+std::size_t bucket_index(boost::int64_t duration)
+{
+    std::size_t index = 0;
+    for ( boost::int64_t limit = first_bucket_limit;
+          duration >= limit && index < handler_stats::buckets - 1; limit *= 2 )
+        index++;
+    return index;
+}
+
+void trace_data::watch(void* source)
+{
+    if ( !m_watched.insert(source).second )
+        return;
+
+    wxWindow* window = wxDynamicCast(static_cast<wxEvtHandler*>(source), wxWindow);
+    if ( window )
+        window->Bind(wxEVT_DESTROY, &trace_data::on_destroy, this);
+}
+
+void trace_data::on_destroy(wxWindowDestroyEvent& event)
+{
+    event.Skip();
+
+    // Destruction of the child window is propagated to the parent
+    wxWindow* window = wxDynamicCast(event.GetEventObject(), wxWindow);
+    if ( !window )
+        return;
+
+    void* source = static_cast<wxEvtHandler*>(window);
+    if ( m_watched.erase(source) )
+        retire(source);
+}
+
+void trace_data::retire(void* source)
+{
+    live_type::iterator iter = m_live.lower_bound(key_type(source, INT_MIN));
+    while ( iter != m_live.end() && iter->first.first == source )
+    {
+        const entries_type::iterator entry = iter->second;
+        m_live.erase(iter++);
+        entry->retired = true;
+
+        // Statistics of destroyed widgets with the same name are merged
+        // to keep count of entries limited
+        entries_type::iterator target = m_entries.begin();
+        for ( ; target != m_entries.end(); ++target )
+        {
+            if ( target != entry && target->retired &&
+                 target->event_type == entry->event_type &&
+                 target->stats.widget == entry->stats.widget )
+                break;
+        }
+        if ( target == m_entries.end() )
+            continue;
+
+        handler_stats& stats = target->stats;
+        stats.count += entry->stats.count;
+        stats.total += entry->stats.total;
+        stats.slow += entry->stats.slow;
+        for ( std::size_t i = 0; i < handler_stats::buckets; i++ )
+            stats.histogram[i] += entry->stats.histogram[i];
+        if ( entry->slowest && ( !target->slowest || entry->stats.max > stats.max ) )
+        {
+            stats.max = entry->stats.max;
+            target->slowest = entry->slowest;
+        }
+
+        for ( std::size_t i = 0; i < m_calls.size(); i++ )
+        {
+            if ( m_calls[i].entry == &*entry )
+                m_calls[i].entry = &*target;
+        }
+
+        m_entries.erase(entry);
+    }
+}
+
+void trace_data::add(void* source, int event_type, const std::type_info& handler,
+                     boost::int64_t start, boost::int64_t duration)
+{
+    live_type::iterator iter = m_live.find(key_type(source, event_type));
+    if ( iter == m_live.end() )
+        return; // Reset by the handler or the source is destroyed
+
+    trace_entry& entry = *iter->second;
+    handler_stats& stats = entry.stats;
+
+    stats.count++;
+    stats.total += duration;
+    stats.histogram[bucket_index(duration)]++;
+    if ( !entry.slowest || duration > stats.max )
+    {
+        stats.max = duration;
+        entry.slowest = &handler;
+    }
+
+    if ( m_budget && duration > boost::int64_t(m_budget) * 1000 )
+    {
+        stats.slow++;
+        log::warning() << "Event handler exceeded "
+            << m_budget << " ms budget: " << duration / 1000.0 << " ms, "
+            << stats.event << " event of " << stats.widget
+            << ", handler " << handler_string(handler);
+    }
+
+    if ( !m_capacity )
+        return;
+
+    const trace_call call = { start, duration, &entry, &handler };
+    if ( m_calls.size() < m_capacity )
+    {
+        m_calls.push_back(call);
+    }
+    else
+    {
+        m_calls[m_next] = call;
+        m_next = ( m_next + 1 ) % m_capacity;
+    }
+}
+
+std::vector<handler_stats> trace_data::snapshot() const
+{
+    std::vector<handler_stats> result;
+    result.reserve(m_entries.size());
+
+    for ( entries_type::const_iterator iter = m_entries.begin();
+          iter != m_entries.end(); ++iter )
+    {
+        if ( !iter->stats.count )
+            continue;
+
+        result.push_back(iter->stats);
+        result.back().handler = handler_string(*iter->slowest);
+    }
+
+    return result;
+}
+
+void write_json_string(std::ostream& os, const uistring& str)
+{
+    const std::string utf8 = str.u8string();
+
+    os << '"';
+    for ( std::string::const_iterator iter = utf8.begin(); iter != utf8.end(); ++iter )
+    {
+        const unsigned char c = *iter;
+        switch ( c )
+        {
+            case '"':  os << "\\\""; break;
+            case '\\': os << "\\\\"; break;
+            case '\n': os << "\\n";  break;
+            case '\t': os << "\\t";  break;
+            default:
+                if ( c < 0x20 )
+                {
+                    char buffer[8];
+                    std::sprintf(buffer, "\\u%04x", c);
+                    os << buffer;
+                }
+                else
+                    os << *iter;
+        }
+    }
+    os << '"';
+}
+
+void trace_data::write_chrome_trace(std::ostream& os) const
+{
+    os << "{\"traceEvents\":[";
+
+    for ( std::size_t i = 0; i < m_calls.size(); i++ )
+    {
+        // The oldest call is overwritten next
+        const trace_call& call = m_calls[( m_next + i ) % m_calls.size()];
+
+        if ( i )
+            os << ',';
+        os << "\n{\"name\":";
+        write_json_string(os, call.entry->stats.event);
+        os << ",\"cat\":\"event\",\"ph\":\"X\",\"ts\":" << call.start
+           << ",\"dur\":" << call.duration
+           << ",\"pid\":1,\"tid\":1,\"args\":{\"widget\":";
+        write_json_string(os, call.entry->stats.widget);
+        os << ",\"handler\":";
+        write_json_string(os, handler_string(*call.handler));
+        os << "}}";
+    }
+
+    os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+} // unnamed namespace
+
+bool event_trace::s_enabled = false;
+
+void event_trace::enable(bool enabled)
+{
+    s_enabled = enabled;
+}
+
+void event_trace::budget(unsigned milliseconds)
+{
+    get_trace_data().budget(milliseconds);
+}
+
+unsigned event_trace::budget()
+{
+    return get_trace_data().budget();
+}
+
+void event_trace::trace_capacity(std::size_t count)
+{
+    get_trace_data().capacity(count);
+}
+
+std::vector<handler_stats> event_trace::snapshot()
+{
+    return get_trace_data().snapshot();
+}
+
+void event_trace::reset()
+{
+    get_trace_data().reset();
+}
+
+void event_trace::write_chrome_trace(std::ostream& os)
+{
+    get_trace_data().write_chrome_trace(os);
+}
+
+boost::int64_t event_trace::bucket_limit(std::size_t index)
+{
+    if ( index >= handler_stats::buckets - 1 )
+        return -1;
+
+    return first_bucket_limit << index;
+}
+
+namespace detail {
+
+handler_timer::handler_timer(void* source, int event_type, const std::type_info& handler)
+    : m_source(source), m_event_type(event_type), m_handler(handler)
+{
+    trace_data& data = get_trace_data();
+    data.prepare(source, event_type);
+    m_start = data.now();
+}
+
+handler_timer::~handler_timer()
+{
+    trace_data& data = get_trace_data();
+    data.add(m_source, m_event_type, m_handler, m_start, data.now() - m_start);
+}
+
+} // namespace detail
+
+} // namespace ui
+} // namespace boost
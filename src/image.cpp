@@ -8,18 +8,28 @@
 #include <boost/ui/native/config.hpp>
 
 #include <boost/ui/image.hpp>
+#include <boost/ui/thread.hpp>
+#include <boost/ui/native/string.hpp>
 #include <boost/ui/detail/memcheck.hpp>
 
 #include <boost/throw_exception.hpp>
+#include <boost/bind.hpp>
 
 #include <wx/bitmap.h>
+#include <wx/image.h>
 #include <wx/artprov.h>
 #include <wx/mstream.h>
+#include <wx/wfstream.h>
+#include <wx/stdstream.h>
+#include <wx/thread.h>
 #include <wx/log.h>
 
+#include <boost/cstdint.hpp>
+
 #include <map>
 #include <vector>
 #include <stdexcept>
+#include <cstring>
 
 #ifndef wxOVERRIDE
 #define wxOVERRIDE
@@ -113,6 +123,461 @@ image& image::load(std::istream& s)
     return *this;
 }
 
+static wxBitmapType from_image_format(image::format f)
+{
+    wxBitmapType type = wxBITMAP_TYPE_PNG;
+    switch ( boost::native_value(f) )
+    {
+        case image::format::png:  type = wxBITMAP_TYPE_PNG; break;
+        case image::format::jpeg: type = wxBITMAP_TYPE_JPEG; break;
+        case image::format::bmp:  type = wxBITMAP_TYPE_BMP; break;
+        case image::format::gif:  type = wxBITMAP_TYPE_GIF; break;
+        case image::format::ico:  type = wxBITMAP_TYPE_ICO; break;
+    }
+    return type;
+}
+
+static void set_compression(wxImage& img, image::format f, int compression)
+{
+    if ( compression < 0 )
+        return;
+    if ( compression > 100 )
+        compression = 100;
+
+    switch ( boost::native_value(f) )
+    {
+        case image::format::png:
+            img.SetOption(wxIMAGE_OPTION_PNG_COMPRESSION_LEVEL, compression * 9 / 100);
+            break;
+        case image::format::jpeg:
+            img.SetOption(wxIMAGE_OPTION_QUALITY, 100 - compression);
+            break;
+        case image::format::bmp:
+        case image::format::gif:
+        case image::format::ico:
+            break;
+    }
+}
+
+static bool save_image(const wxImage& img, std::ostream& s, image::format f)
+{
+    wxStdOutputStream os(s);
+    return img.SaveFile(os, from_image_format(f)) && s.good();
+}
+
+const image& image::save(std::ostream& s, format f, int compression) const
+{
+    if ( !valid() )
+        BOOST_THROW_EXCEPTION(std::runtime_error("ui::image::save(): invalid image"));
+
+    init_image_handlers();
+
+    wxImage img = m_impl->ConvertToImage();
+    set_compression(img, f, compression);
+
+    wxLogBuffer* logger = new my_log_buffer;
+    wxLog* oldLog = wxLog::SetActiveTarget(logger);
+
+    const bool saved = save_image(img, s, f);
+
+    const wxString errors = logger->GetBuffer();
+    delete wxLog::SetActiveTarget(oldLog);
+
+    if ( !saved )
+    {
+        if ( !errors.empty() )
+            BOOST_THROW_EXCEPTION(std::runtime_error( std::string(errors.c_str()) ));
+
+        BOOST_THROW_EXCEPTION(std::runtime_error("ui::image::save(): image save failure"));
+    }
+
+    return *this;
+}
+
+namespace {
+class save_thread : public wxThread
+{
+public:
+    save_thread(const wxImage& img, std::ostream& s, image::format f,
+                const boost::function<void(bool)>& handler)
+        : wxThread(wxTHREAD_DETACHED),
+          m_image(img), m_stream(s), m_format(f), m_handler(handler)
+    {}
+
+protected:
+    virtual ExitCode Entry() wxOVERRIDE
+    {
+        const bool saved = save_image(m_image, m_stream, m_format);
+        call_async(boost::bind(m_handler, saved));
+        return 0;
+    }
+
+private:
+    wxImage m_image;
+    std::ostream& m_stream;
+    const image::format m_format;
+    const boost::function<void(bool)> m_handler;
+};
+}
+
+void image::save_async(std::ostream& s, format f, int compression,
+                       const boost::function<void(bool)>& handler) const
+{
+    if ( !valid() )
+        BOOST_THROW_EXCEPTION(std::runtime_error("ui::image::save_async(): invalid image"));
+
+    init_image_handlers();
+
+    save_thread* thread = NULL;
+    {
+        // wxImage reference counter isn't thread safe,
+        // so the thread should be the only owner of the image data
+        wxImage img = m_impl->ConvertToImage();
+        set_compression(img, f, compression);
+        thread = new save_thread(img, s, f, handler);
+    }
+
+    if ( thread->Run() != wxTHREAD_NO_ERROR )
+    {
+        delete thread;
+        BOOST_THROW_EXCEPTION(std::runtime_error("ui::image::save_async(): unable to run thread"));
+    }
+}
+
+namespace {
+
+// Reads image file headers only, pixels data is skipped without decoding
+class probe_reader
+{
+public:
+    explicit probe_reader(std::istream& s) : m_stream(s) {}
+
+    bool read(unsigned char* buffer, std::size_t count)
+    {
+        m_stream.read(reinterpret_cast<char*>(buffer),
+                      static_cast<std::streamsize>(count));
+        return static_cast<std::size_t>(m_stream.gcount()) == count;
+    }
+
+    bool skip(std::size_t count)
+    {
+        m_stream.ignore(static_cast<std::streamsize>(count));
+        return static_cast<std::size_t>(m_stream.gcount()) == count;
+    }
+
+    int get()
+    {
+        return m_stream.get();
+    }
+
+private:
+    std::istream& m_stream;
+};
+
+inline unsigned int be16(const unsigned char* p)
+{
+    return (p[0] << 8) | p[1];
+}
+
+inline unsigned long be32(const unsigned char* p)
+{
+    return (static_cast<unsigned long>(p[0]) << 24) |
+           (static_cast<unsigned long>(p[1]) << 16) | (p[2] << 8) | p[3];
+}
+
+inline unsigned int le16(const unsigned char* p)
+{
+    return (p[1] << 8) | p[0];
+}
+
+inline long le32(const unsigned char* p)
+{
+    return static_cast<long>(static_cast<boost::int32_t>(
+           (static_cast<boost::uint32_t>(p[3]) << 24) |
+           (static_cast<boost::uint32_t>(p[2]) << 16) | (p[1] << 8) | p[0]));
+}
+
+bool skip_gif_sub_blocks(probe_reader& r)
+{
+    for (;;)
+    {
+        const int count = r.get();
+        if ( count < 0 )
+            return false;
+        if ( count == 0 )
+            return true;
+        if ( !r.skip(count) )
+            return false;
+    }
+}
+
+} // unnamed namespace
+
+class native_helper
+{
+public:
+    static bool probe_png(probe_reader& r, image_info& info)
+    {
+        // Signature rest and IHDR chunk
+        unsigned char h[6 + 8 + 13 + 4];
+        if ( !r.read(h, sizeof h) )
+            return false;
+        if ( std::memcmp(h, "NG\r\n\x1a\n", 6) != 0 || std::memcmp(h + 10, "IHDR", 4) != 0 )
+            return false;
+
+        const unsigned char* ihdr = h + 14;
+        int channels = 0;
+        switch ( ihdr[9] )
+        {
+            case 0: channels = 1; break; // Grayscale
+            case 2: channels = 3; break; // RGB
+            case 3: channels = 1; break; // Palette
+            case 4: channels = 2; break; // Grayscale and alpha
+            case 6: channels = 4; break; // RGBA
+        }
+
+        info.m_format = image::format::png;
+        info.m_width  = static_cast<coord_type>(be32(ihdr));
+        info.m_height = static_cast<coord_type>(be32(ihdr + 4));
+        info.m_bits_per_pixel = ihdr[8] * channels;
+        info.m_frames = 1;
+        info.m_valid = true;
+
+        // APNG animation control chunk is placed before image data
+        for (;;)
+        {
+            unsigned char chunk[8];
+            if ( !r.read(chunk, sizeof chunk) )
+                break;
+            const unsigned long length = be32(chunk);
+            if ( std::memcmp(chunk + 4, "IDAT", 4) == 0 ||
+                 std::memcmp(chunk + 4, "IEND", 4) == 0 )
+                break;
+            if ( std::memcmp(chunk + 4, "acTL", 4) == 0 && length >= 4 )
+            {
+                unsigned char frames[4];
+                if ( r.read(frames, sizeof frames) )
+                    info.m_frames = be32(frames);
+                break;
+            }
+            if ( !r.skip(length + 4) )
+                break;
+        }
+
+        return true;
+    }
+
+    static bool probe_jpeg(probe_reader& r, image_info& info)
+    {
+        for (;;)
+        {
+            int marker = r.get();
+            if ( marker != 0xFF )
+                return false;
+            while ( marker == 0xFF )
+                marker = r.get();
+            if ( marker < 0 || marker == 0xD9 || marker == 0xDA )
+                return false; // End of file or image data before frame header
+
+            // Markers without data
+            if ( marker == 0x01 || ( marker >= 0xD0 && marker <= 0xD7 ) )
+                continue;
+
+            unsigned char length[2];
+            if ( !r.read(length, sizeof length) || be16(length) < 2 )
+                return false;
+
+            // Start of frame markers, except DHT, JPG and DAC
+            if ( marker >= 0xC0 && marker <= 0xCF &&
+                 marker != 0xC4 && marker != 0xC8 && marker != 0xCC )
+            {
+                unsigned char sof[6];
+                if ( !r.read(sof, sizeof sof) )
+                    return false;
+
+                info.m_format = image::format::jpeg;
+                info.m_height = static_cast<coord_type>(be16(sof + 1));
+                info.m_width  = static_cast<coord_type>(be16(sof + 3));
+                info.m_bits_per_pixel = sof[0] * sof[5];
+                info.m_frames = 1;
+                info.m_valid = true;
+                return true;
+            }
+
+            if ( !r.skip(be16(length) - 2) )
+                return false;
+        }
+    }
+
+    static bool probe_bmp(probe_reader& r, image_info& info)
+    {
+        // File header rest and DIB header size
+        unsigned char h[12 + 4];
+        if ( !r.read(h, sizeof h) )
+            return false;
+
+        const long dib_size = le32(h + 12);
+        if ( dib_size == 12 )
+        {
+            // OS/2 BITMAPCOREHEADER
+            unsigned char core[8];
+            if ( !r.read(core, sizeof core) )
+                return false;
+
+            info.m_width  = static_cast<coord_type>(le16(core));
+            info.m_height = static_cast<coord_type>(le16(core + 2));
+            info.m_bits_per_pixel = static_cast<int>(le16(core + 6));
+        }
+        else if ( dib_size >= 16 )
+        {
+            unsigned char dib[12];
+            if ( !r.read(dib, sizeof dib) )
+                return false;
+
+            const long height = le32(dib + 4);
+            info.m_width  = static_cast<coord_type>(le32(dib));
+            info.m_height = static_cast<coord_type>(height < 0 ? -height : height);
+            info.m_bits_per_pixel = static_cast<int>(le16(dib + 10));
+        }
+        else
+            return false;
+
+        info.m_format = image::format::bmp;
+        info.m_frames = 1;
+        info.m_valid = true;
+        return true;
+    }
+
+    static bool probe_gif(probe_reader& r, image_info& info)
+    {
+        // Signature rest and logical screen descriptor
+        unsigned char h[4 + 7];
+        if ( !r.read(h, sizeof h) )
+            return false;
+        if ( std::memcmp(h, "F87a", 4) != 0 && std::memcmp(h, "F89a", 4) != 0 )
+            return false;
+
+        const unsigned char* lsd = h + 4;
+        info.m_format = image::format::gif;
+        info.m_width  = static_cast<coord_type>(le16(lsd));
+        info.m_height = static_cast<coord_type>(le16(lsd + 2));
+        info.m_bits_per_pixel = ( lsd[4] & 0x07 ) + 1;
+        info.m_frames = 0;
+        info.m_valid = true;
+
+        if ( ( lsd[4] & 0x80 ) && !r.skip(3 << info.m_bits_per_pixel) )
+            return true;
+
+        // Count image descriptors skipping image data sub-blocks
+        for (;;)
+        {
+            const int block = r.get();
+            if ( block == 0x2C ) // Image descriptor
+            {
+                unsigned char descriptor[9];
+                if ( !r.read(descriptor, sizeof descriptor) )
+                    break;
+                if ( ( descriptor[8] & 0x80 ) &&
+                     !r.skip(3 << ( ( descriptor[8] & 0x07 ) + 1 )) )
+                    break;
+                if ( r.get() < 0 ) // LZW minimum code size
+                    break;
+                if ( !skip_gif_sub_blocks(r) )
+                    break;
+
+                info.m_frames++;
+            }
+            else if ( block == 0x21 ) // Extension
+            {
+                if ( r.get() < 0 || !skip_gif_sub_blocks(r) )
+                    break;
+            }
+            else // Trailer, end of file or unknown block
+                break;
+        }
+
+        return true;
+    }
+
+    static bool probe_ico(probe_reader& r, image_info& info)
+    {
+        unsigned char h[4];
+        if ( !r.read(h, sizeof h) )
+            return false;
+
+        const unsigned int type  = le16(h);
+        const unsigned int count = le16(h + 2);
+        if ( ( type != 1 && type != 2 ) || count == 0 )
+            return false;
+
+        // Choose the largest icon
+        for ( unsigned int i = 0; i < count; i++ )
+        {
+            unsigned char entry[16];
+            if ( !r.read(entry, sizeof entry) )
+                return false;
+
+            const coord_type width  = entry[0] ? entry[0] : 256;
+            const coord_type height = entry[1] ? entry[1] : 256;
+            if ( width * height <= info.m_width * info.m_height )
+                continue;
+
+            info.m_width  = width;
+            info.m_height = height;
+            info.m_bits_per_pixel = type == 1 ? static_cast<int>(le16(entry + 6)) : 0;
+        }
+
+        info.m_format = image::format::ico;
+        info.m_frames = count;
+        info.m_valid = true;
+        return true;
+    }
+
+    static image_info probe(std::istream& s)
+    {
+        image_info info;
+        probe_reader r(s);
+
+        unsigned char signature[2];
+        if ( !r.read(signature, sizeof signature) )
+            return info;
+
+        bool ok = false;
+        if ( signature[0] == 0x89 && signature[1] == 'P' )
+            ok = probe_png(r, info);
+        else if ( signature[0] == 0xFF && signature[1] == 0xD8 )
+            ok = probe_jpeg(r, info);
+        else if ( signature[0] == 'B' && signature[1] == 'M' )
+            ok = probe_bmp(r, info);
+        else if ( signature[0] == 'G' && signature[1] == 'I' )
+            ok = probe_gif(r, info);
+        else if ( signature[0] == 0 && signature[1] == 0 )
+            ok = probe_ico(r, info);
+
+        if ( !ok )
+            info = image_info();
+
+        return info;
+    }
+};
+
+image_info image::probe(std::istream& s)
+{
+    return native_helper::probe(s);
+}
+
+image_info image::probe(const uistring& filename)
+{
+    wxLogNull no_log;
+    wxFFileInputStream fs(native::from_uistring(filename));
+    if ( !fs.IsOk() )
+        BOOST_THROW_EXCEPTION(std::runtime_error("ui::image::probe(): unable to open file"));
+
+    wxStdInputStreamBuffer buffer(fs);
+    std::istream s(&buffer);
+    return probe(s);
+}
+
 image image::xdg(const char* name, coord_type width, coord_type height)
 {
     typedef std::map<std::string, wxArtID> map_type;
@@ -0,0 +1,697 @@
+// Copyright (c) 2018 Kolya Kosenko
+
+// Distributed under the Boost Software License, Version 1.0.
+// See http://www.boost.org/LICENSE_1_0.txt
+
+#define BOOST_UI_SOURCE
+
+#include <boost/ui/native/config.hpp>
+
+#include <boost/ui/input_record.hpp>
+#include <boost/ui/native/string.hpp>
+#include <boost/ui/native/widget.hpp>
+#include <boost/ui/detail/memcheck.hpp>
+
+#include <boost/cstdint.hpp>
+#include <boost/throw_exception.hpp>
+
+#include <wx/window.h>
+#include <wx/event.h>
+#include <wx/eventfilter.h>
+#include <wx/ffile.h>
+#include <wx/stopwatch.h>
+#include <wx/timer.h>
+#include <wx/weakref.h>
+
+#include <vector>
+#include <algorithm>
+#include <stdexcept> // std::runtime_error
+
+namespace boost {
+namespace ui    {
+
+namespace {
+
+// File format:
+//   "BUIR" signature and format version byte,
+//   then records of kind byte, time delta in microseconds,
+//   path of the target window, and the event fields.
+// Integers are written as LEB128 variable length values,
+// signed integers are zigzag encoded.
+
+const char signature[] = { 'B', 'U', 'I', 'R' };
+const unsigned char format_version = 1;
+
+// Kind byte of the record, new kinds should be appended
+enum record_kind
+{
+    motion_kind,
+    left_down_kind,
+    left_up_kind,
+    left_dclick_kind,
+    right_down_kind,
+    right_up_kind,
+    right_dclick_kind,
+    middle_down_kind,
+    middle_up_kind,
+    middle_dclick_kind,
+    enter_window_kind,
+    leave_window_kind,
+    mouse_wheel_kind,
+    key_down_kind,
+    key_up_kind,
+    char_kind,
+    kinds_count
+};
+
+wxEventType kind_event_type(int kind)
+{
+    switch ( kind )
+    {
+        case motion_kind:        return wxEVT_MOTION;
+        case left_down_kind:     return wxEVT_LEFT_DOWN;
+        case left_up_kind:       return wxEVT_LEFT_UP;
+        case left_dclick_kind:   return wxEVT_LEFT_DCLICK;
+        case right_down_kind:    return wxEVT_RIGHT_DOWN;
+        case right_up_kind:      return wxEVT_RIGHT_UP;
+        case right_dclick_kind:  return wxEVT_RIGHT_DCLICK;
+        case middle_down_kind:   return wxEVT_MIDDLE_DOWN;
+        case middle_up_kind:     return wxEVT_MIDDLE_UP;
+        case middle_dclick_kind: return wxEVT_MIDDLE_DCLICK;
+        case enter_window_kind:  return wxEVT_ENTER_WINDOW;
+        case leave_window_kind:  return wxEVT_LEAVE_WINDOW;
+        case mouse_wheel_kind:   return wxEVT_MOUSEWHEEL;
+        case key_down_kind:      return wxEVT_KEY_DOWN;
+        case key_up_kind:        return wxEVT_KEY_UP;
+        case char_kind:          return wxEVT_CHAR;
+    }
+    return wxEVT_NULL;
+}
+
+int find_kind(wxEventType type)
+{
+    for ( int kind = 0; kind < kinds_count; kind++ )
+    {
+        if ( kind_event_type(kind) == type )
+            return kind;
+    }
+    return -1;
+}
+
+bool is_mouse_kind(int kind) { return kind <= mouse_wheel_kind; }
+bool is_wheel_kind(int kind) { return kind == mouse_wheel_kind; }
+
+// Bits of the state byte
+enum state_flags
+{
+    left_flag   = 0x01,
+    middle_flag = 0x02,
+    right_flag  = 0x04,
+    ctrl_flag   = 0x10,
+    shift_flag  = 0x20,
+    alt_flag    = 0x40,
+    meta_flag   = 0x80
+};
+
+struct input_event
+{
+    unsigned char kind;
+    boost::int64_t time;           // Microseconds since start of the recording
+    std::vector<unsigned> path;    // Child indices from the root window
+    int x;
+    int y;
+    unsigned char state;
+    int rotation;
+    int delta;
+    int lines;
+    unsigned char axis;
+    long key_code;
+    unsigned long unicode;
+};
+
+typedef std::vector<input_event> input_events;
+
+unsigned char keyboard_state_flags(const wxKeyboardState& ks)
+{
+    unsigned char state = 0;
+    if ( ks.ControlDown() ) state |= ctrl_flag;
+    if ( ks.ShiftDown() )   state |= shift_flag;
+    if ( ks.AltDown() )     state |= alt_flag;
+    if ( ks.MetaDown() )    state |= meta_flag;
+    return state;
+}
+
+void set_keyboard_state(wxKeyboardState& ks, unsigned char state)
+{
+    ks.SetControlDown( ( state & ctrl_flag  ) != 0 );
+    ks.SetShiftDown(   ( state & shift_flag ) != 0 );
+    ks.SetAltDown(     ( state & alt_flag   ) != 0 );
+    ks.SetMetaDown(    ( state & meta_flag  ) != 0 );
+}
+
+// Returns false if the window isn't in the tree of the root window
+bool window_path(const wxWindow* root, const wxWindow* window,
+                 std::vector<unsigned>& path)
+{
+    path.clear();
+
+    for ( ; window != root; window = window->GetParent() )
+    {
+        const wxWindow* parent = window->GetParent();
+        if ( !parent )
+            return false;
+
+        const wxWindowList& children = parent->GetChildren();
+        unsigned index = 0;
+        wxWindowList::const_iterator iter = children.begin();
+        for ( ; iter != children.end() && *iter != window; ++iter )
+            index++;
+
+        path.push_back(index);
+    }
+
+    std::reverse(path.begin(), path.end());
+    return true;
+}
+
+wxWindow* find_window(wxWindow* root, const std::vector<unsigned>& path)
+{
+    wxWindow* window = root;
+
+    for ( std::vector<unsigned>::const_iterator iter = path.begin();
+          iter != path.end(); ++iter )
+    {
+        const wxWindowList& children = window->GetChildren();
+        wxWindowList::const_iterator child = children.begin();
+        for ( unsigned index = 0; index < *iter && child != children.end(); index++ )
+            ++child;
+
+        if ( child == children.end() )
+            return NULL;
+
+        window = *child;
+    }
+
+    return window;
+}
+
+class output_buffer
+{
+public:
+    void put_byte(unsigned char value)
+    {
+        m_data.push_back(value);
+    }
+
+    void put_unsigned(boost::uint64_t value)
+    {
+        while ( value >= 0x80 )
+        {
+            put_byte(static_cast<unsigned char>(value | 0x80));
+            value >>= 7;
+        }
+        put_byte(static_cast<unsigned char>(value));
+    }
+
+    void put_signed(boost::int64_t value)
+    {
+        put_unsigned( ( static_cast<boost::uint64_t>(value) << 1 ) ^
+                      static_cast<boost::uint64_t>(value >> 63) );
+    }
+
+    const std::vector<unsigned char>& data() const { return m_data; }
+
+private:
+    std::vector<unsigned char> m_data;
+};
+
+class input_buffer
+{
+public:
+    input_buffer(const unsigned char* data, std::size_t size)
+        : m_data(data), m_end(data + size) {}
+
+    bool empty() const { return m_data == m_end; }
+
+    unsigned char get_byte()
+    {
+        if ( empty() )
+            format_error();
+        return *m_data++;
+    }
+
+    boost::uint64_t get_unsigned()
+    {
+        boost::uint64_t value = 0;
+        for ( int shift = 0; ; shift += 7 )
+        {
+            if ( shift >= 64 )
+                format_error();
+
+            const unsigned char byte = get_byte();
+            value |= static_cast<boost::uint64_t>(byte & 0x7F) << shift;
+            if ( !( byte & 0x80 ) )
+                return value;
+        }
+    }
+
+    boost::int64_t get_signed()
+    {
+        const boost::uint64_t value = get_unsigned();
+        return static_cast<boost::int64_t>( value >> 1 ) ^
+               -static_cast<boost::int64_t>( value & 1 );
+    }
+
+    static void format_error()
+    {
+        BOOST_THROW_EXCEPTION(std::runtime_error("ui::input_player: wrong file format"));
+    }
+
+private:
+    const unsigned char* m_data;
+    const unsigned char* m_end;
+};
+
+void write_events(const input_events& events, output_buffer& buffer)
+{
+    for ( std::size_t i = 0; i < sizeof(signature); i++ )
+        buffer.put_byte(signature[i]);
+    buffer.put_byte(format_version);
+
+    boost::int64_t time = 0;
+    for ( input_events::const_iterator iter = events.begin(); iter != events.end(); ++iter )
+    {
+        buffer.put_byte(iter->kind);
+        buffer.put_unsigned(iter->time - time);
+        time = iter->time;
+
+        buffer.put_unsigned(iter->path.size());
+        for ( std::size_t i = 0; i < iter->path.size(); i++ )
+            buffer.put_unsigned(iter->path[i]);
+
+        buffer.put_byte(iter->state);
+
+        if ( is_mouse_kind(iter->kind) )
+        {
+            buffer.put_signed(iter->x);
+            buffer.put_signed(iter->y);
+        }
+        else
+        {
+            buffer.put_signed(iter->key_code);
+            buffer.put_unsigned(iter->unicode);
+        }
+
+        if ( is_wheel_kind(iter->kind) )
+        {
+            buffer.put_signed(iter->rotation);
+            buffer.put_unsigned(iter->delta);
+            buffer.put_unsigned(iter->lines);
+            buffer.put_byte(iter->axis);
+        }
+    }
+}
+
+void read_events(input_buffer& buffer, input_events& events)
+{
+    for ( std::size_t i = 0; i < sizeof(signature); i++ )
+    {
+        if ( buffer.get_byte() != static_cast<unsigned char>(signature[i]) )
+            input_buffer::format_error();
+    }
+    if ( buffer.get_byte() != format_version )
+        input_buffer::format_error();
+
+    boost::int64_t time = 0;
+    while ( !buffer.empty() )
+    {
+        input_event e = input_event();
+
+        e.kind = buffer.get_byte();
+        if ( e.kind >= kinds_count )
+            input_buffer::format_error();
+
+        time += buffer.get_unsigned();
+        e.time = time;
+
+        const boost::uint64_t path_size = buffer.get_unsigned();
+        for ( boost::uint64_t i = 0; i < path_size; i++ )
+            e.path.push_back(static_cast<unsigned>(buffer.get_unsigned()));
+
+        e.state = buffer.get_byte();
+
+        if ( is_mouse_kind(e.kind) )
+        {
+            e.x = static_cast<int>(buffer.get_signed());
+            e.y = static_cast<int>(buffer.get_signed());
+        }
+        else
+        {
+            e.key_code = static_cast<long>(buffer.get_signed());
+            e.unicode  = static_cast<unsigned long>(buffer.get_unsigned());
+        }
+
+        if ( is_wheel_kind(e.kind) )
+        {
+            e.rotation = static_cast<int>(buffer.get_signed());
+            e.delta    = static_cast<int>(buffer.get_unsigned());
+            e.lines    = static_cast<int>(buffer.get_unsigned());
+            e.axis     = buffer.get_byte();
+        }
+
+        events.push_back(e);
+    }
+}
+
+} // unnamed namespace
+
+class input_recorder::native_impl : public wxEventFilter, private detail::memcheck
+{
+public:
+    explicit native_impl(wxWindow* root) : m_root(root), m_recording(false)
+    {
+        start();
+    }
+
+    ~native_impl()
+    {
+        stop();
+    }
+
+    void stop()
+    {
+        if ( !m_recording )
+            return;
+
+        wxEvtHandler::RemoveFilter(this);
+        m_recording = false;
+    }
+
+    bool is_recording() const { return m_recording; }
+
+    const input_events& events() const { return m_events; }
+
+    virtual int FilterEvent(wxEvent& event) wxOVERRIDE
+    {
+        record(event);
+        return Event_Skip;
+    }
+
+private:
+    void start()
+    {
+        wxEvtHandler::AddFilter(this);
+        m_recording = true;
+        m_stopwatch.Start();
+    }
+
+    void record(wxEvent& event);
+
+    wxWeakRef<wxWindow> m_root;
+    bool m_recording;
+    wxStopWatch m_stopwatch;
+    input_events m_events;
+};
+
+void input_recorder::native_impl::record(wxEvent& event)
+{
+    const int kind = find_kind(event.GetEventType());
+    if ( kind < 0 || !m_root )
+        return;
+
+    const wxWindow* window = wxDynamicCast(event.GetEventObject(), wxWindow);
+    if ( !window )
+        return;
+
+    input_event e = input_event();
+    if ( !window_path(m_root, window, e.path) )
+        return;
+
+    e.kind = static_cast<unsigned char>(kind);
+    e.time = m_stopwatch.TimeInMicro().GetValue();
+
+    if ( is_mouse_kind(kind) )
+    {
+        const wxMouseEvent& me = static_cast<const wxMouseEvent&>(event);
+        e.x = me.GetX();
+        e.y = me.GetY();
+        e.state = keyboard_state_flags(me);
+        if ( me.LeftIsDown() )   e.state |= left_flag;
+        if ( me.MiddleIsDown() ) e.state |= middle_flag;
+        if ( me.RightIsDown() )  e.state |= right_flag;
+        e.rotation = me.GetWheelRotation();
+        e.delta = me.GetWheelDelta();
+        e.lines = me.GetLinesPerAction();
+        e.axis = static_cast<unsigned char>(me.GetWheelAxis());
+    }
+    else
+    {
+        const wxKeyEvent& ke = static_cast<const wxKeyEvent&>(event);
+        e.state = keyboard_state_flags(ke);
+        e.key_code = ke.GetKeyCode();
+#if wxUSE_UNICODE
+        e.unicode = ke.GetUnicodeKey();
+#endif
+    }
+
+    m_events.push_back(e);
+}
+
+input_recorder::input_recorder(widget& root)
+    : m_impl(new native_impl(native::from_widget(root)))
+{
+    wxASSERT_MSG(native::from_widget(root), "Widget should be created");
+}
+
+input_recorder::~input_recorder()
+{
+    delete m_impl;
+}
+
+void input_recorder::stop()
+{
+    m_impl->stop();
+}
+
+bool input_recorder::is_recording() const
+{
+    return m_impl->is_recording();
+}
+
+std::size_t input_recorder::size() const
+{
+    return m_impl->events().size();
+}
+
+void input_recorder::save(const uistring& path) const
+{
+    output_buffer buffer;
+    write_events(m_impl->events(), buffer);
+
+    wxFFile file;
+    if ( !file.Open(native::from_uistring(path), "wb") ||
+         file.Write(&buffer.data()[0], buffer.data().size()) != buffer.data().size() ||
+         !file.Close() )
+    {
+        BOOST_THROW_EXCEPTION(std::runtime_error("ui::input_recorder: unable to write file"));
+    }
+}
+
+class input_player::native_impl : public wxEvtHandler, private detail::memcheck
+{
+public:
+    native_impl() : m_timer(this), m_speed(1.0), m_next(0), m_playing(false)
+    {
+        Bind(wxEVT_TIMER, &native_impl::on_timer, this);
+    }
+
+    ~native_impl()
+    {
+        m_timer.Stop();
+    }
+
+    input_events& events() { return m_events; }
+
+    void play(wxWindow* root, double speed);
+    void stop();
+    bool is_playing() const { return m_playing; }
+
+    void on_finish(const boost::function<void()>& handler) { m_on_finish = handler; }
+
+private:
+    void on_timer(wxTimerEvent&) { replay_next(); }
+    void schedule();
+    void replay_next();
+    void dispatch(const input_event& e);
+
+    wxWeakRef<wxWindow> m_root;
+    wxTimer m_timer;
+    wxStopWatch m_stopwatch;
+    double m_speed;
+    std::size_t m_next;
+    bool m_playing;
+    input_events m_events;
+    boost::function<void()> m_on_finish;
+};
+
+void input_player::native_impl::play(wxWindow* root, double speed)
+{
+    stop();
+
+    m_root = root;
+    m_speed = speed;
+    m_next = 0;
+    m_playing = true;
+    m_stopwatch.Start();
+
+    schedule();
+}
+
+void input_player::native_impl::stop()
+{
+    m_timer.Stop();
+    m_playing = false;
+}
+
+void input_player::native_impl::schedule()
+{
+    if ( m_next >= m_events.size() )
+    {
+        m_playing = false;
+        if ( m_on_finish )
+            m_on_finish();
+        return;
+    }
+
+    long delay = 0;
+    if ( m_speed > 0 )
+    {
+        const boost::int64_t due = static_cast<boost::int64_t>(m_events[m_next].time / m_speed);
+        delay = static_cast<long>( ( due - m_stopwatch.TimeInMicro().GetValue() ) / 1000 );
+    }
+
+    // Event loop runs between events even if they are already late
+#ifdef wxHAS_CALL_AFTER
+    if ( delay <= 0 )
+    {
+        CallAfter(&native_impl::replay_next);
+        return;
+    }
+#endif
+    m_timer.StartOnce(std::max(delay, 1L));
+}
+
+void input_player::native_impl::replay_next()
+{
+    if ( !m_playing )
+        return;
+
+    if ( !m_root )
+    {
+        stop();
+        return;
+    }
+
+    dispatch(m_events[m_next++]);
+
+    if ( m_playing )
+        schedule();
+}
+
+void input_player::native_impl::dispatch(const input_event& e)
+{
+    wxWindow* window = find_window(m_root, e.path);
+    if ( !window )
+        return;
+
+    const wxEventType type = kind_event_type(e.kind);
+
+    if ( is_mouse_kind(e.kind) )
+    {
+        wxMouseEvent me(type);
+        me.SetEventObject(window);
+        me.SetId(window->GetId());
+        me.SetX(e.x);
+        me.SetY(e.y);
+        set_keyboard_state(me, e.state);
+        me.SetLeftDown(   ( e.state & left_flag   ) != 0 );
+        me.SetMiddleDown( ( e.state & middle_flag ) != 0 );
+        me.SetRightDown(  ( e.state & right_flag  ) != 0 );
+        me.m_wheelRotation = e.rotation;
+        me.m_wheelDelta = e.delta;
+        me.m_linesPerAction = e.lines;
+        me.m_wheelAxis = static_cast<wxMouseWheelAxis>(e.axis);
+        window->GetEventHandler()->SafelyProcessEvent(me);
+    }
+    else
+    {
+        wxKeyEvent ke(type);
+        ke.SetEventObject(window);
+        ke.SetId(window->GetId());
+        set_keyboard_state(ke, e.state);
+        ke.m_keyCode = static_cast<int>(e.key_code);
+#if wxUSE_UNICODE
+        ke.m_uniChar = static_cast<wxChar>(e.unicode);
+#endif
+        window->GetEventHandler()->SafelyProcessEvent(ke);
+    }
+}
+
+input_player::input_player(const uistring& path)
+{
+    wxFFile file;
+    if ( !file.Open(native::from_uistring(path), "rb") )
+        BOOST_THROW_EXCEPTION(std::runtime_error("ui::input_player: unable to open file"));
+
+    const wxFileOffset length = file.Length();
+    if ( length < 0 )
+        BOOST_THROW_EXCEPTION(std::runtime_error("ui::input_player: unable to read file"));
+
+    std::vector<unsigned char> data(static_cast<std::size_t>(length) + 1);
+    if ( file.Read(&data[0], data.size() - 1) != data.size() - 1 )
+        BOOST_THROW_EXCEPTION(std::runtime_error("ui::input_player: unable to read file"));
+
+    input_events events;
+    input_buffer buffer(&data[0], data.size() - 1);
+    read_events(buffer, events);
+
+    m_impl = new native_impl;
+    m_impl->events().swap(events);
+}
+
+input_player::~input_player()
+{
+    delete m_impl;
+}
+
+std::size_t input_player::size() const
+{
+    return m_impl->events().size();
+}
+
+void input_player::play(widget& root, double speed)
+{
+    wxWindow* impl = native::from_widget(root);
+    wxCHECK_RET(impl, "Widget should be created");
+
+    m_impl->play(impl, speed);
+}
+
+void input_player::stop()
+{
+    m_impl->stop();
+}
+
+bool input_player::is_playing() const
+{
+    return m_impl->is_playing();
+}
+
+input_player& input_player::on_finish(const boost::function<void()>& handler)
+{
+    m_impl->on_finish(handler);
+    return *this;
+}
+
+} // namespace ui
+} // namespace boost
@@ -110,31 +110,39 @@ uistring list_box::selected_string() const
 #endif
 }
 
-void list_box::on_select_raw(const boost::function<void()>& handler)
+connection list_box::on_select_raw(const boost::function<void()>& handler, bool replace)
 {
 #if wxUSE_LISTBOX
-    native::bind_helper(*this, wxEVT_LISTBOX, handler);
+    return native::bind_helper(*this, wxEVT_LISTBOX, handler, replace);
+#else
+    return connection();
 #endif
 }
 
-void list_box::on_select_event_raw(const boost::function<void(index_event&)>& handler)
+connection list_box::on_select_event_raw(const boost::function<void(index_event&)>& handler, bool replace)
 {
 #if wxUSE_LISTBOX
-    native::bind_event_helper(*this, wxEVT_LISTBOX, handler);
+    return native::bind_event_helper(*this, wxEVT_LISTBOX, handler, replace);
+#else
+    return connection();
 #endif
 }
 
-void list_box::on_activate_raw(const boost::function<void()>& handler)
+connection list_box::on_activate_raw(const boost::function<void()>& handler, bool replace)
 {
 #if wxUSE_LISTBOX
-    native::bind_helper(*this, wxEVT_LISTBOX_DCLICK, handler);
+    return native::bind_helper(*this, wxEVT_LISTBOX_DCLICK, handler, replace);
+#else
+    return connection();
 #endif
 }
 
-void list_box::on_activate_event_raw(const boost::function<void(index_event&)>& handler)
+connection list_box::on_activate_event_raw(const boost::function<void(index_event&)>& handler, bool replace)
 {
 #if wxUSE_LISTBOX
-    native::bind_event_helper(*this, wxEVT_LISTBOX_DCLICK, handler);
+    return native::bind_event_helper(*this, wxEVT_LISTBOX_DCLICK, handler, replace);
+#else
+    return connection();
 #endif
 }
 
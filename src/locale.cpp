@@ -12,8 +12,18 @@
 #include <wx/intl.h>
 #include <wx/log.h>
 
+#include <boost/cstdint.hpp>
+#include <boost/core/ignore_unused.hpp>
+
+#include <algorithm>
+#include <utility>
 #include <stdexcept> // std::runtime_error
 
+#ifndef BOOST_NO_CXX11_HDR_THREAD
+#include <thread>
+#include <exception>
+#endif
+
 namespace boost {
 namespace ui    {
 
@@ -37,5 +47,178 @@ std::locale getloc()
     }
 }
 
+namespace {
+
+// Appends transformed character with order preserving variable length
+// encoding, so encoded keys are ordered as transformed strings
+void append_key_unit(std::string& key, boost::uint32_t value)
+{
+    if ( value < 0x80 )
+        key.push_back(static_cast<char>(value));
+    else if ( value < 0x4000 )
+    {
+        key.push_back(static_cast<char>(0x80 | ( value >> 8 )));
+        key.push_back(static_cast<char>(value & 0xFF));
+    }
+    else if ( value < 0x200000 )
+    {
+        key.push_back(static_cast<char>(0xC0 | ( value >> 16 )));
+        key.push_back(static_cast<char>(( value >> 8 ) & 0xFF));
+        key.push_back(static_cast<char>(value & 0xFF));
+    }
+    else if ( value < 0x10000000 )
+    {
+        key.push_back(static_cast<char>(0xE0 | ( value >> 24 )));
+        key.push_back(static_cast<char>(( value >> 16 ) & 0xFF));
+        key.push_back(static_cast<char>(( value >> 8 ) & 0xFF));
+        key.push_back(static_cast<char>(value & 0xFF));
+    }
+    else
+    {
+        key.push_back(static_cast<char>(0xF0));
+        key.push_back(static_cast<char>(value >> 24));
+        key.push_back(static_cast<char>(( value >> 16 ) & 0xFF));
+        key.push_back(static_cast<char>(( value >> 8 ) & 0xFF));
+        key.push_back(static_cast<char>(value & 0xFF));
+    }
+}
+
+// Sort key and index of the string
+typedef std::pair<std::string, std::size_t> keyed_index;
+
+void sort_keys(const collator& coll, const std::vector<uistring>& strings,
+               std::vector<keyed_index>& keys, std::size_t first, std::size_t last)
+{
+    for ( std::size_t i = first; i < last; i++ )
+    {
+        keys[i].first = coll.sort_key(strings[i]);
+        keys[i].second = i;
+    }
+    std::sort(keys.begin() + first, keys.begin() + last);
+}
+
+void reorder(std::vector<uistring>& strings, const std::vector<keyed_index>& keys)
+{
+    std::vector<uistring> result(strings.size());
+    for ( std::size_t i = 0; i < keys.size(); i++ )
+        result[i].swap(strings[keys[i].second]);
+    strings.swap(result);
+}
+
+} // unnamed namespace
+
+collator::collator()
+    : m_locale(ui::getloc()),
+      m_collate(&std::use_facet< std::collate<wchar_t> >(m_locale))
+{
+}
+
+collator::collator(const std::locale& loc)
+    : m_locale(loc),
+      m_collate(&std::use_facet< std::collate<wchar_t> >(m_locale))
+{
+}
+
+std::string collator::sort_key(const uistring& str) const
+{
+    const std::wstring wide = str.wstring();
+    const std::wstring transformed = m_collate->transform(wide.data(),
+                                                          wide.data() + wide.size());
+    std::string result;
+    result.reserve(transformed.size());
+    for ( std::wstring::const_iterator iter = transformed.begin();
+          iter != transformed.end(); ++iter )
+    {
+        if ( sizeof(wchar_t) == 2 )
+            append_key_unit(result, static_cast<boost::uint16_t>(*iter));
+        else
+            append_key_unit(result, static_cast<boost::uint32_t>(*iter));
+    }
+    return result;
+}
+
+int collator::compare(const uistring& lhs, const uistring& rhs) const
+{
+    const std::wstring lhs_wide = lhs.wstring();
+    const std::wstring rhs_wide = rhs.wstring();
+    return m_collate->compare(lhs_wide.data(), lhs_wide.data() + lhs_wide.size(),
+                              rhs_wide.data(), rhs_wide.data() + rhs_wide.size());
+}
+
+void collator::sort(std::vector<uistring>& strings) const
+{
+    std::vector<keyed_index> keys(strings.size());
+    sort_keys(*this, strings, keys, 0, keys.size());
+    reorder(strings, keys);
+}
+
+void collator::parallel_sort(std::vector<uistring>& strings, unsigned threads) const
+{
+#ifndef BOOST_NO_CXX11_HDR_THREAD
+    if ( threads == 0 )
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    // Small ranges aren't worth starting threads
+    const std::size_t min_range = 1024;
+    threads = static_cast<unsigned>(std::min<std::size_t>(threads, strings.size() / min_range));
+    if ( threads <= 1 )
+    {
+        sort(strings);
+        return;
+    }
+
+    std::vector<std::size_t> bounds(threads + 1);
+    for ( unsigned i = 0; i <= threads; i++ )
+        bounds[i] = strings.size() * i / threads;
+
+    // Each thread makes and sorts keys of its range
+    std::vector<keyed_index> keys(strings.size());
+    std::vector<std::exception_ptr> errors(threads);
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for ( unsigned i = 0; i < threads; i++ )
+    {
+        const std::size_t first = bounds[i];
+        const std::size_t last = bounds[i + 1];
+        std::exception_ptr& error = errors[i];
+        const auto task = [this, &strings, &keys, &error, first, last]()
+        {
+            try
+            {
+                sort_keys(*this, strings, keys, first, last);
+            }
+            catch(...)
+            {
+                error = std::current_exception();
+            }
+        };
+        if ( i + 1 < threads )
+            workers.emplace_back(task);
+        else
+            task();
+    }
+    for ( std::size_t i = 0; i < workers.size(); i++ )
+        workers[i].join();
+    for ( std::size_t i = 0; i < errors.size(); i++ )
+        if ( errors[i] )
+            std::rethrow_exception(errors[i]);
+
+    // Sorted ranges are merged pairwise
+    for ( unsigned width = 1; width < threads; width *= 2 )
+    {
+        for ( unsigned i = 0; i + width < threads; i += width * 2 )
+        {
+            std::inplace_merge(keys.begin() + bounds[i],
+                               keys.begin() + bounds[i + width],
+                               keys.begin() + bounds[std::min(i + width * 2, threads)]);
+        }
+    }
+    reorder(strings, keys);
+#else
+    boost::ignore_unused(threads);
+    sort(strings);
+#endif
+}
+
 } // namespace ui
 } // namespace boost
@@ -8,32 +8,458 @@
 #include <boost/ui/native/config.hpp>
 
 #include <boost/ui/log.hpp>
+#include <boost/ui/async_log.hpp>
 #include <boost/ui/native/string.hpp>
 
 #include <wx/log.h>
+#include <wx/thread.h>
+#include <wx/time.h>
+
+#include <boost/cstdint.hpp>
+
+#include <map>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <streambuf>
+#include <utility> // std::move
+
+#ifndef BOOST_NO_CXX11_HDR_ATOMIC
+#include <atomic>
+#endif
 
 namespace boost {
 namespace ui    {
 
+namespace {
+
+// One of BOOST_UI_LOG_LEVEL_* values
+#ifndef BOOST_NO_CXX11_HDR_ATOMIC
+std::atomic<int> g_min_level(BOOST_UI_LOG_LEVEL_TRACE);
+#else
+volatile int g_min_level = BOOST_UI_LOG_LEVEL_TRACE;
+#endif
+
+// Appends ASCII characters without temporary strings
+void append_ascii(uistring& str, const char* chars)
+{
+    wchar_t buffer[64];
+    std::size_t size = 0;
+    for ( ; *chars; ++chars )
+    {
+        buffer[size++] = static_cast<unsigned char>(*chars);
+        if ( size == sizeof(buffer) / sizeof(buffer[0]) )
+        {
+            str.append(buffer, size);
+            size = 0;
+        }
+    }
+    str.append(buffer, size);
+}
+
+// Stream buffer that collects characters into the growable storage,
+// storage is kept between uses
+class chars_streambuf : public std::streambuf
+{
+public:
+    void clear() { m_chars.clear(); }
+    const char* data() const { return m_chars.data(); }
+    std::size_t size() const { return m_chars.size(); }
+
+protected:
+    int_type overflow(int_type ch)
+    {
+        if ( !traits_type::eq_int_type(ch, traits_type::eof()) )
+            m_chars.push_back(traits_type::to_char_type(ch));
+        return traits_type::not_eof(ch);
+    }
+
+    std::streamsize xsputn(const char* str, std::streamsize size)
+    {
+        m_chars.append(str, static_cast<std::size_t>(size));
+        return size;
+    }
+
+private:
+    std::string m_chars;
+};
+
+// Nonzero if repeat window or rate limit is set
+#ifndef BOOST_NO_CXX11_HDR_ATOMIC
+std::atomic<int> g_throttled(0);
+#else
+volatile int g_throttled = 0;
+#endif
+
+// Source code location of log messages
+struct log_site
+{
+    log_site(const char* f, int l) : file(f), line(l) {}
+
+    const char* file;
+    int line;
+};
+
+struct log_site_less
+{
+    bool operator()(const log_site& lhs, const log_site& rhs) const
+    {
+        if ( lhs.line != rhs.line )
+            return lhs.line < rhs.line;
+        // The same file name could have different addresses in different modules
+        return lhs.file != rhs.file && std::strcmp(lhs.file, rhs.file) < 0;
+    }
+};
+
+// Throttling state of the location
+struct log_site_state
+{
+    log_site_state()
+        : tokens(0), refill_time(0), message_time(0), suppressed(0),
+          level(0), function(NULL), release_time(0) {}
+
+    double tokens;
+    boost::int64_t refill_time;
+    uistring message;
+    boost::int64_t message_time;
+    unsigned long suppressed;
+
+    // Level and function of the last suppressed message
+    int level;
+    const char* function;
+
+    // Time when the next message from the location would be logged
+    boost::int64_t release_time;
+};
+
+// Count of suppressed messages that is logged without the next message
+struct log_summary
+{
+    log_summary(const log_site& s, const log_site_state& state)
+        : site(s), level(state.level), function(state.function),
+          suppressed(state.suppressed) {}
+
+    log_site site;
+    int level;
+    const char* function;
+    unsigned long suppressed;
+};
+
+typedef std::vector<log_summary> log_summaries;
+
+class log_throttle
+{
+public:
+    log_throttle()
+        : m_repeat_window(0), m_rate(0), m_burst(1), m_next_release(never()) {}
+
+    // Throttle is never destroyed to be used by logging
+    // from static objects destructors
+    static log_throttle& instance()
+    {
+        static log_throttle* result = new log_throttle;
+        return *result;
+    }
+
+    // Counts suppressed under the previous settings are taken by take_summaries()
+    void repeat_window(unsigned milliseconds)
+    {
+        wxCriticalSectionLocker locker(m_lock);
+        collect(true);
+        m_repeat_window = milliseconds;
+        update();
+    }
+
+    void rate_limit(unsigned rate, unsigned burst)
+    {
+        wxCriticalSectionLocker locker(m_lock);
+        collect(true);
+        m_rate = rate;
+        m_burst = burst ? burst : 1;
+        update();
+    }
+
+    // Takes token of the location, counts suppressed message if there are no tokens.
+    // Sets expired if suppressed counts of some locations should be logged.
+    bool take_token(const char* file, int line, int level, const char* fn, bool& expired)
+    {
+        wxCriticalSectionLocker locker(m_lock);
+        expired = !m_ready.empty();
+        if ( !m_rate )
+            return true;
+
+        const boost::int64_t now = wxGetUTCTimeMillis().GetValue();
+        expired = expired || now >= m_next_release;
+        std::pair<sites_type::iterator, bool> inserted =
+            m_sites.insert(sites_type::value_type(log_site(file, line), log_site_state()));
+        log_site_state& state = inserted.first->second;
+
+        if ( inserted.second )
+            state.tokens = m_burst;
+        else if ( now > state.refill_time )
+            state.tokens = std::min<double>(m_burst,
+                state.tokens + double(now - state.refill_time) * m_rate / 1000);
+        state.refill_time = now;
+
+        if ( state.tokens < 1 )
+        {
+            suppress(state, level, fn,
+                now + boost::int64_t(( 1 - state.tokens ) * 1000 / m_rate) + 1);
+            return false;
+        }
+
+        state.tokens -= 1;
+        return true;
+    }
+
+    // Checks repeated message, returns false if the message is suppressed.
+    // Otherwise returns count of previously suppressed messages.
+    // Sets expired like take_token().
+    bool admit(const char* file, int line, int level, const char* fn,
+               const uistring& message, unsigned long& suppressed, bool& expired)
+    {
+        suppressed = 0;
+
+        wxCriticalSectionLocker locker(m_lock);
+        expired = !m_ready.empty();
+        if ( !m_repeat_window && !m_rate )
+            return true;
+
+        const boost::int64_t now = wxGetUTCTimeMillis().GetValue();
+        expired = expired || now >= m_next_release;
+        log_site_state& state = m_sites[log_site(file, line)];
+
+        if ( m_repeat_window && state.message_time &&
+             now - state.message_time < m_repeat_window &&
+             state.message == message )
+        {
+            suppress(state, level, fn, state.message_time + m_repeat_window);
+            return false;
+        }
+
+        if ( m_repeat_window )
+        {
+            state.message = message;
+            state.message_time = now;
+        }
+
+        suppressed = state.suppressed;
+        state.suppressed = 0;
+        state.release_time = 0;
+        return true;
+    }
+
+    // Takes suppressed counts of the locations that would log the next message now,
+    // or of all locations
+    void take_summaries(bool all, log_summaries& result)
+    {
+        wxCriticalSectionLocker locker(m_lock);
+        collect(all);
+        result.swap(m_ready);
+        m_ready.clear();
+    }
+
+private:
+    static boost::int64_t never() { return (std::numeric_limits<boost::int64_t>::max)(); }
+
+    void suppress(log_site_state& state, int level, const char* fn,
+                  boost::int64_t release_time)
+    {
+        state.suppressed++;
+        state.level = level;
+        state.function = fn;
+        state.release_time = std::max(state.release_time, release_time);
+        m_next_release = std::min(m_next_release, state.release_time);
+    }
+
+    // Moves suppressed counts into m_ready
+    void collect(bool all)
+    {
+        if ( !all && m_next_release == never() )
+            return;
+
+        const boost::int64_t now = wxGetUTCTimeMillis().GetValue();
+        if ( !all && now < m_next_release )
+            return;
+
+        m_next_release = never();
+        for ( sites_type::iterator iter = m_sites.begin(); iter != m_sites.end(); ++iter )
+        {
+            log_site_state& state = iter->second;
+            if ( !state.suppressed )
+                continue;
+
+            if ( all || now >= state.release_time )
+            {
+                m_ready.push_back(log_summary(iter->first, state));
+                state.suppressed = 0;
+                state.release_time = 0;
+            }
+            else
+                m_next_release = std::min(m_next_release, state.release_time);
+        }
+    }
+
+    void update()
+    {
+        g_throttled = m_repeat_window || m_rate;
+        if ( !g_throttled )
+            m_sites.clear();
+    }
+
+    typedef std::map<log_site, log_site_state, log_site_less> sites_type;
+
+    wxCriticalSection m_lock;
+    unsigned m_repeat_window;
+    unsigned m_rate;
+    unsigned m_burst;
+    sites_type m_sites;
+
+    // Earliest release time of the locations with suppressed messages
+    boost::int64_t m_next_release;
+    log_summaries m_ready;
+};
+
+} // unnamed namespace
+
+namespace detail {
+
+class log_formatter::buffer
+{
+public:
+    buffer() : m_stream(&m_streambuf), m_busy(false) { reset(); }
+
+    void reset()
+    {
+        m_streambuf.clear();
+        m_stream.clear();
+        m_stream.flags(std::ios_base::boolalpha | std::ios_base::dec |
+                       std::ios_base::skipws);
+        m_stream.precision(6);
+        m_stream.width(0);
+        m_stream.fill(' ');
+    }
+
+    chars_streambuf m_streambuf;
+    std::ostream m_stream;
+    bool m_busy;
+};
+
+} // namespace detail
+
+namespace {
+
+#ifndef BOOST_NO_CXX11_THREAD_LOCAL
+
+// True after the buffers of the current thread are destroyed.
+// Static objects destructors could log after that, they use own buffers.
+thread_local bool g_buffers_destroyed = false;
+
+// Storage that is reused by log statements of the current thread
+struct thread_buffers
+{
+    thread_buffers() : string_busy(false) {}
+    ~thread_buffers() { g_buffers_destroyed = true; }
+
+    detail::log_formatter::buffer formatter;
+    uistring string;
+    bool string_busy;
+};
+
+// Returns NULL if the buffers are destroyed
+thread_buffers* get_thread_buffers()
+{
+    if ( g_buffers_destroyed )
+        return NULL;
+
+    static thread_local thread_buffers buffers;
+    return &buffers;
+}
+
+#endif
+
+} // unnamed namespace
+
+namespace detail {
+
+log_formatter::log_formatter() : m_buffer(NULL), m_owned(false)
+{
+#ifndef BOOST_NO_CXX11_THREAD_LOCAL
+    thread_buffers* buffers = get_thread_buffers();
+    // Value output could log too
+    if ( buffers && !buffers->formatter.m_busy )
+    {
+        buffers->formatter.m_busy = true;
+        m_buffer = &buffers->formatter;
+        return;
+    }
+#endif
+    m_buffer = new buffer;
+    m_owned = true;
+}
+
+log_formatter::~log_formatter()
+{
+    if ( m_owned )
+    {
+        delete m_buffer;
+    }
+    else
+    {
+        m_buffer->reset();
+        m_buffer->m_busy = false;
+    }
+}
+
+std::ostream& log_formatter::stream()
+{
+    return m_buffer->m_stream;
+}
+
+const char* log_formatter::data() const
+{
+    return m_buffer->m_streambuf.data();
+}
+
+std::size_t log_formatter::size() const
+{
+    return m_buffer->m_streambuf.size();
+}
+
+} // namespace detail
+
 log_string::log_string(uistring& str)
-    : m_string(str), m_spaces(true), m_quotes(true)
+    : m_string(str), m_spaces(true), m_quotes(true), m_enabled(true)
+{
+}
+
+log_string::log_string(uistring& str, bool enabled)
+    : m_string(str), m_spaces(true), m_quotes(true), m_enabled(enabled)
 {
 }
 
 log_string& log_string::location(const char* file, int line, const char* fn)
 {
-    std::ostringstream ss;
+    if ( !m_enabled )
+        return *this;
 
     if ( file )
-        ss << file;
+        append_ascii(m_string, file);
     if ( line >= 0 )
-        ss << '[' << line << ']';
+    {
+        m_string.push_back(L'[');
+        append_number(m_string, line);
+        m_string.push_back(L']');
+    }
     if ( fn )
-        ss << ' ' << fn;
-
-    ss << ":";
+    {
+        m_string.push_back(L' ');
+        append_ascii(m_string, fn);
+    }
 
-    m_string.append(ascii(ss.str()));
+    m_string.push_back(L':');
 
     return *this;
 }
@@ -41,13 +467,16 @@ log_string& log_string::location(const char* file, int line, const char* fn)
 void log_string::append_space()
 {
     if ( m_spaces && !m_string.empty() )
-        m_string.append(wxS(" "));
+        m_string.push_back(L' ');
 }
 
 #ifndef BOOST_UI_NO_CAST_FROM_ASCII
 
 log_string& log_string::operator<<(char value)
 {
+    if ( !m_enabled )
+        return *this;
+
     append_space();
 
     if ( m_quotes )
@@ -61,15 +490,18 @@ log_string& log_string::operator<<(char value)
     return *this;
 }
 
-log_string& log_string::operator<<(const std::string& value)
+log_string& log_string::append_string(const char* str, std::size_t size)
 {
-    if ( m_quotes || !value.empty() )
+    if ( !m_enabled )
+        return *this;
+
+    if ( m_quotes || size )
         append_space();
 
     if ( m_quotes )
         m_string.push_back('"');
 
-    m_string.append(value);
+    m_string.append(str, size);
 
     if ( m_quotes )
         m_string.push_back('"');
@@ -77,10 +509,23 @@ log_string& log_string::operator<<(const std::string& value)
     return *this;
 }
 
+log_string& log_string::append_raw(const char* str, std::size_t size)
+{
+    if ( m_quotes || size )
+        append_space();
+
+    m_string.append(str, size);
+
+    return *this;
+}
+
 #endif
 
 log_string& log_string::operator<<(wchar_t value)
 {
+    if ( !m_enabled )
+        return *this;
+
     append_space();
 
     if ( m_quotes )
@@ -94,15 +539,18 @@ log_string& log_string::operator<<(wchar_t value)
     return *this;
 }
 
-log_string& log_string::operator<<(const std::wstring& value)
+log_string& log_string::append_string(const wchar_t* str, std::size_t size)
 {
-    if ( m_quotes || !value.empty() )
+    if ( !m_enabled )
+        return *this;
+
+    if ( m_quotes || size )
         append_space();
 
     if ( m_quotes )
         m_string.push_back('"');
 
-    m_string.append(value);
+    m_string.append(str, size);
 
     if ( m_quotes )
         m_string.push_back('"');
@@ -112,6 +560,9 @@ log_string& log_string::operator<<(const std::wstring& value)
 
 log_string& log_string::operator<<(const uistring& value)
 {
+    if ( !m_enabled )
+        return *this;
+
     if ( m_quotes || !value.empty() )
         append_space();
 
@@ -128,6 +579,9 @@ log_string& log_string::operator<<(const uistring& value)
 
 log_string&  log_string::raw(const uistring& value)
 {
+    if ( !m_enabled )
+        return *this;
+
     if ( m_quotes || !value.empty() )
         append_space();
 
@@ -139,34 +593,259 @@ log_string&  log_string::raw(const uistring& value)
 log::~log()
 {
     flush();
+
+#ifndef BOOST_NO_CXX11_THREAD_LOCAL
+    if ( m_pooled )
+    {
+        thread_buffers* buffers = get_thread_buffers();
+        if ( buffers )
+        {
+            m_string.clear();
+            m_string.swap(buffers->string);
+            buffers->string_busy = false;
+        }
+    }
+#endif
+}
+
+void log::acquire_buffer()
+{
+    m_pooled = false;
+
+#ifndef BOOST_NO_CXX11_THREAD_LOCAL
+    if ( !is_enabled() )
+        return;
+
+    // Message is formatted in the storage of the previous messages
+    // and is copied once when it is complete.
+    // Nested log statements use own strings.
+    thread_buffers* buffers = get_thread_buffers();
+    if ( buffers && !buffers->string_busy )
+    {
+        buffers->string_busy = true;
+        m_string.swap(buffers->string);
+        m_pooled = true;
+    }
+#endif
+}
+
+void log::min_level(log_level level)
+{
+    int value = BOOST_UI_LOG_LEVEL_TRACE;
+    switch ( boost::native_value(level) )
+    {
+        case log_level::fatal:   value = BOOST_UI_LOG_LEVEL_FATAL;   break;
+        case log_level::error:   value = BOOST_UI_LOG_LEVEL_ERROR;   break;
+        case log_level::warning: value = BOOST_UI_LOG_LEVEL_WARNING; break;
+        case log_level::info:    value = BOOST_UI_LOG_LEVEL_INFO;    break;
+        case log_level::verbose: value = BOOST_UI_LOG_LEVEL_VERBOSE; break;
+        case log_level::debug:   value = BOOST_UI_LOG_LEVEL_DEBUG;   break;
+        case log_level::trace:   value = BOOST_UI_LOG_LEVEL_TRACE;   break;
+        default: wxFAIL_MSG(wxS("Unknown log level"));
+    }
+    g_min_level = value;
+}
+
+log_level log::min_level()
+{
+    switch ( g_min_level )
+    {
+        case BOOST_UI_LOG_LEVEL_FATAL:   return log_level::fatal;
+        case BOOST_UI_LOG_LEVEL_ERROR:   return log_level::error;
+        case BOOST_UI_LOG_LEVEL_WARNING: return log_level::warning;
+        case BOOST_UI_LOG_LEVEL_INFO:    return log_level::info;
+        case BOOST_UI_LOG_LEVEL_VERBOSE: return log_level::verbose;
+        case BOOST_UI_LOG_LEVEL_DEBUG:   return log_level::debug;
+        default:                         return log_level::trace;
+    }
+}
+
+bool log::enabled(log_level level)
+{
+    switch ( boost::native_value(level) )
+    {
+        case log_level::fatal:   return level_enabled(fatal_level);
+        case log_level::error:   return level_enabled(error_level);
+        case log_level::warning: return level_enabled(warning_level);
+        case log_level::info:    return level_enabled(info_level);
+        case log_level::verbose: return level_enabled(verbose_level);
+        case log_level::debug:   return level_enabled(debug_level);
+        case log_level::trace:   return level_enabled(trace_level);
+    }
+    return false;
+}
+
+log& log::location(const char* file, int line, const char* fn)
+{
+    if ( !is_enabled() )
+        return *this;
+
+    if ( g_throttled && m_level != fatal_level && file )
+    {
+        m_file = file;
+        m_line = line;
+        m_function = fn;
+
+        bool expired = false;
+        const bool taken = log_throttle::instance().take_token(file, line, m_level, fn, expired);
+        if ( expired )
+            write_suppressed(false);
+        if ( !taken )
+        {
+            disable();
+            return *this;
+        }
+    }
+
+    log_string::location(file, line, fn);
+    return *this;
+}
+
+void log::repeat_window(unsigned milliseconds)
+{
+    log_throttle::instance().repeat_window(milliseconds);
+    write_suppressed(false);
+}
+
+void log::rate_limit(unsigned rate, unsigned burst)
+{
+    log_throttle::instance().rate_limit(rate, burst);
+    write_suppressed(false);
+}
+
+void log::flush_suppressed()
+{
+    write_suppressed(true);
+}
+
+bool log::level_enabled(level_values level)
+{
+    // Values of level_values and BOOST_UI_LOG_LEVEL_* are the same
+    if ( static_cast<int>(level) > g_min_level )
+        return false;
+
+    // Don't format messages that wxWidgets would discard
+    switch ( level )
+    {
+        case verbose_level:
+            return wxLog::GetVerbose();
+        case debug_level:
+#if wxDEBUG_LEVEL
+            return true;
+#else
+            return false;
+#endif
+        default:
+            return true;
+    }
 }
 
 void log::flush()
 {
-    switch ( m_level )
+    if ( !is_enabled() )
+        return;
+
+    if ( m_file )
+    {
+        unsigned long suppressed = 0;
+        bool expired = false;
+        const bool admitted = log_throttle::instance().admit(m_file, m_line,
+            m_level, m_function, m_string, suppressed, expired);
+        if ( expired )
+            write_suppressed(false);
+        if ( !admitted )
+            return;
+
+        if ( suppressed )
+            write_summary(m_level, m_file, m_line, m_function, suppressed);
+    }
+
+    write(m_level, m_string, !m_pooled);
+}
+
+void log::write_summary(level_values level, const char* file, int line,
+                        const char* fn, unsigned long suppressed)
+{
+    uistring summary;
+    log_string(summary).noquotes().location(file, line, fn)
+        .raw(to_uistring(suppressed))
+        << L"similar messages suppressed";
+    write(level, summary, true);
+}
+
+void log::write_suppressed(bool all)
+{
+    log_summaries summaries;
+    log_throttle::instance().take_summaries(all, summaries);
+
+    for ( log_summaries::const_iterator iter = summaries.begin();
+          iter != summaries.end(); ++iter )
+    {
+        write_summary(static_cast<level_values>(iter->level),
+                      iter->site.file, iter->site.line, iter->function, iter->suppressed);
+    }
+}
+
+void log::write(level_values level, uistring& message, bool movable)
+{
+    if ( async_log* backend = async_log::installed() )
+    {
+        log_level record_level = log_level::debug;
+        switch ( level )
+        {
+            case fatal_level:
+                // Fatal error terminates application synchronously
+                // after writing previous records
+                backend->flush();
+                break;
+            case error_level:   record_level = log_level::error;   break;
+            case warning_level: record_level = log_level::warning; break;
+            case info_level:    record_level = log_level::info;    break;
+            case verbose_level: record_level = log_level::verbose; break;
+            case debug_level:   record_level = log_level::debug;   break;
+            case trace_level:   record_level = log_level::trace;   break;
+        }
+
+        if ( level != fatal_level )
+        {
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+            if ( movable )
+            {
+                backend->push(record_level, std::move(message));
+                return;
+            }
+#else
+            (void)movable;
+#endif
+            backend->push(record_level, message);
+            return;
+        }
+    }
+
+    switch ( level )
     {
         case fatal_level:
-            wxLogFatalError(wxS("%s"), native::from_uistring(m_string));
+            wxLogFatalError(wxS("%s"), native::from_uistring(message));
             break;
         case error_level:
-            wxLogError(wxS("%s"), native::from_uistring(m_string));
+            wxLogError(wxS("%s"), native::from_uistring(message));
             break;
         case warning_level:
-            wxLogWarning(wxS("%s"), native::from_uistring(m_string));
+            wxLogWarning(wxS("%s"), native::from_uistring(message));
             break;
         case info_level:
-            wxLogMessage(wxS("%s"), native::from_uistring(m_string));
+            wxLogMessage(wxS("%s"), native::from_uistring(message));
             break;
         case verbose_level:
-            wxLogVerbose(wxS("%s"), native::from_uistring(m_string));
+            wxLogVerbose(wxS("%s"), native::from_uistring(message));
             break;
         default:
             wxFAIL_MSG(wxS("Unknown log level"));
         case debug_level:
-            wxLogDebug(wxS("%s"), native::from_uistring(m_string));
+            wxLogDebug(wxS("%s"), native::from_uistring(message));
             break;
         case trace_level:
-            wxLogTrace(wxS("%s"), native::from_uistring(m_string));
+            wxLogTrace(wxS("%s"), native::from_uistring(message));
             break;
     }
 }
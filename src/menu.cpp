@@ -14,6 +14,9 @@
 
 #include <wx/menu.h>
 
+#include <vector>
+#include <algorithm>
+
 namespace boost {
 namespace ui    {
 
@@ -65,13 +68,47 @@ class menu::item::native_impl : public wxMenuItem
 public:
     native_impl(const uistring& text)
         : wxMenuItem(NULL, wxID_ANY, native::from_uistring(text)) {}
+    ~native_impl();
 
     void on_menu();
 
-    typedef std::vector< boost::function<void()> > menu_handlers_type;
+    connection connect(const boost::function<void()>& handler, bool replace);
+
+private:
+    class handler_connection;
+
+    void remove(handler_connection* c);
+
+    typedef std::vector<handler_connection*> menu_handlers_type;
     menu_handlers_type m_menu_handlers;
 };
 
+class menu::item::native_impl::handler_connection : public detail::connection_state
+{
+public:
+    handler_connection(native_impl* item, const boost::function<void()>& handler)
+        : m_item(item), m_handler(handler) {}
+
+    void call() { m_handler(); }
+
+    void detach_item()
+    {
+        m_item = NULL;
+        detach();
+    }
+
+protected:
+    void do_disconnect()
+    {
+        if ( m_item )
+            m_item->remove(this);
+    }
+
+private:
+    native_impl* m_item;
+    const boost::function<void()> m_handler;
+};
+
 void menu::native_impl::on_menu(wxCommandEvent& event)
 {
     wxMenuItem* rawitem = FindItem(event.GetId());
@@ -83,12 +120,59 @@ void menu::native_impl::on_menu(wxCommandEvent& event)
     item->on_menu();
 }
 
+menu::item::native_impl::~native_impl()
+{
+    for ( menu_handlers_type::iterator iter = m_menu_handlers.begin();
+            iter != m_menu_handlers.end(); ++iter )
+    {
+        (*iter)->detach_item();
+        (*iter)->release();
+    }
+}
+
 void menu::item::native_impl::on_menu()
 {
-    for ( menu_handlers_type::const_reverse_iterator iter = m_menu_handlers.rbegin();
-            iter != m_menu_handlers.rend(); ++iter )
+    // Handlers could disconnect each other
+    const menu_handlers_type handlers(m_menu_handlers.rbegin(), m_menu_handlers.rend());
+    const std::vector<connection> holders(handlers.begin(), handlers.end());
+
+    for ( menu_handlers_type::const_iterator iter = handlers.begin();
+            iter != handlers.end(); ++iter )
     {
-        (*iter)();
+        if ( (*iter)->connected() )
+            (*iter)->call();
+    }
+}
+
+connection menu::item::native_impl::connect(const boost::function<void()>& handler,
+                                            bool replace)
+{
+    if ( replace )
+    {
+        std::vector<connection> previous(m_menu_handlers.begin(),
+                                         m_menu_handlers.end());
+        for ( std::vector<connection>::iterator iter = previous.begin();
+                iter != previous.end(); ++iter )
+        {
+            iter->disconnect();
+        }
+    }
+
+    handler_connection* c = new handler_connection(this, handler);
+    c->add_ref();
+    m_menu_handlers.push_back(c);
+
+    return connection(c);
+}
+
+void menu::item::native_impl::remove(handler_connection* c)
+{
+    menu_handlers_type::iterator iter =
+        std::find(m_menu_handlers.begin(), m_menu_handlers.end(), c);
+    if ( iter != m_menu_handlers.end() )
+    {
+        m_menu_handlers.erase(iter);
+        c->release();
     }
 }
 
@@ -206,11 +290,15 @@ menu::item::item(const uistring& text)
 #endif
 }
 
-void menu::item::on_press_raw(const boost::function<void()>& handler)
+connection menu::item::on_press_raw(const boost::function<void()>& handler, bool replace)
 {
-    wxCHECK_RET(m_impl, "Widget should be created");
+    wxCHECK_MSG(m_impl, connection(), "Widget should be created");
 
-    m_impl->m_menu_handlers.push_back(handler);
+#if wxUSE_MENUS
+    return m_impl->connect(handler, replace);
+#else
+    return connection();
+#endif
 }
 
 } // namespace ui
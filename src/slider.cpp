@@ -120,17 +120,21 @@ void slider::check_range(value_type value, value_type min, value_type max)
         BOOST_THROW_EXCEPTION(std::out_of_range("ui::slider::check_range(): invalid value"));
 }
 
-void slider::on_slide_raw(const boost::function<void()>& handler)
+connection slider::on_slide_raw(const boost::function<void()>& handler, bool replace)
 {
 #if wxUSE_SLIDER
-    native::bind_helper(*this, wxEVT_SLIDER, handler);
+    return native::bind_helper(*this, wxEVT_SLIDER, handler, replace);
+#else
+    return connection();
 #endif
 }
 
-void slider::on_slide_end_raw(const boost::function<void()>& handler)
+connection slider::on_slide_end_raw(const boost::function<void()>& handler, bool replace)
 {
 #if wxUSE_SLIDER
-    native::bind_helper(*this, wxEVT_SCROLL_THUMBRELEASE, handler);
+    return native::bind_helper(*this, wxEVT_SCROLL_THUMBRELEASE, handler, replace);
+#else
+    return connection();
 #endif
 }
 
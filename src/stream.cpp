@@ -8,22 +8,25 @@
 #include <boost/ui/native/config.hpp>
 
 #include <boost/ui/stream.hpp>
-#include <boost/ui/native/string.hpp>
-
-#include <wx/string.h>
 
 namespace boost {
 namespace ui    {
 
 uiostringstream& uiostringstream::operator<<(float value)
 {
-    m_buffer += native::to_uistring(wxString() << value);
+    append_number(m_buffer, value);
     return *this;
 }
 
 uiostringstream& uiostringstream::operator<<(double value)
 {
-    m_buffer += native::to_uistring(wxString() << value);
+    append_number(m_buffer, value);
+    return *this;
+}
+
+uiostringstream& uiostringstream::operator<<(long double value)
+{
+    append_number(m_buffer, value);
     return *this;
 }
 
@@ -10,36 +10,704 @@
 #include <boost/ui/string.hpp>
 #include <boost/ui/string_io.hpp>
 #include <boost/ui/native/string.hpp>
+#include <boost/ui/detail/utf.hpp>
 #include <boost/ui/detail/memcheck.hpp>
 
-#include <boost/functional/hash.hpp>
+#include <boost/cstdint.hpp>
 
 #include <wx/string.h>
 #include <wx/log.h>
 
 #include <stdio.h> // for snprintf()
+#include <stdlib.h> // for strtod()
+#include <float.h>
+#include <cstring>
+#include <cwchar>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#if defined(__has_include) && \
+    ( __cplusplus >= 201703L || ( defined(_MSVC_LANG) && _MSVC_LANG >= 201703L ) )
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#define BOOST_UI_DETAIL_TO_CHARS
+#endif
+
+#ifndef BOOST_NO_CXX11_HDR_ATOMIC
+#include <atomic>
+#endif
 
 namespace boost {
 namespace ui    {
 
+// Long string is stored in wxString. Appending to string larger than
+// rope_threshold collects appended pieces into chunks instead of reallocation,
+// chunks are joined when contiguous native string is required.
 class uistring::impl : public wxString, private detail::memcheck
 {
+public:
+    impl() { init(); }
+    impl(const impl& other) : wxString(other), m_rope(other.m_rope) { init(); }
+    explicit impl(const wxString& str) : wxString(str) { init(); }
+
+    enum { rope_threshold = 1 << 20, chunk_size = 1 << 16 };
+
+    bool is_rope() const { return !m_rope.empty(); }
+
+    // Returns count of native strings, the first one is this object
+    std::size_t pieces() const { return m_rope.size() + 1; }
+
+    const wxString& piece(std::size_t index) const
+        { return index == 0 ? static_cast<const wxString&>(*this) : m_rope[index - 1]; }
+
+    std::size_t total_length() const
+    {
+        std::size_t result = length();
+        for ( std::vector<wxString>::const_iterator iter = m_rope.begin();
+              iter != m_rope.end(); ++iter )
+            result += iter->length();
+        return result;
+    }
+
+    void copy_from(const impl& other)
+    {
+        wxString::operator=(other);
+        m_rope = other.m_rope;
+    }
+
+    void assign_native(const wxString& str)
+    {
+        m_rope.clear();
+        wxString::operator=(str);
+    }
+
+    void append_piece(const wxString& str) { tail(str.length()).append(str); }
+
+    void append_piece(const wchar_t* str, std::size_t size)
+        { tail(size).append(str, size); }
+
+    template <class Char>
+    void append_piece(std::size_t count, Char ch) { tail(count).append(count, ch); }
+
+    // Clears string keeping the storage of the contiguous part
+    void clear_contents() BOOST_NOEXCEPT
+    {
+        wxString::clear();
+        std::vector<wxString>().swap(m_rope);
+    }
+
+    void flatten()
+    {
+        if ( m_rope.empty() )
+            return;
+
+        reserve(total_length());
+        for ( std::vector<wxString>::const_iterator iter = m_rope.begin();
+              iter != m_rope.end(); ++iter )
+            append(*iter);
+        m_rope.clear();
+    }
+
+    // Returns copy of joined chunks
+    wxString joined() const
+    {
+        if ( m_rope.empty() )
+            return *this;
+
+        wxString result;
+        result.reserve(total_length());
+        for ( std::size_t i = 0; i < pieces(); i++ )
+            result.append(piece(i));
+        return result;
+    }
+
+#ifndef BOOST_NO_CXX11_HDR_ATOMIC
+    enum { hash_unknown = 0, hash_disabled = 1 };
+
+    // Cached hash_value() or hash_unknown or hash_disabled
+    std::atomic<std::size_t> m_hash;
+#endif
+
+    void changed()
+    {
+#ifndef BOOST_NO_CXX11_HDR_ATOMIC
+        if ( m_hash.load(std::memory_order_relaxed) != hash_disabled )
+            m_hash.store(hash_unknown, std::memory_order_relaxed);
+#endif
+    }
+
+    void disable_hash_cache()
+    {
+#ifndef BOOST_NO_CXX11_HDR_ATOMIC
+        // String could be changed using native handle without notification
+        m_hash.store(hash_disabled, std::memory_order_relaxed);
+#endif
+    }
+
+private:
+    void init()
+    {
+#ifndef BOOST_NO_CXX11_HDR_ATOMIC
+        m_hash.store(hash_unknown, std::memory_order_relaxed);
+#endif
+    }
+
+    // Returns native string to append size code units to
+    wxString& tail(std::size_t size)
+    {
+        if ( m_rope.empty() && length() + size < rope_threshold )
+            return *this;
+
+        if ( m_rope.empty() || m_rope.back().length() + size > chunk_size )
+        {
+            m_rope.push_back(wxString());
+            m_rope.back().reserve(std::max<std::size_t>(size, chunk_size));
+        }
+        return m_rope.back();
+    }
+
+    std::vector<wxString> m_rope;
+};
+
+namespace {
+
+bool is_ascii(const char* str, std::size_t size)
+{
+    return detail::utf::ascii_prefix(str, size) == size;
+}
+
+// Returns count of UTF-8 code units of the code point or 0 if it is invalid
+std::size_t utf8_size(unsigned long cp)
+{
+    if ( cp < 0x80 )
+        return 1;
+    if ( cp < 0x800 )
+        return 2;
+    if ( cp >= 0xD800 && cp <= 0xDFFF )
+        return 0;
+    if ( cp < 0x10000 )
+        return 3;
+    if ( cp < 0x110000 )
+        return 4;
+    return 0;
+}
+
+char* utf8_put(unsigned long cp, char* out)
+{
+    switch ( utf8_size(cp) )
+    {
+        case 1:
+            *out++ = static_cast<char>(cp);
+            break;
+        case 2:
+            *out++ = static_cast<char>(0xC0 | ( cp >> 6 ));
+            *out++ = static_cast<char>(0x80 | ( cp & 0x3F ));
+            break;
+        case 3:
+            *out++ = static_cast<char>(0xE0 | ( cp >> 12 ));
+            *out++ = static_cast<char>(0x80 | ( ( cp >> 6 ) & 0x3F ));
+            *out++ = static_cast<char>(0x80 | ( cp & 0x3F ));
+            break;
+        case 4:
+            *out++ = static_cast<char>(0xF0 | ( cp >> 18 ));
+            *out++ = static_cast<char>(0x80 | ( ( cp >> 12 ) & 0x3F ));
+            *out++ = static_cast<char>(0x80 | ( ( cp >> 6 ) & 0x3F ));
+            *out++ = static_cast<char>(0x80 | ( cp & 0x3F ));
+            break;
+    }
+    return out;
+}
+
+// Reads code point from wide string, combines UTF-16 surrogate pairs
+template <class Char>
+unsigned long wide_get(const Char*& str, const Char* end)
+{
+    unsigned long cp = static_cast<unsigned long>(*str++);
+    if ( sizeof(Char) == 2 && cp >= 0xD800 && cp < 0xDC00 && str != end )
+    {
+        const unsigned long low = static_cast<unsigned long>(*str);
+        if ( low >= 0xDC00 && low <= 0xDFFF )
+        {
+            ++str;
+            cp = 0x10000 + ( ( cp - 0xD800 ) << 10 ) + ( low - 0xDC00 );
+        }
+    }
+    return cp;
+}
+
+// Reads code point from valid UTF-8 string
+unsigned long utf8_get(const char*& str)
+{
+    const unsigned char lead = static_cast<unsigned char>(*str++);
+    if ( lead < 0x80 )
+        return lead;
+
+    int count = lead >= 0xF0 ? 3 : lead >= 0xE0 ? 2 : 1;
+    unsigned long cp = lead & ( 0x3F >> count );
+    while ( count-- )
+        cp = ( cp << 6 ) | ( static_cast<unsigned char>(*str++) & 0x3F );
+    return cp;
+}
+
+// Encodes wide string into UTF-8 buffer,
+// returns false if buffer is too small or string has invalid code points
+template <class Char>
+bool wide_to_utf8(const Char* str, std::size_t size,
+                  char* buffer, std::size_t capacity, std::size_t& result_size)
+{
+    const Char* const end = str + size;
+    char* out = buffer;
+    while ( str != end )
+    {
+        const unsigned long cp = wide_get(str, end);
+        const std::size_t count = utf8_size(cp);
+        if ( count == 0 || static_cast<std::size_t>(buffer + capacity - out) < count )
+            return false;
+        out = utf8_put(cp, out);
+    }
+    result_size = out - buffer;
+    return true;
+}
+
+#if !wxUSE_UNICODE_UTF8
+// Reads code points from native string pieces,
+// combines UTF-16 surrogate pairs split between pieces
+template <class Impl>
+class code_point_reader
+{
+public:
+    explicit code_point_reader(const Impl& str) : m_str(str), m_piece(0), m_pos(0) {}
+
+    bool done()
+    {
+        skip_empty();
+        return m_piece == m_str.pieces();
+    }
+
+    // Should be called when done() is false
+    unsigned long get()
+    {
+        const wxString& piece = m_str.piece(m_piece);
+        const wchar_t* str = piece.wx_str() + m_pos;
+        const wchar_t* const end = piece.wx_str() + piece.length();
+        unsigned long cp = wide_get(str, end);
+        m_pos = str - piece.wx_str();
+        if ( sizeof(wchar_t) == 2 && cp >= 0xD800 && cp < 0xDC00 && str == end && !done() )
+        {
+            const unsigned long low =
+                static_cast<unsigned long>(m_str.piece(m_piece).wx_str()[m_pos]);
+            if ( low >= 0xDC00 && low <= 0xDFFF )
+            {
+                ++m_pos;
+                cp = 0x10000 + ( ( cp - 0xD800 ) << 10 ) + ( low - 0xDC00 );
+            }
+        }
+        return cp;
+    }
+
+private:
+    void skip_empty()
+    {
+        while ( m_piece < m_str.pieces() && m_pos == m_str.piece(m_piece).length() )
+            ++m_piece, m_pos = 0;
+    }
+
+    const Impl& m_str;
+    std::size_t m_piece;
+    std::size_t m_pos;
 };
+#endif
 
-void uistring::init()
+// Compares UTF-8 string with native string pieces by code points
+template <class Impl>
+int compare_code_points(const char* lhs, std::size_t lhs_size, const Impl& rhs)
 {
-    m_impl = new impl;
+    const char* const lhs_end = lhs + lhs_size;
+#if wxUSE_UNICODE_UTF8
+    for ( std::size_t i = 0; i < rhs.pieces(); i++ )
+    {
+        const wxString& piece = rhs.piece(i);
+        const std::size_t size = std::min<std::size_t>(lhs_end - lhs, piece.utf8_length());
+        const int result = std::memcmp(lhs, piece.wx_str(), size);
+        if ( result != 0 )
+            return result < 0 ? -1 : 1;
+        lhs += size;
+        if ( size < piece.utf8_length() )
+            return -1;
+    }
+    return lhs != lhs_end ? 1 : 0;
+#else
+    code_point_reader<Impl> reader(rhs);
+    while ( lhs != lhs_end && !reader.done() )
+    {
+        const unsigned long a = utf8_get(lhs);
+        const unsigned long b = reader.get();
+        if ( a != b )
+            return a < b ? -1 : 1;
+    }
+    return lhs != lhs_end ? 1 : reader.done() ? 0 : -1;
+#endif
 }
 
-uistring::uistring()
+// Compares native string pieces by code points,
+// so the order is the same as for UTF-8 encoded inline strings
+template <class Impl>
+int compare_code_points(const Impl& lhs, const Impl& rhs)
 {
-    init();
+#if wxUSE_UNICODE_UTF8
+    // Byte order of UTF-8 is the order of code points
+    std::size_t lhs_piece = 0, lhs_pos = 0;
+    std::size_t rhs_piece = 0, rhs_pos = 0;
+    for ( ;; )
+    {
+        while ( lhs_piece < lhs.pieces() && lhs_pos == lhs.piece(lhs_piece).utf8_length() )
+            ++lhs_piece, lhs_pos = 0;
+        while ( rhs_piece < rhs.pieces() && rhs_pos == rhs.piece(rhs_piece).utf8_length() )
+            ++rhs_piece, rhs_pos = 0;
+
+        if ( lhs_piece == lhs.pieces() || rhs_piece == rhs.pieces() )
+            return lhs_piece != lhs.pieces() ? 1 : rhs_piece != rhs.pieces() ? -1 : 0;
+
+        const wxString& a = lhs.piece(lhs_piece);
+        const wxString& b = rhs.piece(rhs_piece);
+        const std::size_t size = std::min(a.utf8_length() - lhs_pos,
+                                          b.utf8_length() - rhs_pos);
+        const int result = std::memcmp(a.wx_str() + lhs_pos, b.wx_str() + rhs_pos, size);
+        if ( result != 0 )
+            return result < 0 ? -1 : 1;
+
+        lhs_pos += size;
+        rhs_pos += size;
+    }
+#else
+    // Code units of UTF-32 are code points
+    if ( sizeof(wchar_t) > 2 && !lhs.is_rope() && !rhs.is_rope() )
+    {
+        const int result = lhs.compare(rhs);
+        return result < 0 ? -1 : result > 0 ? 1 : 0;
+    }
+
+    code_point_reader<Impl> a(lhs), b(rhs);
+    for ( ;; )
+    {
+        if ( a.done() || b.done() )
+            return !a.done() ? 1 : !b.done() ? -1 : 0;
+
+        const unsigned long lhs_cp = a.get();
+        const unsigned long rhs_cp = b.get();
+        if ( lhs_cp != rhs_cp )
+            return lhs_cp < rhs_cp ? -1 : 1;
+    }
+#endif
 }
 
+// Hashes UTF-8 representation of the string, so both inline and
+// native strings have the same hash if they are equal
+class utf8_hasher
+{
+public:
+    utf8_hasher() : m_hash(0), m_word(0), m_count(0), m_size(0) {}
+
+    void add(const char* str, std::size_t size)
+    {
+        const char* const end = str + size;
+        if ( m_count == 0 )
+        {
+            for ( ; end - str >= 8; str += 8 )
+            {
+                boost::uint64_t word = 0;
+                for ( int i = 7; i >= 0; i-- )
+                    word = ( word << 8 ) | static_cast<unsigned char>(str[i]);
+                mix(word);
+                m_size += 8;
+            }
+        }
+        for ( ; str != end; ++str )
+            add_byte(static_cast<unsigned char>(*str));
+    }
+
+    void add(unsigned long cp)
+    {
+        if ( utf8_size(cp) == 0 )
+            cp = 0xFFFD; // Invalid code points are hashed as replacement character
+
+        char buffer[4];
+        add(buffer, utf8_put(cp, buffer) - buffer);
+    }
+
+    std::size_t value() const
+    {
+        utf8_hasher result(*this);
+        result.mix(result.m_word ^ ( static_cast<boost::uint64_t>(m_size) << 56 ));
+        return static_cast<std::size_t>(result.m_hash ^ ( result.m_hash >> 32 ));
+    }
+
+private:
+    void add_byte(unsigned char byte)
+    {
+        m_word |= static_cast<boost::uint64_t>(byte) << ( 8 * m_count );
+        ++m_size;
+        if ( ++m_count == 8 )
+        {
+            mix(m_word);
+            m_word = 0;
+            m_count = 0;
+        }
+    }
+
+    void mix(boost::uint64_t word)
+    {
+        m_hash = ( m_hash ^ word ) * UINT64_C(0x9E3779B97F4A7C15);
+        m_hash ^= m_hash >> 29;
+    }
+
+    boost::uint64_t m_hash;
+    boost::uint64_t m_word;
+    unsigned m_count;
+    std::size_t m_size;
+};
+
+} // unnamed namespace
+
+class native_helper
+{
+public:
+    static wxString from_uistring(const uistring& str)
+    {
+        if ( str.is_short() )
+            return wxString::FromUTF8Unchecked(str.m_short, str.short_size());
+
+        return str.m_impl->joined();
+    }
+
+    static uistring to_uistring(const wxString& str)
+    {
+        uistring result;
+        assign(result, str);
+        return result;
+    }
+
+    static void assign(uistring& str, const wxString& value)
+    {
+        char buffer[uistring::short_capacity];
+        std::size_t size = 0;
+#if wxUSE_UNICODE_UTF8
+        const wxScopedCharBuffer utf8 = value.utf8_str();
+        const bool fits = utf8.length() <= uistring::short_capacity;
+        if ( fits )
+        {
+            size = utf8.length();
+            std::memcpy(buffer, utf8.data(), size);
+        }
+#else
+        const bool fits = value.length() <= uistring::short_capacity &&
+            wide_to_utf8(value.wx_str(), value.length(),
+                         buffer, sizeof buffer, size);
+#endif
+        if ( fits )
+            assign_short(str, buffer, size);
+        else if ( str.is_short() )
+            str.set_long(new uistring::impl(value));
+        else
+            str.native_impl().assign_native(value);
+    }
+
+    static void assign_short(uistring& str, const char* value, std::size_t size)
+    {
+        str.reset();
+        std::memcpy(str.m_short, value, size);
+        str.set_short_size(size);
+    }
+
+    static void assign_wide(uistring& str, const wchar_t* value, std::size_t size)
+    {
+        char buffer[uistring::short_capacity];
+        std::size_t short_size = 0;
+        if ( size <= uistring::short_capacity &&
+             wide_to_utf8(value, size, buffer, sizeof buffer, short_size) )
+            assign_short(str, buffer, short_size);
+        else
+            assign(str, wxString(value, size));
+    }
+
+    static void assign_locale(uistring& str, const char* value, std::size_t size)
+    {
+        // ASCII is the same in the current locale and UTF-8 encodings
+        if ( size <= uistring::short_capacity && is_ascii(value, size) )
+            assign_short(str, value, size);
+        else
+            assign(str, wxString(value, size));
+    }
+
+    template <class String>
+    static String utf(const uistring& str)
+    {
+        String result;
+        if ( str.is_short() )
+            detail::utf::transcode(str.m_short, str.short_size(), result);
+        else
+        {
+            for ( std::size_t i = 0; i < str.m_impl->pieces(); i++ )
+            {
+                const wxString& piece = str.m_impl->piece(i);
+#if wxUSE_UNICODE_UTF8
+                detail::utf::transcode(piece.wx_str(), piece.utf8_length(), result);
+#else
+                detail::utf::transcode(piece.wx_str(), piece.length(), result);
+#endif
+            }
+        }
+        return result;
+    }
+
+    template <class Char>
+    static void append_utf(uistring& str, const Char* value, std::size_t size)
+    {
+        if ( str.is_short() )
+        {
+            char* const out = str.m_short + str.short_size();
+            const std::size_t capacity = uistring::short_capacity - str.short_size();
+            std::size_t appended = 0;
+            if ( size <= capacity &&
+                 wide_to_utf8(value, size, out, capacity, appended) )
+            {
+                str.set_short_size(str.short_size() + appended);
+                return;
+            }
+        }
+
+        std::wstring wide;
+        detail::utf::transcode(value, size, wide);
+        str.native_impl().append_piece(wide.data(), wide.size());
+    }
+
+    static std::size_t hash(const uistring& str)
+    {
+        if ( str.is_short() )
+        {
+            utf8_hasher hasher;
+            hasher.add(str.m_short, str.short_size());
+            return hasher.value();
+        }
+
+#ifndef BOOST_NO_CXX11_HDR_ATOMIC
+        const std::size_t cached = str.m_impl->m_hash.load(std::memory_order_relaxed);
+        if ( cached != uistring::impl::hash_unknown &&
+             cached != uistring::impl::hash_disabled )
+            return cached;
+#endif
+
+        utf8_hasher hasher;
+#if !wxUSE_UNICODE_UTF8
+        // High surrogate at the end of the previous piece,
+        // surrogate pairs split between pieces are hashed like joined ones
+        unsigned long pending = 0;
+#endif
+        for ( std::size_t i = 0; i < str.m_impl->pieces(); i++ )
+        {
+            const wxString& piece = str.m_impl->piece(i);
+#if wxUSE_UNICODE_UTF8
+            hasher.add(piece.wx_str(), piece.utf8_length());
+#else
+            const wchar_t* iter = piece.wx_str();
+            const wchar_t* const end = iter + piece.length();
+            if ( pending && iter != end )
+            {
+                const unsigned long low = static_cast<unsigned long>(*iter);
+                if ( low >= 0xDC00 && low <= 0xDFFF )
+                {
+                    ++iter;
+                    pending = 0x10000 + ( ( pending - 0xD800 ) << 10 ) + ( low - 0xDC00 );
+                }
+                hasher.add(pending);
+                pending = 0;
+            }
+            while ( iter != end )
+            {
+                const unsigned long cp = wide_get(iter, end);
+                if ( sizeof(wchar_t) == 2 && cp >= 0xD800 && cp < 0xDC00 && iter == end )
+                    pending = cp;
+                else
+                    hasher.add(cp);
+            }
+#endif
+        }
+#if !wxUSE_UNICODE_UTF8
+        if ( pending )
+            hasher.add(pending);
+#endif
+        const std::size_t result = hasher.value();
+
+#ifndef BOOST_NO_CXX11_HDR_ATOMIC
+        if ( cached == uistring::impl::hash_unknown &&
+             result != uistring::impl::hash_unknown &&
+             result != uistring::impl::hash_disabled )
+            str.m_impl->m_hash.store(result, std::memory_order_relaxed);
+#endif
+        return result;
+    }
+
+    // Formatter writes into [first, last) and returns end of the result
+    // or NULL if the range is too small
+    template <class Formatter>
+    static void append_formatted(uistring& str, const Formatter& formatter)
+    {
+        if ( str.is_short() )
+        {
+            char* const end = formatter(str.m_short + str.short_size(),
+                                        str.m_short + uistring::short_capacity);
+            if ( end )
+            {
+                str.set_short_size(end - str.m_short);
+                return;
+            }
+        }
+
+        char buffer[64];
+        if ( char* const end = formatter(buffer, buffer + sizeof buffer) )
+        {
+            append_ascii(str, buffer, end - buffer);
+            return;
+        }
+
+        std::string large(sizeof buffer, '\0');
+        char* end = NULL;
+        while ( !end )
+        {
+            large.resize(large.size() * 4);
+            end = formatter(&large[0], &large[0] + large.size());
+        }
+        append_ascii(str, large.data(), end - large.data());
+    }
+
+    static void append_ascii(uistring& str, const char* value, std::size_t size)
+    {
+        if ( !append_short(str, value, size) )
+            str.native_impl().append_piece(wxString::FromAscii(value, size));
+    }
+
+    static bool append_short(uistring& str, const char* value, std::size_t size)
+    {
+        if ( !str.is_short() || str.short_size() + size > uistring::short_capacity )
+            return false;
+
+        std::memmove(str.m_short + str.short_size(), value, size);
+        str.set_short_size(str.short_size() + size);
+        return true;
+    }
+};
+
 uistring::uistring(const uistring& other)
 {
-    init();
-    *m_impl = *other.m_impl;
+    if ( other.is_short() )
+        std::memcpy(m_short, other.m_short, sizeof m_short);
+    else
+        set_long(new impl(*other.m_impl));
 }
 
 #ifndef BOOST_UI_NO_CAST_FROM_ASCII
@@ -47,13 +715,19 @@ uistring::uistring(const uistring& other)
 uistring::uistring(const char* str)
 {
     init();
-    *static_cast<wxString*>(m_impl) = str;
+    native_helper::assign_locale(*this, str, std::strlen(str));
+}
+
+uistring::uistring(const char* str, size_type size)
+{
+    init();
+    native_helper::assign_locale(*this, str, size);
 }
 
 uistring::uistring(const std::string& str)
 {
     init();
-    *static_cast<wxString*>(m_impl) = str;
+    native_helper::assign_locale(*this, str.data(), str.size());
 }
 
 #endif
@@ -61,43 +735,186 @@ uistring::uistring(const std::string& str)
 uistring::uistring(const wchar_t* str)
 {
     init();
-    *static_cast<wxString*>(m_impl) = str;
+    native_helper::assign_wide(*this, str, std::wcslen(str));
 }
 
-uistring::uistring(const std::wstring& str)
+uistring::uistring(const wchar_t* str, size_type size)
 {
     init();
-    *static_cast<wxString*>(m_impl) = str;
+    native_helper::assign_wide(*this, str, size);
 }
 
-void uistring::init(const std::wstring& str)
+uistring::uistring(const std::wstring& str)
 {
     init();
-    *static_cast<wxString*>(m_impl) = str;
+    native_helper::assign_wide(*this, str.data(), str.size());
 }
 
 uistring::~uistring()
 {
-    delete m_impl;
+    reset();
+}
+
+void uistring::reset() BOOST_NOEXCEPT
+{
+    if ( !is_short() )
+        delete m_impl;
+
+    init();
+}
+
+uistring::impl& uistring::native_impl()
+{
+    if ( is_short() )
+        set_long(new impl(wxString::FromUTF8Unchecked(m_short, short_size())));
+    else
+        m_impl->changed();
+
+    return *m_impl;
+}
+
+uistring::native_handle_type uistring::native_handle()
+{
+    impl& result = native_impl();
+    result.flatten();
+    result.disable_hash_cache();
+    return &result;
+}
+
+const uistring::native_handle_type uistring::native_handle() const
+{
+    if ( is_short() || m_impl->is_rope() )
+        return NULL;
+
+    return m_impl;
 }
 
 uistring& uistring::assign(const uistring& other)
 {
-    m_impl->assign(*other.m_impl);
+    if ( this == &other )
+        return *this;
+
+    if ( other.is_short() )
+        native_helper::assign_short(*this, other.m_short, other.short_size());
+    else if ( is_short() )
+        set_long(new impl(*other.m_impl));
+    else
+        native_impl().copy_from(*other.m_impl);
+
     return *this;
 }
 
 uistring& uistring::append(const uistring& str)
 {
-    m_impl->append(*str.m_impl);
+    if ( str.is_short() )
+    {
+        if ( native_helper::append_short(*this, str.m_short, str.short_size()) )
+            return *this;
+
+        const wxString value = native_helper::from_uistring(str);
+        native_impl().append_piece(value);
+    }
+    else if ( this == &str )
+    {
+        const impl copy(*str.m_impl);
+        for ( std::size_t i = 0; i < copy.pieces(); i++ )
+            native_impl().append_piece(copy.piece(i));
+    }
+    else
+    {
+        for ( std::size_t i = 0; i < str.m_impl->pieces(); i++ )
+            native_impl().append_piece(str.m_impl->piece(i));
+    }
+
+    return *this;
+}
+
+uistring& uistring::prepend(const uistring& str)
+{
+    if ( this == &str )
+        return append(str);
+
+    if ( is_short() && str.is_short() &&
+         short_size() + str.short_size() <= short_capacity )
+    {
+        std::memmove(m_short + str.short_size(), m_short, short_size());
+        std::memcpy(m_short, str.m_short, str.short_size());
+        set_short_size(short_size() + str.short_size());
+        return *this;
+    }
+
+    // Chunks are kept, they follow the contiguous part
+    const wxString value = native_helper::from_uistring(str);
+    native_impl().insert(0, value);
+    return *this;
+}
+
+#ifndef BOOST_UI_NO_CAST_FROM_ASCII
+
+uistring& uistring::append(const char* str, size_type size)
+{
+    if ( is_ascii(str, size) && native_helper::append_short(*this, str, size) )
+        return *this;
+
+    // String could point to the inline buffer that is replaced by promotion
+    const wxString value(str, size);
+    native_impl().append_piece(value);
+    return *this;
+}
+
+#endif
+
+uistring& uistring::append(const wchar_t* str, size_type size)
+{
+    if ( is_short() )
+    {
+        const std::size_t capacity = short_capacity - short_size();
+        std::size_t appended = 0;
+        if ( size <= capacity &&
+             wide_to_utf8(str, size, m_short + short_size(), capacity, appended) )
+        {
+            set_short_size(short_size() + appended);
+            return *this;
+        }
+    }
+
+    native_impl().append_piece(str, size);
+    return *this;
+}
+
+#ifndef BOOST_NO_CXX11_CHAR16_T
+
+uistring& uistring::append(const char16_t* str, size_type size)
+{
+    native_helper::append_utf(*this, str, size);
     return *this;
 }
 
+#endif
+
+#ifndef BOOST_NO_CXX11_CHAR32_T
+
+uistring& uistring::append(const char32_t* str, size_type size)
+{
+    native_helper::append_utf(*this, str, size);
+    return *this;
+}
+
+#endif
+
 #ifndef BOOST_UI_NO_CAST_FROM_ASCII
 
 uistring& uistring::append(size_type count, char ch)
 {
-    m_impl->append(count, ch);
+    if ( static_cast<unsigned char>(ch) < 0x80 && is_short() &&
+         short_size() + count <= short_capacity )
+    {
+        std::memset(m_short + short_size(), ch, count);
+        set_short_size(short_size() + count);
+    }
+    else
+        native_impl().append_piece(count, ch);
+
     return *this;
 }
 
@@ -105,7 +922,17 @@ uistring& uistring::append(size_type count, char ch)
 
 uistring& uistring::append(size_type count, wchar_t ch)
 {
-    m_impl->append(count, ch);
+    const std::size_t size = utf8_size(static_cast<unsigned long>(ch));
+    if ( size != 0 && is_short() && short_size() + size * count <= short_capacity )
+    {
+        char* out = m_short + short_size();
+        for ( size_type i = 0; i < count; i++ )
+            out = utf8_put(static_cast<unsigned long>(ch), out);
+        set_short_size(out - m_short);
+    }
+    else
+        native_impl().append_piece(count, ch);
+
     return *this;
 }
 
@@ -113,162 +940,568 @@ uistring& uistring::append(size_type count, wchar_t ch)
 
 void uistring::push_back(char ch)
 {
-    (*m_impl) += ch;
+    append(1, ch);
 }
 
 #endif
 
 void uistring::push_back(wchar_t ch)
 {
-    (*m_impl) += ch;
+    append(1, ch);
 }
 
 int uistring::compare(const uistring& other) const BOOST_NOEXCEPT
 {
-    return m_impl->compare(*other.m_impl);
-}
+    if ( is_short() && other.is_short() )
+    {
+        const size_type size = short_size();
+        const size_type other_size = other.short_size();
+        const int result = std::memcmp(m_short, other.m_short,
+                                       size < other_size ? size : other_size);
+        if ( result != 0 )
+            return result < 0 ? -1 : 1;
+
+        return size < other_size ? -1 : size > other_size ? 1 : 0;
+    }
 
-void uistring::swap(const uistring& other)
-{
-    m_impl->swap(*other.m_impl);
+    if ( is_short() )
+        return compare_code_points(m_short, short_size(), *other.m_impl);
+
+    if ( other.is_short() )
+        return -compare_code_points(other.m_short, other.short_size(), *m_impl);
+
+    return compare_code_points(*m_impl, *other.m_impl);
 }
 
 bool uistring::empty() const BOOST_NOEXCEPT
 {
-    return m_impl->empty();
+    return is_short() ? short_size() == 0 : m_impl->empty() && !m_impl->is_rope();
 }
 
 void uistring::clear() BOOST_NOEXCEPT
 {
-    m_impl->clear();
+    if ( is_short() )
+        set_short_size(0);
+    else
+    {
+        m_impl->clear_contents();
+        m_impl->changed();
+    }
+}
+
+void uistring::reserve(size_type capacity)
+{
+    if ( is_short() && capacity <= short_capacity )
+        return;
+
+    impl& native = native_impl();
+    if ( !native.is_rope() )
+        native.reserve(std::min<size_type>(capacity, impl::rope_threshold));
 }
 
 void uistring::shrink_to_fit()
 {
-    m_impl->Shrink();
+    if ( is_short() )
+        return;
+
+    if ( m_impl->is_rope() )
+        return; // Chunks are kept to avoid copying of large text
+
+    if ( m_impl->length() <= short_capacity )
+    {
+        const wxString value = *m_impl;
+        native_helper::assign(*this, value);
+    }
+    else
+        m_impl->Shrink();
 }
 
-uistring uistring::make_from_utf8(const char* str)
+uistring uistring::make_from_utf8(const char* str, size_type size)
 {
     uistring result;
-    *static_cast<wxString*>(result.m_impl) = wxString::FromUTF8(str);
+    if ( size <= short_capacity && detail::utf::valid(str, size) )
+        native_helper::assign_short(result, str, size);
+    else
+        native_helper::assign(result, wxString::FromUTF8(str, size));
     return result;
 }
 
-uistring uistring::make_from_ascii(const char* str)
+uistring uistring::make_from_ascii(const char* str, size_type size)
 {
     uistring result;
-    *static_cast<wxString*>(result.m_impl) = wxString::FromAscii(str);
+    if ( size <= short_capacity && is_ascii(str, size) )
+        native_helper::assign_short(result, str, size);
+    else
+        native_helper::assign(result, wxString::FromAscii(str, size));
     return result;
 }
 
 std::string uistring::u8string() const
 {
-    return std::string(m_impl->ToUTF8());
+    if ( is_short() )
+        return std::string(m_short, short_size());
+
+    std::string result;
+    for ( std::size_t i = 0; i < m_impl->pieces(); i++ )
+    {
+        const wxString& piece = m_impl->piece(i);
+#if wxUSE_UNICODE_UTF8
+        result.append(piece.wx_str(), piece.utf8_length());
+#else
+        detail::utf::transcode(piece.wx_str(), piece.length(), result);
+#endif
+    }
+    return result;
+}
+
+#ifndef BOOST_NO_CXX17_HDR_STRING_VIEW
+
+std::string_view uistring::u8_view(std::string& buffer) const
+{
+    if ( is_short() )
+        return std::string_view(m_short, short_size());
+
+#if wxUSE_UNICODE_UTF8
+    if ( !m_impl->is_rope() )
+        return std::string_view(m_impl->wx_str(), m_impl->utf8_length());
+#endif
+
+    buffer = u8string();
+    return buffer;
 }
 
+#endif
+
 #ifndef BOOST_UI_NO_STRING_DESTRUCTIVE
 
 std::string uistring::asciistring() const
 {
-    return std::string(m_impl->ToAscii());
+    if ( is_short() )
+    {
+        std::string result;
+        result.reserve(short_size());
+        for ( size_type i = 0; i < short_size(); i++ )
+        {
+            const unsigned char ch = static_cast<unsigned char>(m_short[i]);
+            if ( ch < 0x80 )
+                result.push_back(static_cast<char>(ch));
+            else if ( ( ch & 0xC0 ) != 0x80 )
+                result.push_back('_'); // Replace code point, skip continuation bytes
+        }
+        return result;
+    }
+
+    return std::string(m_impl->joined().ToAscii());
 }
 
 std::string uistring::string() const
 {
-    return std::string(m_impl->ToStdString());
+    if ( is_short() && is_ascii(m_short, short_size()) )
+        return std::string(m_short, short_size());
+
+    return std::string(native_helper::from_uistring(*this).ToStdString());
 }
 
 #endif
 
 std::wstring uistring::wstring() const
 {
-    return std::wstring(m_impl->ToStdWstring());
+    if ( is_short() )
+    {
+        std::wstring result;
+        detail::utf::transcode(m_short, short_size(), result);
+        return result;
+    }
+
+    std::wstring result;
+    result.reserve(m_impl->total_length());
+    for ( std::size_t i = 0; i < m_impl->pieces(); i++ )
+        result.append(m_impl->piece(i).ToStdWstring());
+    return result;
 }
 
+#ifndef BOOST_NO_CXX11_CHAR16_T
+
+std::u16string uistring::u16string() const
+{
+    return native_helper::utf<std::u16string>(*this);
+}
+
+#endif
+
+#ifndef BOOST_NO_CXX11_CHAR32_T
+
+std::u32string uistring::u32string() const
+{
+    return native_helper::utf<std::u32string>(*this);
+}
+
+#endif
+
 namespace {
 
+const char digit_pairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+// Formats integer into [first, last), returns end of the result or NULL
+// if the range is too small
+class integer_formatter
+{
+public:
+    integer_formatter(unsigned long long magnitude, bool negative, number_format f)
+        : m_magnitude(magnitude), m_negative(negative),
+          m_base(f == number_format::hex ? 16 : 10) {}
+
+    char* operator()(char* first, char* last) const
+    {
+        char buffer[24]; // 20 decimal digits of 64-bit value and sign
+        char* const end = buffer + sizeof buffer;
+        char* begin = end;
+
+        unsigned long long value = m_magnitude;
+        if ( m_base == 10 )
+        {
+            while ( value >= 100 )
+            {
+                const unsigned i = static_cast<unsigned>(value % 100) * 2;
+                value /= 100;
+                *--begin = digit_pairs[i + 1];
+                *--begin = digit_pairs[i];
+            }
+            if ( value >= 10 )
+            {
+                const unsigned i = static_cast<unsigned>(value) * 2;
+                *--begin = digit_pairs[i + 1];
+                *--begin = digit_pairs[i];
+            }
+            else
+                *--begin = static_cast<char>('0' + value);
+        }
+        else
+        {
+            do
+            {
+                *--begin = "0123456789abcdef"[value % 16];
+                value /= 16;
+            }
+            while ( value );
+        }
+
+        if ( m_negative )
+            *--begin = '-';
+
+        const std::size_t size = end - begin;
+        if ( static_cast<std::size_t>(last - first) < size )
+            return NULL;
+
+        std::memcpy(first, begin, size);
+        return first + size;
+    }
+
+private:
+    unsigned long long m_magnitude;
+    bool m_negative;
+    unsigned m_base;
+};
+
 template <class T>
-uistring to_uistring_detail(T value, const char* format)
+void append_signed(uistring& str, T value, number_format f)
 {
-    char buffer[32];
+    const bool negative = value < 0;
+    const unsigned long long magnitude = negative
+        ? 0ull - static_cast<unsigned long long>(value)
+        : static_cast<unsigned long long>(value);
+    native_helper::append_formatted(str, integer_formatter(magnitude, negative, f));
+}
+
+template <class T>
+void append_unsigned(uistring& str, T value, number_format f)
+{
+    native_helper::append_formatted(str, integer_formatter(value, false, f));
+}
+
+#ifdef BOOST_UI_DETAIL_TO_CHARS
+
+template <class T>
+class float_formatter
+{
+public:
+    float_formatter(T value, number_format f, int precision)
+        : m_value(value), m_precision(precision)
+    {
+        switch ( boost::native_value(f) )
+        {
+            case number_format::general:    m_format = std::chars_format::general; break;
+            case number_format::fixed:      m_format = std::chars_format::fixed; break;
+            case number_format::scientific: m_format = std::chars_format::scientific; break;
+            case number_format::hex:        m_format = std::chars_format::hex; break;
+        }
+    }
+
+    char* operator()(char* first, char* last) const
+    {
+        const std::to_chars_result result = m_precision >= 0
+            ? std::to_chars(first, last, m_value, m_format, m_precision)
+            : m_format == std::chars_format::general
+            ? std::to_chars(first, last, m_value)
+            : std::to_chars(first, last, m_value, m_format);
+        return result.ec == std::errc() ? result.ptr : NULL;
+    }
+
+private:
+    T m_value;
+    std::chars_format m_format;
+    int m_precision;
+};
+
+#else
+
 #ifdef _MSC_VER
-    _snprintf
+#define BOOST_UI_DETAIL_SNPRINTF _snprintf
 #else
-    snprintf
+#define BOOST_UI_DETAIL_SNPRINTF snprintf
 #endif
-        (buffer, sizeof buffer / sizeof buffer[0], format, value);
-    return ascii(buffer);
+
+template <class T> struct float_traits;
+
+template <>
+struct float_traits<float>
+{
+    static const char* length() { return ""; }
+    static int max_digits10() { return 2 + FLT_MANT_DIG * 30103 / 100000; }
+    static float parse(const char* str) { return static_cast<float>(strtod(str, NULL)); }
+};
+
+template <>
+struct float_traits<double>
+{
+    static const char* length() { return ""; }
+    static int max_digits10() { return 2 + DBL_MANT_DIG * 30103 / 100000; }
+    static double parse(const char* str) { return strtod(str, NULL); }
+};
+
+template <>
+struct float_traits<long double>
+{
+    static const char* length() { return "L"; }
+    static int max_digits10() { return 2 + LDBL_MANT_DIG * 30103 / 100000; }
+    static long double parse(const char* str) { return strtold(str, NULL); }
+};
+
+// Uses C formatting and searches the shortest round-trip precision
+// if precision wasn't specified
+template <class T>
+class float_formatter
+{
+public:
+    float_formatter(T value, number_format f, int precision)
+        : m_value(value), m_conversion('g'), m_precision(precision)
+    {
+        switch ( boost::native_value(f) )
+        {
+            case number_format::general:    m_conversion = 'g'; break;
+            case number_format::fixed:      m_conversion = 'f'; break;
+            case number_format::scientific: m_conversion = 'e'; break;
+            case number_format::hex:        m_conversion = 'a'; break;
+        }
+
+        if ( m_precision >= 0 || m_conversion == 'a' )
+            return;
+
+        // Searches the shortest scientific notation that is read back
+        const int max = float_traits<T>::max_digits10();
+        char buffer[64];
+        int digits = 0;
+        for ( ; digits < max - 1; digits++ )
+        {
+            print(buffer, sizeof buffer, 'e', digits);
+            if ( float_traits<T>::parse(buffer) == m_value )
+                break;
+        }
+        const int scientific_size = print(buffer, sizeof buffer, 'e', digits);
+
+        // Fixed notation needs digits after the decimal exponent
+        const char* exponent = std::strchr(buffer, 'e');
+        const int e = exponent ? std::atoi(exponent + 1) : 0;
+        const int fixed_digits = digits > e ? digits - e : 0;
+
+        if ( m_conversion == 'g' )
+        {
+            // Chooses shorter notation like std::to_chars()
+            const int fixed_size = print(buffer, sizeof buffer, 'f', fixed_digits);
+            m_conversion = fixed_size >= 0 && fixed_size <= scientific_size ? 'f' : 'e';
+        }
+        m_precision = m_conversion == 'e' ? digits : fixed_digits;
+    }
+
+    char* operator()(char* first, char* last) const
+    {
+        const int size = print(first, last - first, m_conversion, m_precision);
+        return size >= 0 && size < last - first ? first + size : NULL;
+    }
+
+private:
+    int print(char* buffer, std::size_t size, char conversion, int precision) const
+    {
+        char format[8];
+        char* out = format;
+        *out++ = '%';
+        if ( precision >= 0 )
+        {
+            *out++ = '.';
+            *out++ = '*';
+        }
+        for ( const char* length = float_traits<T>::length(); *length; )
+            *out++ = *length++;
+        *out++ = conversion;
+        *out = 0;
+
+        if ( precision < 0 )
+            return BOOST_UI_DETAIL_SNPRINTF(buffer, size, format, m_value);
+
+        return BOOST_UI_DETAIL_SNPRINTF(buffer, size, format, precision, m_value);
+    }
+
+    T m_value;
+    char m_conversion;
+    int m_precision;
+};
+
+#endif // BOOST_UI_DETAIL_TO_CHARS
+
+template <class T>
+void append_float(uistring& str, T value, number_format f, int precision)
+{
+    native_helper::append_formatted(str, float_formatter<T>(value, f, precision));
+}
+
+} // unnamed namespace
+
+uistring& append_number(uistring& str, int value, number_format f)
+{
+    append_signed(str, value, f);
+    return str;
+}
+
+uistring& append_number(uistring& str, unsigned int value, number_format f)
+{
+    append_unsigned(str, value, f);
+    return str;
+}
+
+uistring& append_number(uistring& str, long value, number_format f)
+{
+    append_signed(str, value, f);
+    return str;
+}
+
+uistring& append_number(uistring& str, unsigned long value, number_format f)
+{
+    append_unsigned(str, value, f);
+    return str;
+}
+
+uistring& append_number(uistring& str, long long value, number_format f)
+{
+    append_signed(str, value, f);
+    return str;
+}
+
+uistring& append_number(uistring& str, unsigned long long value, number_format f)
+{
+    append_unsigned(str, value, f);
+    return str;
+}
+
+uistring& append_number(uistring& str, float value, number_format f, int precision)
+{
+    append_float(str, value, f, precision);
+    return str;
+}
+
+uistring& append_number(uistring& str, double value, number_format f, int precision)
+{
+    append_float(str, value, f, precision);
+    return str;
+}
+
+uistring& append_number(uistring& str, long double value, number_format f, int precision)
+{
+    append_float(str, value, f, precision);
+    return str;
+}
+
+namespace {
+
+template <class T>
+uistring to_uistring_detail(T value)
+{
+    uistring result;
+    append_number(result, value);
+    return result;
 }
 
 } // unnamed namespace
 
 uistring to_uistring(int value)
 {
-    return to_uistring_detail(value, "%d");
+    return to_uistring_detail(value);
 }
 
 uistring to_uistring(unsigned int value)
 {
-    return to_uistring_detail(value, "%u");
+    return to_uistring_detail(value);
 }
 
 uistring to_uistring(long value)
 {
-    return to_uistring_detail(value, "%ld");
+    return to_uistring_detail(value);
 }
 
 uistring to_uistring(unsigned long value)
 {
-    return to_uistring_detail(value, "%lu");
+    return to_uistring_detail(value);
 }
 
 uistring to_uistring(long long value)
 {
-    return to_uistring_detail(value, "%lld");
+    return to_uistring_detail(value);
 }
 
 uistring to_uistring(unsigned long long value)
 {
-    return to_uistring_detail(value, "%llu");
+    return to_uistring_detail(value);
 }
 
 uistring to_uistring(float value)
 {
-    return to_uistring_detail(value, "%f");
+    return to_uistring_detail(value);
 }
 
 uistring to_uistring(double value)
 {
-    return to_uistring_detail(value, "%f");
+    return to_uistring_detail(value);
 }
 
 uistring to_uistring(long double value)
 {
-    return to_uistring_detail(value, "%Lf");
+    return to_uistring_detail(value);
 }
 
 std::size_t hash_value(const uistring& value)
 {
-    return boost::hash<std::wstring>()(value.wstring());
+    return native_helper::hash(value);
 }
 
-class native_helper
-{
-public:
-    static wxString from_uistring(const uistring& str)
-    {
-        return *str.m_impl;
-    }
-
-    static uistring to_uistring(const wxString& str)
-    {
-        uistring result;
-        *static_cast<wxString*>(result.m_impl) = str;
-        return result;
-    }
-};
-
 namespace native {
 
 wxString from_uistring(const uistring& str)
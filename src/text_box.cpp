@@ -44,6 +44,12 @@ public:
         wxCHECK_MSG(m_native, uistring(), "Widget should be created");
         return native::to_uistring(m_native->GetValue());
     }
+    void append(const uistring& text)
+    {
+        wxCHECK_RET(m_native, "Widget should be created");
+        wxEventBlocker blocker(m_native, wxEVT_TEXT); // Like ChangeValue()
+        m_native->AppendText(native::from_uistring(text));
+    }
     void placeholder(const uistring& text)
     {
         wxCHECK_RET(m_native, "Widget should be created");
@@ -117,6 +123,18 @@ uistring text_box_base::text() const
 #endif
 }
 
+text_box_base& text_box_base::append(const uistring& text)
+{
+#if wxUSE_TEXTCTRL
+    detail_impl* impl = get_impl();
+    wxCHECK_MSG(impl, *this, "Widget should be created");
+
+    impl->append(text);
+#endif
+
+    return *this;
+}
+
 text_box_base& text_box_base::detail_placeholder(const uistring& text)
 {
 #if wxUSE_TEXTCTRL
@@ -141,10 +159,12 @@ uistring text_box_base::detail_placeholder() const
 #endif
 }
 
-void text_box_base::on_edit_raw(const boost::function<void()>& handler)
+connection text_box_base::on_edit_raw(const boost::function<void()>& handler, bool replace)
 {
 #if wxUSE_TEXTCTRL
-    native::bind_helper(*this, wxEVT_TEXT, handler);
+    return native::bind_helper(*this, wxEVT_TEXT, handler, replace);
+#else
+    return connection();
 #endif
 }
 
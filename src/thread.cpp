@@ -10,26 +10,288 @@
 #include <boost/ui/thread.hpp>
 
 #include <wx/app.h>
+#include <wx/thread.h>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#ifndef BOOST_NO_CXX11_HDR_ATOMIC
+#include <atomic>
+#endif
 
 namespace boost  {
 namespace ui     {
 namespace detail {
 
+namespace {
+
+// Maximal count of the calls that are called in one event loop iteration
+const std::size_t async_calls_batch = 1024;
+
+// Unbounded multiple producers single consumer queue of the calls.
+// Producers push calls into the lock-free stack,
+// consumer takes the whole stack at once and reverses it into the FIFO order.
+class call_queue
+{
+public:
+    call_queue() : m_head(NULL), m_batch(NULL) {}
+
+    ~call_queue()
+    {
+        delete_nodes(m_head);
+        delete_nodes(m_batch);
+    }
+
+    // Returns true if the queue was empty, so the consumer should be waked up
+    bool push(const boost::function<void()>& fn)
+    {
+        node* n = new node(fn);
+#ifndef BOOST_NO_CXX11_HDR_ATOMIC
+        node* head = m_head.load(std::memory_order_relaxed);
+        do
+        {
+            n->next = head;
+        }
+        while ( !m_head.compare_exchange_weak(head, n,
+                    std::memory_order_release, std::memory_order_relaxed) );
+        return !head;
+#else
+        wxCriticalSectionLocker locker(m_lock);
+        n->next = m_head;
+        m_head = n;
+        return !n->next;
+#endif
+    }
+
+    // Calls at most max_count calls, returns true if calls remain.
+    // Should be called from the UI thread only.
+    bool call(std::size_t max_count)
+    {
+        if ( !m_batch )
+            m_batch = reverse(take());
+
+        for ( ; m_batch && max_count; max_count-- )
+        {
+            node* n = m_batch;
+            m_batch = n->next;
+
+            // Remaining calls are kept if the call throws
+            boost::function<void()> fn;
+            fn.swap(n->fn);
+            delete n;
+            fn();
+
+            if ( !m_batch )
+                m_batch = reverse(take());
+        }
+
+        return m_batch || !empty();
+    }
+
+private:
+    struct node
+    {
+        explicit node(const boost::function<void()>& f) : fn(f), next(NULL) {}
+
+        boost::function<void()> fn;
+        node* next;
+    };
+
+    node* take()
+    {
+#ifndef BOOST_NO_CXX11_HDR_ATOMIC
+        if ( !m_head.load(std::memory_order_relaxed) )
+            return NULL;
+
+        return m_head.exchange(NULL, std::memory_order_acquire);
+#else
+        wxCriticalSectionLocker locker(m_lock);
+        node* head = m_head;
+        m_head = NULL;
+        return head;
+#endif
+    }
+
+    bool empty() const
+    {
+#ifndef BOOST_NO_CXX11_HDR_ATOMIC
+        return !m_head.load(std::memory_order_relaxed);
+#else
+        wxCriticalSectionLocker locker(m_lock);
+        return !m_head;
+#endif
+    }
+
+    static node* reverse(node* n)
+    {
+        node* result = NULL;
+        while ( n )
+        {
+            node* next = n->next;
+            n->next = result;
+            result = n;
+            n = next;
+        }
+        return result;
+    }
+
+    static void delete_nodes(node* n)
+    {
+        while ( n )
+        {
+            node* next = n->next;
+            delete n;
+            n = next;
+        }
+    }
+
+#ifndef BOOST_NO_CXX11_HDR_ATOMIC
+    std::atomic<node*> m_head;
+#else
+    mutable wxCriticalSection m_lock;
+    node* m_head;
+#endif
+
+    // Consumer's calls in the FIFO order
+    node* m_batch;
+};
+
+// Last pending call of every key, calls are kept in the order of the first posting
+class latest_calls
+{
+public:
+    // Returns true if there were no pending calls
+    bool push(const void* key, const boost::function<void()>& fn)
+    {
+        wxCriticalSectionLocker locker(m_lock);
+        const bool was_empty = m_calls.empty();
+
+        const std::pair<index_type::iterator, bool> inserted =
+            m_index.insert(index_type::value_type(key, m_calls.size()));
+        if ( inserted.second )
+            m_calls.push_back(call_type(key, fn));
+        else
+            m_calls[inserted.first->second].second = fn;
+
+        return was_empty;
+    }
+
+    // Calls pending calls once, returns true if new calls are pushed.
+    // Should be called from the UI thread only.
+    bool call()
+    {
+        calls_type calls;
+        {
+            wxCriticalSectionLocker locker(m_lock);
+            calls.swap(m_calls);
+            m_index.clear();
+        }
+
+        for ( std::size_t i = 0; i < calls.size(); i++ )
+        {
+            boost::function<void()> fn;
+            fn.swap(calls[i].second);
+
+            try
+            {
+                fn();
+            }
+            catch ( ... )
+            {
+                restore(calls, i + 1);
+                throw;
+            }
+        }
+
+        wxCriticalSectionLocker locker(m_lock);
+        return !m_calls.empty();
+    }
+
+private:
+    typedef std::pair< const void*, boost::function<void()> > call_type;
+    typedef std::vector<call_type> calls_type;
+    typedef std::map<const void*, std::size_t> index_type;
+
+    // Remaining calls are kept before newer calls unless they are replaced by them
+    void restore(calls_type& calls, std::size_t first)
+    {
+        wxCriticalSectionLocker locker(m_lock);
+
+        calls_type restored;
+        index_type index;
+        for ( std::size_t i = first; i < calls.size(); i++ )
+        {
+            if ( m_index.find(calls[i].first) == m_index.end() )
+            {
+                index[calls[i].first] = restored.size();
+                restored.push_back(call_type());
+                restored.back().first = calls[i].first;
+                restored.back().second.swap(calls[i].second);
+            }
+        }
+        for ( std::size_t i = 0; i < m_calls.size(); i++ )
+        {
+            index[m_calls[i].first] = restored.size();
+            restored.push_back(call_type());
+            restored.back().first = m_calls[i].first;
+            restored.back().second.swap(m_calls[i].second);
+        }
+
+        m_calls.swap(restored);
+        m_index.swap(index);
+    }
+
+    wxCriticalSection m_lock;
+    calls_type m_calls;
+    index_type m_index;
+};
+
+call_queue g_async_calls;
+latest_calls g_latest_calls;
+
+} // unnamed namespace
+
 void call_async(const boost::function<void()>& fn)
 {
-#ifdef wxHAS_CALL_AFTER
-    wxAppConsole* app = wxApp::GetInstance();
-    if ( app )
+    if ( wxApp::GetInstance() )
     {
-        app->CallAfter(fn);
+        // Event loop is waked up once until the queue is drained
+        if ( g_async_calls.push(fn) )
+            wxWakeUpIdle();
+        return;
+    }
+
+    wxFAIL;
+    fn();
+}
+
+void call_async_latest(const void* key, const boost::function<void()>& fn)
+{
+    if ( wxApp::GetInstance() )
+    {
+        if ( g_latest_calls.push(key, fn) )
+            wxWakeUpIdle();
         return;
     }
-#endif
 
     wxFAIL;
     fn();
 }
 
+bool process_async_calls()
+{
+    const bool more = g_async_calls.call(async_calls_batch);
+
+    // Coalesced calls are called once per event loop iteration
+    return g_latest_calls.call() || more;
+}
+
+bool is_ui_thread()
+{
+    return wxThread::IsMain();
+}
+
 } // namespace detail
 } // namespace ui
 } // namespace boost
@@ -0,0 +1,173 @@
+// Copyright (c) 2018 Kolya Kosenko
+
+// Distributed under the Boost Software License, Version 1.0.
+// See http://www.boost.org/LICENSE_1_0.txt
+
+#define BOOST_UI_SOURCE
+
+#include <boost/ui/native/config.hpp>
+
+#include <boost/ui/thread_pool.hpp>
+#include <boost/ui/detail/memcheck.hpp>
+
+#include <boost/throw_exception.hpp>
+
+#include <wx/thread.h>
+
+#ifndef wxOVERRIDE
+#define wxOVERRIDE
+#endif
+
+#include <deque>
+#include <vector>
+#include <stdexcept> // std::runtime_error
+
+namespace boost {
+namespace ui    {
+
+class thread_pool::detail_impl : private detail::memcheck
+{
+public:
+    detail_impl() : m_ready(m_lock), m_stop(false) {}
+
+    ~detail_impl()
+    {
+        stop();
+    }
+
+    void start(std::size_t threads_count);
+    void stop();
+
+    void post(const boost::function<void()>& fn)
+    {
+        wxMutexLocker locker(m_lock);
+        m_tasks.push_back(fn);
+        m_ready.Signal();
+    }
+
+    std::size_t size() const { return m_threads.size(); }
+
+private:
+    class worker : public wxThread
+    {
+    public:
+        explicit worker(detail_impl& pool) : wxThread(wxTHREAD_JOINABLE), m_pool(pool) {}
+
+    protected:
+        virtual ExitCode Entry() wxOVERRIDE
+        {
+            m_pool.run();
+            return 0;
+        }
+
+    private:
+        detail_impl& m_pool;
+    };
+
+    // Calls tasks until the pool is stopped and the queue is empty
+    void run();
+
+    wxMutex m_lock;
+    wxCondition m_ready;
+    bool m_stop;
+    std::deque< boost::function<void()> > m_tasks;
+    std::vector<worker*> m_threads;
+};
+
+void thread_pool::detail_impl::start(std::size_t threads_count)
+{
+    m_threads.reserve(threads_count);
+    for ( std::size_t i = 0; i < threads_count; i++ )
+    {
+        worker* thread = new worker(*this);
+        if ( thread->Run() != wxTHREAD_NO_ERROR )
+        {
+            delete thread;
+            BOOST_THROW_EXCEPTION(std::runtime_error("ui::thread_pool: unable to start thread"));
+        }
+        m_threads.push_back(thread);
+    }
+}
+
+void thread_pool::detail_impl::stop()
+{
+    {
+        wxMutexLocker locker(m_lock);
+        m_stop = true;
+        m_ready.Broadcast();
+    }
+
+    for ( std::size_t i = 0; i < m_threads.size(); i++ )
+    {
+        m_threads[i]->Wait();
+        delete m_threads[i];
+    }
+    m_threads.clear();
+}
+
+void thread_pool::detail_impl::run()
+{
+    for ( ;; )
+    {
+        boost::function<void()> fn;
+        {
+            wxMutexLocker locker(m_lock);
+            while ( m_tasks.empty() && !m_stop )
+                m_ready.Wait();
+
+            if ( m_tasks.empty() )
+                return;
+
+            fn.swap(m_tasks.front());
+            m_tasks.pop_front();
+        }
+
+        try
+        {
+            fn();
+        }
+        catch ( ... )
+        {
+            // Worker thread can't report exceptions,
+            // use ui::async() to receive them in UI thread
+        }
+    }
+}
+
+thread_pool::thread_pool(std::size_t threads_count)
+    : m_impl(new detail_impl)
+{
+    if ( threads_count == 0 )
+    {
+        const int cpus = wxThread::GetCPUCount();
+        threads_count = cpus > 0 ? cpus : 2;
+    }
+
+    try
+    {
+        m_impl->start(threads_count);
+    }
+    catch ( ... )
+    {
+        delete m_impl;
+        throw;
+    }
+}
+
+thread_pool::~thread_pool()
+{
+    delete m_impl;
+}
+
+void thread_pool::post(const boost::function<void()>& fn)
+{
+    m_impl->post(fn);
+}
+
+std::size_t thread_pool::size() const
+{
+    return m_impl->size();
+}
+
+} // namespace ui
+} // namespace boost
@@ -0,0 +1,441 @@
+// Copyright (c) 2017 Kolya Kosenko
+
+// Distributed under the Boost Software License, Version 1.0.
+// See http://www.boost.org/LICENSE_1_0.txt
+
+#define BOOST_UI_SOURCE
+
+#include <boost/ui/detail/utf.hpp>
+
+#include <boost/cstdint.hpp>
+
+#if !defined(BOOST_UI_NO_SIMD) && ( defined(__SSE2__) || defined(_M_X64) || \
+    defined(_M_AMD64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 ) )
+#define BOOST_UI_DETAIL_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace boost  {
+namespace ui     {
+namespace detail {
+namespace utf    {
+
+namespace {
+
+const boost::uint32_t replacement = 0xFFFD;
+
+template <std::size_t Size> struct unit_type;
+template <> struct unit_type<1> { typedef unsigned char type; };
+template <> struct unit_type<2> { typedef boost::uint16_t type; };
+template <> struct unit_type<4> { typedef boost::uint32_t type; };
+
+template <class Char>
+inline boost::uint32_t unit(Char ch)
+{
+    return static_cast<typename unit_type<sizeof(Char)>::type>(ch);
+}
+
+inline bool is_surrogate(boost::uint32_t cp)
+{
+    return cp >= 0xD800 && cp <= 0xDFFF;
+}
+
+// Encoding is selected by code unit size
+template <std::size_t Size> struct codec;
+
+template <>
+struct codec<1>
+{
+    template <class Char>
+    static boost::uint32_t decode(const Char*& str, const Char* end, bool& ok)
+    {
+        const boost::uint32_t lead = unit(*str++);
+        if ( lead < 0x80 )
+            return lead;
+
+        int count = 0;
+        if ( lead >= 0xC2 && lead <= 0xDF )
+            count = 1;
+        else if ( lead >= 0xE0 && lead <= 0xEF )
+            count = 2;
+        else if ( lead >= 0xF0 && lead <= 0xF4 )
+            count = 3;
+        else
+        {
+            ok = false;
+            return replacement;
+        }
+
+        static const boost::uint32_t min[] = { 0, 0x80, 0x800, 0x10000 };
+        const boost::uint32_t min_cp = min[count];
+        boost::uint32_t cp = lead & ( 0x3F >> count );
+
+        while ( count-- )
+        {
+            if ( str == end || ( unit(*str) & 0xC0 ) != 0x80 )
+            {
+                ok = false;
+                return replacement;
+            }
+            cp = ( cp << 6 ) | ( unit(*str++) & 0x3F );
+        }
+
+        if ( cp < min_cp || cp > 0x10FFFF || is_surrogate(cp) )
+        {
+            ok = false;
+            return replacement;
+        }
+        return cp;
+    }
+
+    template <class Char>
+    static Char* encode(boost::uint32_t cp, Char* out)
+    {
+        if ( cp < 0x80 )
+            *out++ = static_cast<Char>(cp);
+        else if ( cp < 0x800 )
+        {
+            *out++ = static_cast<Char>(0xC0 | ( cp >> 6 ));
+            *out++ = static_cast<Char>(0x80 | ( cp & 0x3F ));
+        }
+        else if ( cp < 0x10000 )
+        {
+            *out++ = static_cast<Char>(0xE0 | ( cp >> 12 ));
+            *out++ = static_cast<Char>(0x80 | ( ( cp >> 6 ) & 0x3F ));
+            *out++ = static_cast<Char>(0x80 | ( cp & 0x3F ));
+        }
+        else
+        {
+            *out++ = static_cast<Char>(0xF0 | ( cp >> 18 ));
+            *out++ = static_cast<Char>(0x80 | ( ( cp >> 12 ) & 0x3F ));
+            *out++ = static_cast<Char>(0x80 | ( ( cp >> 6 ) & 0x3F ));
+            *out++ = static_cast<Char>(0x80 | ( cp & 0x3F ));
+        }
+        return out;
+    }
+};
+
+template <>
+struct codec<2>
+{
+    template <class Char>
+    static boost::uint32_t decode(const Char*& str, const Char* end, bool& ok)
+    {
+        const boost::uint32_t lead = unit(*str++);
+        if ( !is_surrogate(lead) )
+            return lead;
+
+        if ( lead < 0xDC00 && str != end )
+        {
+            const boost::uint32_t trail = unit(*str);
+            if ( trail >= 0xDC00 && trail <= 0xDFFF )
+            {
+                ++str;
+                return 0x10000 + ( ( lead - 0xD800 ) << 10 ) + ( trail - 0xDC00 );
+            }
+        }
+
+        ok = false;
+        return replacement;
+    }
+
+    template <class Char>
+    static Char* encode(boost::uint32_t cp, Char* out)
+    {
+        if ( cp < 0x10000 )
+            *out++ = static_cast<Char>(cp);
+        else
+        {
+            *out++ = static_cast<Char>(0xD800 + ( ( cp - 0x10000 ) >> 10 ));
+            *out++ = static_cast<Char>(0xDC00 + ( ( cp - 0x10000 ) & 0x3FF ));
+        }
+        return out;
+    }
+};
+
+template <>
+struct codec<4>
+{
+    template <class Char>
+    static boost::uint32_t decode(const Char*& str, const Char*, bool& ok)
+    {
+        const boost::uint32_t cp = unit(*str++);
+        if ( cp > 0x10FFFF || is_surrogate(cp) )
+        {
+            ok = false;
+            return replacement;
+        }
+        return cp;
+    }
+
+    template <class Char>
+    static Char* encode(boost::uint32_t cp, Char* out)
+    {
+        *out++ = static_cast<Char>(cp);
+        return out;
+    }
+};
+
+// Maximal count of output code units per input code unit
+template <std::size_t SrcSize, std::size_t DstSize>
+struct expansion
+{
+    static const std::size_t value = 1;
+};
+template <> struct expansion<2, 1> { static const std::size_t value = 3; };
+template <> struct expansion<4, 1> { static const std::size_t value = 4; };
+template <> struct expansion<4, 2> { static const std::size_t value = 2; };
+
+// Copies leading ASCII code units, returns count of copied code units
+template <std::size_t SrcSize, std::size_t DstSize>
+struct ascii_copier
+{
+    template <class Src, class Dst>
+    static std::size_t copy(const Src*, std::size_t, Dst*)
+    {
+        return 0;
+    }
+};
+
+#ifdef BOOST_UI_DETAIL_SSE2
+
+inline __m128i load(const void* p)
+{
+    return _mm_loadu_si128(static_cast<const __m128i*>(p));
+}
+
+inline void store(void* p, __m128i v)
+{
+    _mm_storeu_si128(static_cast<__m128i*>(p), v);
+}
+
+template <>
+struct ascii_copier<1, 2>
+{
+    template <class Src, class Dst>
+    static std::size_t copy(const Src* str, std::size_t size, Dst* out)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        std::size_t i = 0;
+        for ( ; i + 16 <= size; i += 16 )
+        {
+            const __m128i v = load(str + i);
+            if ( _mm_movemask_epi8(v) != 0 )
+                break;
+
+            store(out + i,     _mm_unpacklo_epi8(v, zero));
+            store(out + i + 8, _mm_unpackhi_epi8(v, zero));
+        }
+        return i;
+    }
+};
+
+template <>
+struct ascii_copier<1, 4>
+{
+    template <class Src, class Dst>
+    static std::size_t copy(const Src* str, std::size_t size, Dst* out)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        std::size_t i = 0;
+        for ( ; i + 16 <= size; i += 16 )
+        {
+            const __m128i v = load(str + i);
+            if ( _mm_movemask_epi8(v) != 0 )
+                break;
+
+            const __m128i lo = _mm_unpacklo_epi8(v, zero);
+            const __m128i hi = _mm_unpackhi_epi8(v, zero);
+            store(out + i,      _mm_unpacklo_epi16(lo, zero));
+            store(out + i + 4,  _mm_unpackhi_epi16(lo, zero));
+            store(out + i + 8,  _mm_unpacklo_epi16(hi, zero));
+            store(out + i + 12, _mm_unpackhi_epi16(hi, zero));
+        }
+        return i;
+    }
+};
+
+template <>
+struct ascii_copier<2, 1>
+{
+    template <class Src, class Dst>
+    static std::size_t copy(const Src* str, std::size_t size, Dst* out)
+    {
+        const __m128i mask = _mm_set1_epi16(static_cast<short>(0xFF80));
+        const __m128i zero = _mm_setzero_si128();
+        std::size_t i = 0;
+        for ( ; i + 16 <= size; i += 16 )
+        {
+            const __m128i a = load(str + i);
+            const __m128i b = load(str + i + 8);
+            const __m128i high = _mm_and_si128(_mm_or_si128(a, b), mask);
+            if ( _mm_movemask_epi8(_mm_cmpeq_epi8(high, zero)) != 0xFFFF )
+                break;
+
+            store(out + i, _mm_packus_epi16(a, b));
+        }
+        return i;
+    }
+};
+
+template <>
+struct ascii_copier<4, 1>
+{
+    template <class Src, class Dst>
+    static std::size_t copy(const Src* str, std::size_t size, Dst* out)
+    {
+        const __m128i mask = _mm_set1_epi32(static_cast<int>(0xFFFFFF80));
+        const __m128i zero = _mm_setzero_si128();
+        std::size_t i = 0;
+        for ( ; i + 16 <= size; i += 16 )
+        {
+            const __m128i a = load(str + i);
+            const __m128i b = load(str + i + 4);
+            const __m128i c = load(str + i + 8);
+            const __m128i d = load(str + i + 12);
+            const __m128i high = _mm_and_si128(
+                _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)), mask);
+            if ( _mm_movemask_epi8(_mm_cmpeq_epi8(high, zero)) != 0xFFFF )
+                break;
+
+            store(out + i, _mm_packus_epi16(_mm_packs_epi32(a, b),
+                                            _mm_packs_epi32(c, d)));
+        }
+        return i;
+    }
+};
+
+#endif // BOOST_UI_DETAIL_SSE2
+
+template <class Src, class Dst>
+std::size_t copy_ascii(const Src* str, std::size_t size, Dst* out)
+{
+    // Don't try vectorized copy in the middle of non-ASCII text
+    if ( size == 0 || unit(*str) >= 0x80 )
+        return 0;
+
+    std::size_t i = ascii_copier<sizeof(Src), sizeof(Dst)>::copy(str, size, out);
+    for ( ; i < size && unit(str[i]) < 0x80; i++ )
+        out[i] = static_cast<Dst>(str[i]);
+    return i;
+}
+
+template <class Src, class Dst>
+bool transcode_detail(const Src* str, std::size_t size, std::basic_string<Dst>& result)
+{
+    if ( size == 0 )
+        return true;
+
+    const std::size_t offset = result.size();
+    result.resize(offset + size * expansion<sizeof(Src), sizeof(Dst)>::value);
+
+    Dst* const begin = &result[0] + offset;
+    Dst* out = begin;
+    const Src* const end = str + size;
+    bool ok = true;
+    while ( str != end )
+    {
+        const std::size_t count = copy_ascii(str, end - str, out);
+        str += count;
+        out += count;
+        if ( str == end )
+            break;
+
+        const boost::uint32_t cp = codec<sizeof(Src)>::decode(str, end, ok);
+        out = codec<sizeof(Dst)>::encode(cp, out);
+    }
+
+    result.resize(offset + ( out - begin ));
+    return ok;
+}
+
+} // unnamed namespace
+
+std::size_t ascii_prefix(const char* str, std::size_t size) BOOST_NOEXCEPT
+{
+    std::size_t i = 0;
+#ifdef BOOST_UI_DETAIL_SSE2
+    for ( ; i + 16 <= size; i += 16 )
+        if ( _mm_movemask_epi8(load(str + i)) != 0 )
+            break;
+#endif
+    for ( ; i < size && unit(str[i]) < 0x80; i++ )
+        ;
+    return i;
+}
+
+bool valid(const char* str, std::size_t size) BOOST_NOEXCEPT
+{
+    const char* const end = str + size;
+    bool ok = true;
+    while ( ok && str != end )
+    {
+        str += ascii_prefix(str, end - str);
+        if ( str != end )
+            codec<1>::decode(str, end, ok);
+    }
+    return ok;
+}
+
+bool transcode(const char* str, std::size_t size, std::wstring& result)
+{
+    return transcode_detail(str, size, result);
+}
+
+bool transcode(const wchar_t* str, std::size_t size, std::string& result)
+{
+    return transcode_detail(str, size, result);
+}
+
+#ifndef BOOST_NO_CXX11_CHAR16_T
+
+bool transcode(const char* str, std::size_t size, std::u16string& result)
+{
+    return transcode_detail(str, size, result);
+}
+
+bool transcode(const char16_t* str, std::size_t size, std::string& result)
+{
+    return transcode_detail(str, size, result);
+}
+
+bool transcode(const wchar_t* str, std::size_t size, std::u16string& result)
+{
+    return transcode_detail(str, size, result);
+}
+
+bool transcode(const char16_t* str, std::size_t size, std::wstring& result)
+{
+    return transcode_detail(str, size, result);
+}
+
+#endif
+
+#ifndef BOOST_NO_CXX11_CHAR32_T
+
+bool transcode(const char* str, std::size_t size, std::u32string& result)
+{
+    return transcode_detail(str, size, result);
+}
+
+bool transcode(const char32_t* str, std::size_t size, std::string& result)
+{
+    return transcode_detail(str, size, result);
+}
+
+bool transcode(const wchar_t* str, std::size_t size, std::u32string& result)
+{
+    return transcode_detail(str, size, result);
+}
+
+bool transcode(const char32_t* str, std::size_t size, std::wstring& result)
+{
+    return transcode_detail(str, size, result);
+}
+
+#endif
+
+} // namespace utf
+} // namespace detail
+} // namespace ui
+} // namespace boost
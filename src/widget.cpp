@@ -341,139 +341,160 @@ ui::font widget::font() const
     return native::to_font(impl->GetFont());
 }
 
-void widget::on_resize_raw(const boost::function<void()>& handler)
+widget& widget::coalesce_events(bool enable)
 {
-    native::bind_helper(*this, wxEVT_SIZE, handler);
+    wxCHECK_MSG(m_detail_impl, *this, "Widget should be created");
+    m_detail_impl->coalesce_events(enable);
+    return *this;
+}
+
+bool widget::coalescing() const
+{
+    return m_detail_impl && m_detail_impl->coalesce_events();
 }
 
-void widget::on_key_press_raw(const boost::function<void()>& handler)
+connection widget::on_resize_raw(const boost::function<void()>& handler, bool replace)
 {
-    native::bind_helper(*this, wxEVT_CHAR, handler);
+    if ( coalescing() )
+        return native::bind_coalesced_helper(*this, wxEVT_SIZE, handler, replace);
+
+    return native::bind_helper(*this, wxEVT_SIZE, handler, replace);
 }
 
-void widget::on_key_press_event_raw(const boost::function<void(key_event&)>& handler)
+connection widget::on_key_press_raw(const boost::function<void()>& handler, bool replace)
 {
-    native::bind_event_helper(*this, wxEVT_CHAR, handler);
+    return native::bind_helper(*this, wxEVT_CHAR, handler, replace);
 }
 
-void widget::on_key_down_raw(const boost::function<void()>& handler)
+connection widget::on_key_press_event_raw(const boost::function<void(key_event&)>& handler, bool replace)
 {
-    native::bind_helper(*this, wxEVT_KEY_DOWN, handler);
+    return native::bind_event_helper(*this, wxEVT_CHAR, handler, replace);
 }
 
-void widget::on_key_down_event_raw(const boost::function<void(key_event&)>& handler)
+connection widget::on_key_down_raw(const boost::function<void()>& handler, bool replace)
 {
-    native::bind_event_helper(*this, wxEVT_KEY_DOWN, handler);
+    return native::bind_helper(*this, wxEVT_KEY_DOWN, handler, replace);
 }
 
-void widget::on_key_up_raw(const boost::function<void()>& handler)
+connection widget::on_key_down_event_raw(const boost::function<void(key_event&)>& handler, bool replace)
 {
-    native::bind_helper(*this, wxEVT_KEY_UP, handler);
+    return native::bind_event_helper(*this, wxEVT_KEY_DOWN, handler, replace);
 }
 
-void widget::on_key_up_event_raw(const boost::function<void(key_event&)>& handler)
+connection widget::on_key_up_raw(const boost::function<void()>& handler, bool replace)
 {
-    native::bind_event_helper(*this, wxEVT_KEY_UP, handler);
+    return native::bind_helper(*this, wxEVT_KEY_UP, handler, replace);
 }
 
-void widget::on_left_mouse_down_raw(const boost::function<void()>& handler)
+connection widget::on_key_up_event_raw(const boost::function<void(key_event&)>& handler, bool replace)
 {
-    native::bind_helper(*this, wxEVT_LEFT_DOWN, handler);
+    return native::bind_event_helper(*this, wxEVT_KEY_UP, handler, replace);
 }
 
-void widget::on_left_mouse_down_event_raw(const boost::function<void(mouse_event&)>& handler)
+connection widget::on_left_mouse_down_raw(const boost::function<void()>& handler, bool replace)
 {
-    native::bind_event_helper(*this, wxEVT_LEFT_DOWN, handler);
+    return native::bind_helper(*this, wxEVT_LEFT_DOWN, handler, replace);
 }
 
-void widget::on_left_mouse_up_raw(const boost::function<void()>& handler)
+connection widget::on_left_mouse_down_event_raw(const boost::function<void(mouse_event&)>& handler, bool replace)
 {
-    native::bind_helper(*this, wxEVT_LEFT_UP, handler);
+    return native::bind_event_helper(*this, wxEVT_LEFT_DOWN, handler, replace);
 }
 
-void widget::on_left_mouse_up_event_raw(const boost::function<void(mouse_event&)>& handler)
+connection widget::on_left_mouse_up_raw(const boost::function<void()>& handler, bool replace)
 {
-    native::bind_event_helper(*this, wxEVT_LEFT_UP, handler);
+    return native::bind_helper(*this, wxEVT_LEFT_UP, handler, replace);
 }
 
-void widget::on_right_mouse_down_raw(const boost::function<void()>& handler)
+connection widget::on_left_mouse_up_event_raw(const boost::function<void(mouse_event&)>& handler, bool replace)
 {
-    native::bind_helper(*this, wxEVT_RIGHT_DOWN, handler);
+    return native::bind_event_helper(*this, wxEVT_LEFT_UP, handler, replace);
 }
 
-void widget::on_right_mouse_down_event_raw(const boost::function<void(mouse_event&)>& handler)
+connection widget::on_right_mouse_down_raw(const boost::function<void()>& handler, bool replace)
 {
-    native::bind_event_helper(*this, wxEVT_RIGHT_DOWN, handler);
+    return native::bind_helper(*this, wxEVT_RIGHT_DOWN, handler, replace);
 }
 
-void widget::on_right_mouse_up_raw(const boost::function<void()>& handler)
+connection widget::on_right_mouse_down_event_raw(const boost::function<void(mouse_event&)>& handler, bool replace)
 {
-    native::bind_helper(*this, wxEVT_RIGHT_UP, handler);
+    return native::bind_event_helper(*this, wxEVT_RIGHT_DOWN, handler, replace);
 }
 
-void widget::on_right_mouse_up_event_raw(const boost::function<void(mouse_event&)>& handler)
+connection widget::on_right_mouse_up_raw(const boost::function<void()>& handler, bool replace)
 {
-    native::bind_event_helper(*this, wxEVT_RIGHT_UP, handler);
+    return native::bind_helper(*this, wxEVT_RIGHT_UP, handler, replace);
 }
 
-void widget::on_middle_mouse_down_raw(const boost::function<void()>& handler)
+connection widget::on_right_mouse_up_event_raw(const boost::function<void(mouse_event&)>& handler, bool replace)
 {
-    native::bind_helper(*this, wxEVT_MIDDLE_DOWN, handler);
+    return native::bind_event_helper(*this, wxEVT_RIGHT_UP, handler, replace);
 }
 
-void widget::on_middle_mouse_down_event_raw(const boost::function<void(mouse_event&)>& handler)
+connection widget::on_middle_mouse_down_raw(const boost::function<void()>& handler, bool replace)
 {
-    native::bind_event_helper(*this, wxEVT_MIDDLE_DOWN, handler);
+    return native::bind_helper(*this, wxEVT_MIDDLE_DOWN, handler, replace);
 }
 
-void widget::on_middle_mouse_up_raw(const boost::function<void()>& handler)
+connection widget::on_middle_mouse_down_event_raw(const boost::function<void(mouse_event&)>& handler, bool replace)
 {
-    native::bind_helper(*this, wxEVT_MIDDLE_UP, handler);
+    return native::bind_event_helper(*this, wxEVT_MIDDLE_DOWN, handler, replace);
 }
 
-void widget::on_middle_mouse_up_event_raw(const boost::function<void(mouse_event&)>& handler)
+connection widget::on_middle_mouse_up_raw(const boost::function<void()>& handler, bool replace)
 {
-    native::bind_event_helper(*this, wxEVT_MIDDLE_UP, handler);
+    return native::bind_helper(*this, wxEVT_MIDDLE_UP, handler, replace);
 }
 
-void widget::on_left_mouse_double_click_raw(const boost::function<void()>& handler)
+connection widget::on_middle_mouse_up_event_raw(const boost::function<void(mouse_event&)>& handler, bool replace)
 {
-    native::bind_helper(*this, wxEVT_LEFT_DCLICK, handler);
+    return native::bind_event_helper(*this, wxEVT_MIDDLE_UP, handler, replace);
 }
 
-void widget::on_left_mouse_double_click_event_raw(const boost::function<void(mouse_event&)>& handler)
+connection widget::on_left_mouse_double_click_raw(const boost::function<void()>& handler, bool replace)
 {
-    native::bind_event_helper(*this, wxEVT_LEFT_DCLICK, handler);
+    return native::bind_helper(*this, wxEVT_LEFT_DCLICK, handler, replace);
 }
 
-void widget::on_right_mouse_double_click_raw(const boost::function<void()>& handler)
+connection widget::on_left_mouse_double_click_event_raw(const boost::function<void(mouse_event&)>& handler, bool replace)
 {
-    native::bind_helper(*this, wxEVT_RIGHT_DCLICK, handler);
+    return native::bind_event_helper(*this, wxEVT_LEFT_DCLICK, handler, replace);
 }
 
-void widget::on_right_mouse_double_click_event_raw(const boost::function<void(mouse_event&)>& handler)
+connection widget::on_right_mouse_double_click_raw(const boost::function<void()>& handler, bool replace)
 {
-    native::bind_event_helper(*this, wxEVT_RIGHT_DCLICK, handler);
+    return native::bind_helper(*this, wxEVT_RIGHT_DCLICK, handler, replace);
 }
 
-void widget::on_middle_mouse_double_click_raw(const boost::function<void()>& handler)
+connection widget::on_right_mouse_double_click_event_raw(const boost::function<void(mouse_event&)>& handler, bool replace)
 {
-    native::bind_helper(*this, wxEVT_MIDDLE_DCLICK, handler);
+    return native::bind_event_helper(*this, wxEVT_RIGHT_DCLICK, handler, replace);
 }
 
-void widget::on_middle_mouse_double_click_event_raw(const boost::function<void(mouse_event&)>& handler)
+connection widget::on_middle_mouse_double_click_raw(const boost::function<void()>& handler, bool replace)
 {
-    native::bind_event_helper(*this, wxEVT_MIDDLE_DCLICK, handler);
+    return native::bind_helper(*this, wxEVT_MIDDLE_DCLICK, handler, replace);
 }
 
-void widget::on_mouse_move_raw(const boost::function<void()>& handler)
+connection widget::on_middle_mouse_double_click_event_raw(const boost::function<void(mouse_event&)>& handler, bool replace)
 {
-    native::bind_helper(*this, wxEVT_MOTION, handler);
+    return native::bind_event_helper(*this, wxEVT_MIDDLE_DCLICK, handler, replace);
 }
 
-void widget::on_mouse_move_event_raw(const boost::function<void(mouse_event&)>& handler)
+connection widget::on_mouse_move_raw(const boost::function<void()>& handler, bool replace)
 {
-    native::bind_event_helper(*this, wxEVT_MOTION, handler);
+    if ( coalescing() )
+        return native::bind_coalesced_helper(*this, wxEVT_MOTION, handler, replace);
+
+    return native::bind_helper(*this, wxEVT_MOTION, handler, replace);
+}
+
+connection widget::on_mouse_move_event_raw(const boost::function<void(mouse_event&)>& handler, bool replace)
+{
+    if ( coalescing() )
+        return native::bind_coalesced_event_helper(*this, wxEVT_MOTION, handler, replace);
+
+    return native::bind_event_helper(*this, wxEVT_MOTION, handler, replace);
 }
 
 namespace {
@@ -489,56 +510,66 @@ public:
 
 } // namespace unnamed
 
-void widget::on_mouse_drag_raw(const boost::function<void()>& handler)
+connection widget::on_mouse_drag_raw(const boost::function<void()>& handler, bool replace)
 {
-    const boost::function<bool(wxMouseEvent&)> filter = mouse_drag_filter();
-    native::bind_helper(*this, wxEVT_MOTION, handler, filter);
+    if ( coalescing() )
+        return native::bind_coalesced_helper(*this, wxEVT_MOTION, handler, mouse_drag_filter(), replace);
+
+    return native::bind_helper(*this, wxEVT_MOTION, handler, mouse_drag_filter(), replace);
 }
 
-void widget::on_mouse_drag_event_raw(const boost::function<void(mouse_event&)>& handler)
+connection widget::on_mouse_drag_event_raw(const boost::function<void(mouse_event&)>& handler, bool replace)
 {
-    const boost::function<bool(wxMouseEvent&)> filter = mouse_drag_filter();
-    native::bind_event_helper(*this, wxEVT_MOTION, handler, filter);
+    if ( coalescing() )
+        return native::bind_coalesced_event_helper(*this, wxEVT_MOTION, handler, mouse_drag_filter(), replace);
+
+    return native::bind_event_helper(*this, wxEVT_MOTION, handler, mouse_drag_filter(), replace);
 }
 
-void widget::on_mouse_enter_raw(const boost::function<void()>& handler)
+connection widget::on_mouse_enter_raw(const boost::function<void()>& handler, bool replace)
 {
-    native::bind_helper(*this, wxEVT_ENTER_WINDOW, handler);
+    return native::bind_helper(*this, wxEVT_ENTER_WINDOW, handler, replace);
 }
 
-void widget::on_mouse_enter_event_raw(const boost::function<void(mouse_event&)>& handler)
+connection widget::on_mouse_enter_event_raw(const boost::function<void(mouse_event&)>& handler, bool replace)
 {
-    native::bind_event_helper(*this, wxEVT_ENTER_WINDOW, handler);
+    return native::bind_event_helper(*this, wxEVT_ENTER_WINDOW, handler, replace);
 }
 
-void widget::on_mouse_leave_raw(const boost::function<void()>& handler)
+connection widget::on_mouse_leave_raw(const boost::function<void()>& handler, bool replace)
 {
-    native::bind_helper(*this, wxEVT_LEAVE_WINDOW, handler);
+    return native::bind_helper(*this, wxEVT_LEAVE_WINDOW, handler, replace);
 }
 
-void widget::on_mouse_leave_event_raw(const boost::function<void(mouse_event&)>& handler)
+connection widget::on_mouse_leave_event_raw(const boost::function<void(mouse_event&)>& handler, bool replace)
 {
-    native::bind_event_helper(*this, wxEVT_LEAVE_WINDOW, handler);
+    return native::bind_event_helper(*this, wxEVT_LEAVE_WINDOW, handler, replace);
 }
 
-void widget::on_context_menu_raw(const boost::function<void()>& handler)
+connection widget::on_context_menu_raw(const boost::function<void()>& handler, bool replace)
 {
-    native::bind_helper(*this, wxEVT_CONTEXT_MENU, handler);
+    return native::bind_helper(*this, wxEVT_CONTEXT_MENU, handler, replace);
 }
 
-void widget::on_context_menu_event_raw(const boost::function<void(mouse_event&)>& handler)
+connection widget::on_context_menu_event_raw(const boost::function<void(mouse_event&)>& handler, bool replace)
 {
-    native::bind_event_helper(*this, wxEVT_CONTEXT_MENU, handler);
+    return native::bind_event_helper(*this, wxEVT_CONTEXT_MENU, handler, replace);
 }
 
-void widget::on_mouse_wheel_raw(const boost::function<void()>& handler)
+connection widget::on_mouse_wheel_raw(const boost::function<void()>& handler, bool replace)
 {
-    native::bind_helper(*this, wxEVT_MOUSEWHEEL, handler);
+    if ( coalescing() )
+        return native::bind_coalesced_helper(*this, wxEVT_MOUSEWHEEL, handler, replace);
+
+    return native::bind_helper(*this, wxEVT_MOUSEWHEEL, handler, replace);
 }
 
-void widget::on_mouse_wheel_event_raw(const boost::function<void(wheel_event&)>& handler)
+connection widget::on_mouse_wheel_event_raw(const boost::function<void(wheel_event&)>& handler, bool replace)
 {
-    native::bind_event_helper(*this, wxEVT_MOUSEWHEEL, handler);
+    if ( coalescing() )
+        return native::bind_coalesced_event_helper(*this, wxEVT_MOUSEWHEEL, handler, replace);
+
+    return native::bind_event_helper(*this, wxEVT_MOUSEWHEEL, handler, replace);
 }
 
 widget::native_handle_type widget::native_handle()
@@ -21,7 +21,7 @@ namespace ui    {
 namespace native {
 
 template <>
-void event_functor_event<wxCloseEvent, close_event>::init(close_event& uievent, wxCloseEvent& wxevent)
+void init_event<wxCloseEvent, close_event>(close_event& uievent, wxCloseEvent& wxevent)
 {
     uievent.m_veto_fn = boost::bind(&wxCloseEvent::Veto, boost::ref(wxevent), boost::placeholders::_1);
     uievent.m_skip_fn = boost::bind(&wxCloseEvent::Skip, boost::ref(wxevent), boost::placeholders::_1);
@@ -83,14 +83,14 @@ bool window::close()
     return impl->Close();
 }
 
-void window::on_close_raw(const boost::function<void()>& handler)
+connection window::on_close_raw(const boost::function<void()>& handler, bool replace)
 {
-    native::bind_helper(*this, wxEVT_CLOSE_WINDOW, handler);
+    return native::bind_helper(*this, wxEVT_CLOSE_WINDOW, handler, replace);
 }
 
-void window::on_close_event_raw(const boost::function<void(close_event&)>& handler)
+connection window::on_close_event_raw(const boost::function<void(close_event&)>& handler, bool replace)
 {
-    native::bind_event_helper(*this, wxEVT_CLOSE_WINDOW, handler);
+    return native::bind_event_helper(*this, wxEVT_CLOSE_WINDOW, handler, replace);
 }
 
 } // namespace ui
@@ -0,0 +1,133 @@
+// Copyright (c) 2018 Kolya Kosenko
+
+// Distributed under the Boost Software License, Version 1.0.
+// See http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/ui/async_log.hpp>
+#include <boost/ui/string_io.hpp>
+
+#include <boost/core/lightweight_test.hpp>
+#include <boost/detail/lightweight_main.hpp>
+
+#include <vector>
+#include <algorithm>
+
+#ifndef BOOST_NO_CXX11_HDR_THREAD
+#include <thread>
+#include <mutex>
+#endif
+
+namespace ui = boost::ui;
+
+// Collects messages, sink functions are called from the single log thread
+class memory_sink : public ui::log_sink
+{
+public:
+    explicit memory_sink(std::vector<ui::uistring>& messages)
+        : m_messages(messages) {}
+
+    void write(const ui::log_record* records, std::size_t count)
+    {
+        for ( std::size_t i = 0; i < count; i++ )
+        {
+            BOOST_TEST_NE(records[i].time, 0);
+            m_messages.push_back(records[i].message);
+        }
+    }
+
+private:
+    std::vector<ui::uistring>& m_messages;
+};
+
+void test_async_log()
+{
+    std::vector<ui::uistring> messages;
+    {
+        ui::async_log backend(4);
+        backend.add_sink(new memory_sink(messages));
+
+        BOOST_TEST(backend.push(ui::log_level::info, "a"));
+        BOOST_TEST(backend.push(ui::log_level::error, ui::uistring(L"\x0457")));
+        backend.flush();
+        BOOST_TEST_EQ(messages.size(), 2u);
+        BOOST_TEST_EQ(messages[0], "a");
+        BOOST_TEST_EQ(messages[1], L"\x0457");
+        BOOST_TEST_EQ(backend.dropped(), 0u);
+
+        // Log objects push into installed backend
+        BOOST_TEST(ui::async_log::installed() == NULL);
+        ui::async_log::install(&backend);
+        BOOST_TEST(ui::async_log::installed() == &backend);
+        ui::log::info() << "b";
+        BOOST_UI_LOG_ERROR << "c";
+        backend.flush();
+        BOOST_TEST_EQ(messages.size(), 4u);
+        BOOST_TEST_EQ(messages[2], "\"b\"");
+        BOOST_TEST_NE(messages[3].wstring().find(L"\"c\""), std::wstring::npos);
+
+        backend.push(ui::log_level::info, "d");
+    }
+    // Records are written before destruction
+    BOOST_TEST(ui::async_log::installed() == NULL);
+    BOOST_TEST_EQ(messages.size(), 5u);
+    BOOST_TEST_EQ(messages.back(), "d");
+}
+
+#ifndef BOOST_NO_CXX11_HDR_THREAD
+
+void test_overflow(ui::log_overflow overflow, std::size_t capacity)
+{
+    const int threads_count = 8;
+    const int records_count = 2000;
+
+    std::vector<ui::uistring> messages;
+    boost::uint64_t dropped = 0;
+    {
+        ui::async_log backend(capacity, overflow, 10);
+        backend.add_sink(new memory_sink(messages));
+
+        std::vector<std::thread> threads;
+        for ( int t = 0; t < threads_count; t++ )
+        {
+            threads.emplace_back([&backend, t]()
+            {
+                for ( int i = 0; i < records_count; i++ )
+                    backend.push(ui::log_level::debug, ui::to_uistring(t * records_count + i));
+            });
+        }
+        for ( std::size_t t = 0; t < threads.size(); t++ )
+            threads[t].join();
+
+        backend.flush();
+        dropped = backend.dropped();
+    }
+
+    BOOST_TEST_EQ(messages.size() + dropped, std::size_t(threads_count * records_count));
+    if ( overflow == ui::log_overflow::block )
+        BOOST_TEST_EQ(dropped, 0u);
+
+    // Records of every thread are kept in order
+    std::vector<int> last(threads_count, -1);
+    for ( std::size_t i = 0; i < messages.size(); i++ )
+    {
+        const int value = std::stoi(messages[i].wstring());
+        const int t = value / records_count;
+        BOOST_TEST_LT(last[t], value);
+        last[t] = value;
+    }
+}
+
+#endif
+
+int cpp_main(int, char*[])
+{
+    test_async_log();
+#ifndef BOOST_NO_CXX11_HDR_THREAD
+    test_overflow(ui::log_overflow::drop, 16);
+    test_overflow(ui::log_overflow::block, 16);
+    test_overflow(ui::log_overflow::sample, 16);
+    test_overflow(ui::log_overflow::drop, 1 << 16);
+#endif
+
+    return boost::report_errors();
+}
@@ -0,0 +1,84 @@
+// Copyright (c) 2018 Kolya Kosenko
+
+// Distributed under the Boost Software License, Version 1.0.
+// See http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/ui/atom.hpp>
+#include <boost/ui/string_io.hpp>
+
+#include <boost/functional/hash.hpp>
+
+#include <boost/core/lightweight_test.hpp>
+#include <boost/detail/lightweight_main.hpp>
+
+#include <vector>
+
+namespace ui = boost::ui;
+
+void test_atom()
+{
+    const std::size_t table_size = ui::atom::table_size();
+
+    ui::atom empty;
+    BOOST_TEST(empty.empty());
+    BOOST_TEST_EQ(empty.str(), "");
+    BOOST_TEST(empty == ui::atom(""));
+    BOOST_TEST_EQ(ui::atom::table_size(), table_size);
+
+    ui::atom a1("abc");
+    ui::atom a2(ui::uistring(L"abc"));
+    ui::atom b("b");
+    BOOST_TEST(!a1.empty());
+    BOOST_TEST(a1 == a2);
+    BOOST_TEST(a1 != b);
+    BOOST_TEST(&a1.str() == &a2.str());
+    BOOST_TEST(a1 < b);
+    BOOST_TEST(b > a1);
+    BOOST_TEST(a1 <= a2);
+    BOOST_TEST(empty < a1);
+    BOOST_TEST_EQ(ui::atom::table_size(), table_size + 2);
+
+    // Converted to uistring
+    const ui::uistring& str = a1;
+    BOOST_TEST_EQ(str, "abc");
+    BOOST_TEST(ui::uistring("abc") == a1);
+
+    boost::hash<ui::atom> boost_hash;
+    BOOST_TEST_EQ(boost_hash(a1), boost_hash(a2));
+    BOOST_TEST_EQ(a1.hash(), ui::hash_value(ui::uistring("abc")));
+#ifndef BOOST_UI_NO_STD_HASH
+    std::hash<ui::atom> std_hash;
+    BOOST_TEST_EQ(std_hash(a1), a1.hash());
+#endif
+
+    ui::atom copy(b);
+    copy = a1;
+    BOOST_TEST(copy == a1);
+    swap(copy, b);
+    BOOST_TEST_EQ(copy.str(), "b");
+    BOOST_TEST_EQ(b.str(), "abc");
+
+    {
+        // Many rows share few distinct strings
+        std::vector<ui::atom> rows;
+        const wchar_t* const levels[] = { L"info", L"warning", L"error" };
+        for ( int i = 0; i < 1000; i++ )
+            rows.push_back(levels[i % 3]);
+        BOOST_TEST_EQ(ui::atom::table_size(), table_size + 5);
+        BOOST_TEST(rows[0] == rows[3]);
+    }
+
+    // Released strings are removed from the table
+    BOOST_TEST_EQ(ui::atom::table_size(), table_size + 2);
+    a1 = a2 = b = ui::atom();
+    BOOST_TEST_EQ(ui::atom::table_size(), table_size + 1);
+    copy = empty;
+    BOOST_TEST_EQ(ui::atom::table_size(), table_size);
+}
+
+int cpp_main(int, char*[])
+{
+    test_atom();
+
+    return boost::report_errors();
+}
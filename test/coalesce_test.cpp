@@ -0,0 +1,210 @@
+// Copyright (c) 2018 Kolya Kosenko
+
+// Distributed under the Boost Software License, Version 1.0.
+// See http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/ui.hpp>
+#include <boost/ui/native/all.hpp>
+
+#include <boost/bind.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <boost/detail/lightweight_main.hpp>
+
+#include <wx/wx.h>
+
+#include <string>
+#include <vector>
+
+namespace ui = boost::ui;
+
+namespace {
+
+std::vector<ui::mouse_event> g_moves;
+std::vector<ui::wheel_event> g_wheels;
+std::string g_order;
+
+void on_mouse_move(ui::mouse_event& e)
+{
+    g_moves.push_back(e);
+    g_order += 'M';
+}
+
+void on_mouse_wheel(ui::wheel_event& e)
+{
+    g_wheels.push_back(e);
+}
+
+void on_left_mouse_down()
+{
+    g_order += 'D';
+}
+
+void send_motion(wxWindow* impl, int x, int y)
+{
+    wxMouseEvent wxevent(wxEVT_MOTION);
+    wxevent.SetEventObject(impl);
+    wxevent.SetX(x);
+    wxevent.SetY(y);
+    impl->GetEventHandler()->ProcessEvent(wxevent);
+}
+
+void send_wheel(wxWindow* impl, int rotation)
+{
+    wxMouseEvent wxevent(wxEVT_MOUSEWHEEL);
+    wxevent.SetEventObject(impl);
+    wxevent.m_wheelAxis = wxMOUSE_WHEEL_VERTICAL;
+    wxevent.m_wheelRotation = rotation;
+    wxevent.m_wheelDelta = 120;
+    impl->GetEventHandler()->ProcessEvent(wxevent);
+}
+
+void send_left_down(wxWindow* impl)
+{
+    wxMouseEvent wxevent(wxEVT_LEFT_DOWN);
+    wxevent.SetEventObject(impl);
+    impl->GetEventHandler()->ProcessEvent(wxevent);
+}
+
+// Runs one event loop iteration, deferred events are delivered before idle time
+void run_iteration()
+{
+    ui::event_loop loop;
+    ui::post(ui::task_priority::idle, boost::bind(&ui::event_loop::exit, &loop));
+    loop.run();
+}
+
+void reset()
+{
+    g_moves.clear();
+    g_wheels.clear();
+    g_order.clear();
+}
+
+} // unnamed namespace
+
+void test_mouse_move(ui::widget& parent)
+{
+    reset();
+
+    ui::canvas c(parent);
+    c.coalesce_events();
+    ui::scoped_connection move(c.connect_mouse_move_event(&on_mouse_move));
+    wxWindow* impl = ui::native::from_widget(c);
+
+    for ( int i = 1; i <= 5; i++ )
+        send_motion(impl, i * 10, i);
+    BOOST_TEST(g_moves.empty());
+
+    run_iteration();
+
+    BOOST_TEST_EQ(g_moves.size(), 1u);
+    if ( g_moves.size() == 1 )
+    {
+        BOOST_TEST_EQ(g_moves[0].x(), 50);
+        BOOST_TEST_EQ(g_moves[0].y(), 5);
+
+        const std::vector<ui::point>& history = g_moves[0].history();
+        BOOST_TEST_EQ(history.size(), 4u);
+        for ( std::size_t i = 0; i < history.size(); i++ )
+            BOOST_TEST(history[i] == ui::point(int(i + 1) * 10, int(i + 1)));
+    }
+
+    // Next iteration receives new events only
+    send_motion(impl, 60, 6);
+    run_iteration();
+    BOOST_TEST_EQ(g_moves.size(), 2u);
+    BOOST_TEST(g_moves.back().history().empty());
+}
+
+void test_mouse_wheel(ui::widget& parent)
+{
+    reset();
+
+    ui::canvas c(parent);
+    c.coalesce_events();
+    ui::scoped_connection wheel(c.connect_mouse_wheel_event(&on_mouse_wheel));
+    wxWindow* impl = ui::native::from_widget(c);
+
+    send_wheel(impl, 120);
+    send_wheel(impl, 120);
+    send_wheel(impl, -40);
+    run_iteration();
+
+    BOOST_TEST_EQ(g_wheels.size(), 1u);
+    if ( g_wheels.size() == 1 )
+    {
+        BOOST_TEST(g_wheels[0].vertical());
+        BOOST_TEST_EQ(g_wheels[0].delta_y(), 200);
+        BOOST_TEST_EQ(g_wheels[0].delta_x(), 0);
+    }
+}
+
+void test_not_coalesced(ui::widget& parent)
+{
+    reset();
+
+    ui::canvas c(parent);
+    c.coalesce_events();
+    c.coalesce_events(false);
+    ui::scoped_connection move(c.connect_mouse_move_event(&on_mouse_move));
+    ui::scoped_connection wheel(c.connect_mouse_wheel_event(&on_mouse_wheel));
+    wxWindow* impl = ui::native::from_widget(c);
+
+    // Events are delivered immediately
+    for ( int i = 1; i <= 3; i++ )
+    {
+        send_motion(impl, i, i);
+        BOOST_TEST_EQ(g_moves.size(), std::size_t(i));
+        send_wheel(impl, 120);
+        BOOST_TEST_EQ(g_wheels.size(), std::size_t(i));
+    }
+
+    BOOST_TEST_EQ(g_moves.size(), 3u);
+    BOOST_TEST_EQ(g_wheels.size(), 3u);
+    for ( std::size_t i = 0; i < g_moves.size(); i++ )
+        BOOST_TEST(g_moves[i].history().empty());
+    for ( std::size_t i = 0; i < g_wheels.size(); i++ )
+        BOOST_TEST_EQ(g_wheels[i].delta_y(), 120);
+
+    run_iteration();
+    BOOST_TEST_EQ(g_moves.size(), 3u);
+    BOOST_TEST_EQ(g_wheels.size(), 3u);
+}
+
+void test_order(ui::widget& parent)
+{
+    reset();
+
+    ui::canvas c(parent);
+    c.coalesce_events();
+    ui::scoped_connection move(c.connect_mouse_move_event(&on_mouse_move));
+    ui::scoped_connection down(c.connect_left_mouse_down(&on_left_mouse_down));
+    wxWindow* impl = ui::native::from_widget(c);
+
+    // Pending move is delivered before the next event of the widget
+    send_motion(impl, 1, 1);
+    send_motion(impl, 2, 2);
+    send_left_down(impl);
+    BOOST_TEST_EQ(g_order, "MD");
+
+    run_iteration();
+    BOOST_TEST_EQ(g_order, "MD");
+    BOOST_TEST_EQ(g_moves.size(), 1u);
+}
+
+int ui_main()
+{
+    ui::dialog dlg("Title");
+
+    test_mouse_move(dlg);
+    test_mouse_wheel(dlg);
+    test_not_coalesced(dlg);
+    test_order(dlg);
+
+    return boost::report_errors();
+}
+
+int cpp_main(int argc, char* argv[])
+{
+    return ui::entry(&ui_main, argc, argv);
+}
@@ -0,0 +1,284 @@
+// Copyright (c) 2018 Kolya Kosenko
+
+// Distributed under the Boost Software License, Version 1.0.
+// See http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/ui.hpp>
+#include <boost/ui/native/all.hpp>
+
+#include <boost/core/lightweight_test.hpp>
+#include <boost/detail/lightweight_main.hpp>
+
+#include <wx/wx.h>
+#include <wx/menu.h>
+
+namespace ui = boost::ui;
+
+int alive = 0;
+int disconnected = 0;
+
+// Connection to the fake event source
+class test_state : public ui::detail::connection_state
+{
+public:
+    explicit test_state(int type = 1) { alive++; register_source(&alive, type, NULL); }
+    ~test_state() { alive--; }
+
+    static void replace(int type) { disconnect_all(&alive, type, NULL); }
+
+protected:
+    void do_disconnect() { disconnected++; }
+};
+
+void test_connection()
+{
+    ui::connection empty;
+    BOOST_TEST(!empty.connected());
+    empty.disconnect();
+
+    {
+        ui::connection c(new test_state);
+        BOOST_TEST(c.connected());
+        BOOST_TEST_EQ(alive, 1);
+
+        ui::connection copy = c;
+        BOOST_TEST(copy == c);
+        BOOST_TEST(copy != empty);
+
+        copy.disconnect();
+        BOOST_TEST(!c.connected());
+        BOOST_TEST_EQ(disconnected, 1);
+
+        c.disconnect();
+        BOOST_TEST_EQ(disconnected, 1);
+    }
+    BOOST_TEST_EQ(alive, 0);
+}
+
+void test_scoped_connection()
+{
+    disconnected = 0;
+
+    ui::connection c(new test_state);
+    {
+        ui::scoped_connection sc(c);
+        BOOST_TEST(sc.connected());
+    }
+    BOOST_TEST(!c.connected());
+    BOOST_TEST_EQ(disconnected, 1);
+
+    ui::connection c1(new test_state);
+    ui::connection c2(new test_state);
+    {
+        ui::scoped_connection sc(c1);
+        sc = c1;
+        BOOST_TEST(c1.connected());
+        sc = c2;
+        BOOST_TEST(!c1.connected());
+        BOOST_TEST(c2.connected());
+
+        ui::connection released = sc.release();
+        BOOST_TEST(released == c2);
+        BOOST_TEST(!sc.connected());
+    }
+    BOOST_TEST(c2.connected());
+    BOOST_TEST_EQ(disconnected, 2);
+
+    c2.disconnect();
+}
+
+void test_replace()
+{
+    disconnected = 0;
+
+    ui::connection c1(new test_state(1));
+    ui::connection c2(new test_state(1));
+    ui::connection c3(new test_state(2));
+
+    test_state::replace(1);
+    BOOST_TEST(!c1.connected());
+    BOOST_TEST(!c2.connected());
+    BOOST_TEST(c3.connected());
+    BOOST_TEST_EQ(disconnected, 2);
+
+    test_state::replace(1);
+    BOOST_TEST_EQ(disconnected, 2);
+
+    // Disconnected state isn't replaced
+    c3.disconnect();
+    test_state::replace(2);
+    BOOST_TEST_EQ(disconnected, 3);
+}
+
+int g_calls[3];
+ui::connection g_self;
+
+void count(int index)
+{
+    g_calls[index]++;
+}
+
+void disconnect_self()
+{
+    g_calls[0]++;
+    g_self.disconnect();
+}
+
+void reset_calls()
+{
+    g_calls[0] = g_calls[1] = g_calls[2] = 0;
+}
+
+void press(ui::button& b)
+{
+    wxWindow* impl = ui::native::from_widget(b);
+    wxCommandEvent wxevent(wxEVT_BUTTON, impl->GetId());
+    wxevent.SetEventObject(impl);
+    impl->GetEventHandler()->ProcessEvent(wxevent);
+}
+
+void press(ui::menu& m, ui::menu::item& i)
+{
+    wxMenu* menu_impl = static_cast<wxMenu*>(m.native_handle());
+    wxMenuItem* item_impl = static_cast<wxMenuItem*>(i.native_handle());
+    wxCommandEvent wxevent(wxEVT_MENU, item_impl->GetId());
+    wxevent.SetEventObject(menu_impl);
+    menu_impl->ProcessEvent(wxevent);
+}
+
+void test_widget_disconnect(ui::widget& parent)
+{
+    reset_calls();
+
+    ui::button b(parent, "Button");
+    ui::connection c = b.connect_press(&count, 0);
+    ui::connection other = b.connect_press(&count, 1);
+
+    press(b);
+    BOOST_TEST_EQ(g_calls[0], 1);
+    BOOST_TEST_EQ(g_calls[1], 1);
+
+    c.disconnect();
+    BOOST_TEST(!c.connected());
+    press(b);
+    press(b);
+    BOOST_TEST_EQ(g_calls[0], 1);
+    BOOST_TEST_EQ(g_calls[1], 3);
+
+    // Handler disconnects itself while it is called
+    g_self = b.connect_press(&disconnect_self);
+    press(b);
+    press(b);
+    BOOST_TEST_EQ(g_calls[0], 2);
+    BOOST_TEST_EQ(g_calls[1], 5);
+    BOOST_TEST(!g_self.connected());
+    g_self = ui::connection();
+
+    other.disconnect();
+    press(b);
+    BOOST_TEST_EQ(g_calls[1], 5);
+}
+
+void test_widget_replace(ui::widget& parent)
+{
+    reset_calls();
+
+    ui::button b(parent, "Button");
+    ui::connection c0 = b.connect_press(&count, 0);
+    ui::connection c1 = b.connect_press(&count, 1);
+    press(b);
+
+    ui::connection c2 = b.replace_press(&count, 2);
+    BOOST_TEST(!c0.connected());
+    BOOST_TEST(!c1.connected());
+    BOOST_TEST(c2.connected());
+
+    press(b);
+    press(b);
+    BOOST_TEST_EQ(g_calls[0], 1);
+    BOOST_TEST_EQ(g_calls[1], 1);
+    BOOST_TEST_EQ(g_calls[2], 2);
+
+    // Handlers of other events are kept
+    ui::connection move = b.connect_mouse_move(&count, 0);
+    b.replace_press(&count, 1);
+    BOOST_TEST(move.connected());
+    BOOST_TEST(!c2.connected());
+}
+
+void test_widget_scoped_connection(ui::widget& parent)
+{
+    reset_calls();
+
+    ui::button b(parent, "Button");
+    ui::connection c = b.connect_press(&count, 0);
+    {
+        ui::scoped_connection sc(b.connect_press(&count, 1));
+        press(b);
+        BOOST_TEST_EQ(g_calls[1], 1);
+
+        // Assignment disconnects previous handler
+        sc = b.connect_press(&count, 2);
+        press(b);
+        BOOST_TEST_EQ(g_calls[1], 1);
+        BOOST_TEST_EQ(g_calls[2], 1);
+    }
+    press(b);
+    BOOST_TEST_EQ(g_calls[0], 3);
+    BOOST_TEST_EQ(g_calls[1], 1);
+    BOOST_TEST_EQ(g_calls[2], 1);
+}
+
+void test_menu()
+{
+    reset_calls();
+
+    ui::menu m("Menu");
+    ui::menu::item i("Item");
+    m << i;
+
+    ui::connection c0 = i.connect_press(&count, 0);
+    press(m, i);
+    BOOST_TEST_EQ(g_calls[0], 1);
+
+    {
+        ui::scoped_connection sc(i.connect_press(&count, 1));
+        press(m, i);
+        BOOST_TEST_EQ(g_calls[0], 2);
+        BOOST_TEST_EQ(g_calls[1], 1);
+    }
+    press(m, i);
+    BOOST_TEST_EQ(g_calls[1], 1);
+
+    ui::connection c2 = i.replace_press(&count, 2);
+    BOOST_TEST(!c0.connected());
+    press(m, i);
+    BOOST_TEST_EQ(g_calls[0], 3);
+    BOOST_TEST_EQ(g_calls[2], 1);
+
+    c2.disconnect();
+    press(m, i);
+    BOOST_TEST_EQ(g_calls[2], 1);
+}
+
+int ui_main()
+{
+    ui::dialog dlg("Title");
+
+    test_widget_disconnect(dlg);
+    test_widget_replace(dlg);
+    test_widget_scoped_connection(dlg);
+    test_menu();
+
+    return boost::report_errors();
+}
+
+int cpp_main(int argc, char* argv[])
+{
+    test_connection();
+    test_scoped_connection();
+    test_replace();
+    BOOST_TEST_EQ(alive, 0);
+
+    return ui::entry(&ui_main, argc, argv);
+}
@@ -0,0 +1,105 @@
+// Copyright (c) 2018 Kolya Kosenko
+
+// Distributed under the Boost Software License, Version 1.0.
+// See http://www.boost.org/LICENSE_1_0.txt
+
+// Event dispatch benchmark, checks that dispatch doesn't allocate memory
+
+#include <boost/ui.hpp>
+#include <boost/ui/native/all.hpp>
+
+#include <boost/core/lightweight_test.hpp>
+#include <boost/detail/lightweight_main.hpp>
+
+#include <wx/wx.h>
+#include <wx/stopwatch.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+namespace ui = boost::ui;
+
+namespace {
+
+long g_allocations = 0;
+
+} // unnamed namespace
+
+void* operator new(std::size_t size)
+{
+    ++g_allocations;
+
+    void* p = std::malloc(size ? size : 1);
+    if ( !p )
+        throw std::bad_alloc();
+
+    return p;
+}
+
+void operator delete(void* p) BOOST_NOEXCEPT
+{
+    std::free(p);
+}
+
+namespace {
+
+const int events_count = 100000;
+
+int g_calls = 0;
+
+void on_move()
+{
+    ++g_calls;
+}
+
+void on_drag(ui::mouse_event& e)
+{
+    g_calls += e.x();
+}
+
+void benchmark(const char* name, wxWindow* impl, wxMouseEvent& wxevent)
+{
+    impl->GetEventHandler()->ProcessEvent(wxevent); // Warm up
+
+    g_calls = 0;
+    const long allocations = g_allocations;
+    wxStopWatch sw;
+
+    for ( int i = 0; i < events_count; i++ )
+        impl->GetEventHandler()->ProcessEvent(wxevent);
+
+    const long elapsed = sw.TimeInMicro().ToLong();
+    BOOST_TEST_EQ(g_allocations - allocations, 0);
+
+    std::cout << name << ": " << elapsed * 1000 / events_count
+              << " ns per event" << std::endl;
+}
+
+} // unnamed namespace
+
+int ui_main()
+{
+    ui::dialog dlg("Title");
+    wxWindow* impl = ui::native::from_widget(dlg);
+
+    wxMouseEvent wxevent(wxEVT_MOTION);
+    wxevent.SetEventObject(impl);
+    wxevent.SetX(1);
+
+    ui::scoped_connection move(dlg.connect_mouse_move(&on_move));
+    benchmark("mouse move", impl, wxevent);
+    BOOST_TEST_EQ(g_calls, events_count);
+
+    wxevent.SetLeftDown(true);
+    ui::scoped_connection drag(dlg.connect_mouse_drag_event(&on_drag));
+    benchmark("mouse move and drag", impl, wxevent);
+    BOOST_TEST_EQ(g_calls, events_count * 2);
+
+    return boost::report_errors();
+}
+
+int cpp_main(int argc, char* argv[])
+{
+    return ui::entry(&ui_main, argc, argv);
+}
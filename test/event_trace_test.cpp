@@ -0,0 +1,152 @@
+// Copyright (c) 2018 Kolya Kosenko
+
+// Distributed under the Boost Software License, Version 1.0.
+// See http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/ui.hpp>
+#include <boost/ui/native/all.hpp>
+
+#include <boost/core/lightweight_test.hpp>
+#include <boost/detail/lightweight_main.hpp>
+
+#include <wx/wx.h>
+
+#include <sstream>
+
+namespace ui = boost::ui;
+
+namespace {
+
+void on_fast()
+{
+}
+
+void on_slow()
+{
+    wxMilliSleep(5);
+}
+
+std::size_t histogram_count(const ui::handler_stats& stats)
+{
+    std::size_t count = 0;
+    for ( std::size_t i = 0; i < ui::handler_stats::buckets; i++ )
+        count += stats.histogram[i];
+    return count;
+}
+
+} // unnamed namespace
+
+void test_stats(ui::widget& parent)
+{
+    ui::button b(parent, "Button");
+    wxWindow* impl = ui::native::from_widget(b);
+
+    wxCommandEvent wxevent(wxEVT_BUTTON, impl->GetId());
+    wxevent.SetEventObject(impl);
+
+    ui::scoped_connection fast(b.connect_press(&on_fast));
+
+    impl->GetEventHandler()->ProcessEvent(wxevent);
+    BOOST_TEST(ui::event_trace::snapshot().empty());
+
+    ui::event_trace::enable();
+    ui::event_trace::budget(1);
+
+    for ( int i = 0; i < 3; i++ )
+        impl->GetEventHandler()->ProcessEvent(wxevent);
+
+    std::vector<ui::handler_stats> stats = ui::event_trace::snapshot();
+    BOOST_TEST_EQ(stats.size(), 1u);
+    BOOST_TEST_EQ(stats[0].event, "press");
+    BOOST_TEST_EQ(stats[0].count, 3u);
+    BOOST_TEST_EQ(histogram_count(stats[0]), 3u);
+
+    ui::scoped_connection slow(b.connect_press(&on_slow));
+    impl->GetEventHandler()->ProcessEvent(wxevent);
+
+    stats = ui::event_trace::snapshot();
+    BOOST_TEST_EQ(stats.size(), 1u);
+    BOOST_TEST_EQ(stats[0].count, 5u);
+    BOOST_TEST_EQ(stats[0].slow, 1u);
+    BOOST_TEST(stats[0].max >= 5000);
+    BOOST_TEST(stats[0].total >= stats[0].max);
+
+    std::ostringstream ss;
+    ui::event_trace::write_chrome_trace(ss);
+    BOOST_TEST(ss.str().find("\"traceEvents\"") != std::string::npos);
+    BOOST_TEST(ss.str().find("\"name\":\"press\"") != std::string::npos);
+
+    ui::event_trace::enable(false);
+    ui::event_trace::reset();
+    BOOST_TEST(ui::event_trace::snapshot().empty());
+    ui::event_trace::budget(16);
+}
+
+void press_in_dialog(const char* label)
+{
+    ui::dialog dlg("Temporary");
+    ui::button b(dlg, label);
+    wxWindow* impl = ui::native::from_widget(b);
+
+    wxCommandEvent wxevent(wxEVT_BUTTON, impl->GetId());
+    wxevent.SetEventObject(impl);
+
+    ui::scoped_connection fast(b.connect_press(&on_fast));
+    impl->GetEventHandler()->ProcessEvent(wxevent);
+}
+
+std::size_t widget_count(const std::vector<ui::handler_stats>& stats,
+                         const char* widget)
+{
+    for ( std::size_t i = 0; i < stats.size(); i++ )
+    {
+        if ( stats[i].widget.string().find(widget) != std::string::npos )
+            return stats[i].count;
+    }
+    return 0;
+}
+
+void test_destroyed()
+{
+    ui::event_trace::enable();
+
+    // Widget created at the address of the destroyed one has own statistics
+    press_in_dialog("First");
+    press_in_dialog("Second");
+    press_in_dialog("First");
+
+    const std::vector<ui::handler_stats> stats = ui::event_trace::snapshot();
+    BOOST_TEST_EQ(stats.size(), 2u);
+    BOOST_TEST_EQ(widget_count(stats, "First"), 2u);
+    BOOST_TEST_EQ(widget_count(stats, "Second"), 1u);
+
+    std::ostringstream ss;
+    ui::event_trace::write_chrome_trace(ss);
+    BOOST_TEST(ss.str().find("First") != std::string::npos);
+
+    ui::event_trace::enable(false);
+    ui::event_trace::reset();
+}
+
+void test_buckets()
+{
+    BOOST_TEST_EQ(ui::event_trace::bucket_limit(0), 64);
+    BOOST_TEST_EQ(ui::event_trace::bucket_limit(1), 128);
+    BOOST_TEST_EQ(ui::event_trace::bucket_limit(ui::handler_stats::buckets - 1), -1);
+}
+
+int ui_main()
+{
+    ui::dialog dlg("Title");
+
+    test_stats(dlg);
+    test_destroyed();
+    test_buckets();
+
+    return boost::report_errors();
+}
+
+int cpp_main(int argc, char* argv[])
+{
+    return ui::entry(&ui_main, argc, argv);
+}
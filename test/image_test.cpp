@@ -5,6 +5,7 @@
 
 #include <boost/ui.hpp>
 #include <fstream>
+#include <sstream>
 
 #include <boost/core/lightweight_test.hpp>
 #include <boost/detail/lightweight_main.hpp>
@@ -32,6 +33,18 @@ int ui_main(int argc, char* argv[])
         BOOST_TEST_EQ(img.width(),  16);
         BOOST_TEST_EQ(img.height(), 16);
 
+        std::stringstream ss_png;
+        img.save(ss_png, ui::image::format::png, 100);
+        ui::image img_png;
+        img_png.load(ss_png);
+        BOOST_TEST(img_png.valid());
+        BOOST_TEST_EQ(img_png.width(),  16);
+        BOOST_TEST_EQ(img_png.height(), 16);
+
+        std::stringstream ss_bmp;
+        img.save(ss_bmp, ui::image::format::bmp);
+        BOOST_TEST(!ss_bmp.str().empty());
+
         ui::image img2 = img;
         BOOST_TEST(img2.valid());
         BOOST_TEST(img2.native_handle());
@@ -40,12 +53,35 @@ int ui_main(int argc, char* argv[])
         BOOST_TEST(!img2.valid());
         BOOST_TEST(img2.native_handle());
 
+        std::ostringstream oss;
+        BOOST_TEST_THROWS(img2.save(oss, ui::image::format::png), std::runtime_error);
+
         std::istringstream ss;
         BOOST_TEST_THROWS(img.load(fs), std::runtime_error);
         BOOST_TEST(!img.valid());
         BOOST_TEST(img.native_handle());
     }
 
+    {
+        std::ifstream fs(argv[1], std::ios::binary);
+        const ui::image_info info = ui::image::probe(fs);
+        BOOST_TEST(info.valid());
+        BOOST_TEST(info.get_format() == ui::image::format::ico);
+        BOOST_TEST_EQ(info.width(),  16);
+        BOOST_TEST_EQ(info.height(), 16);
+        BOOST_TEST_EQ(info.bits_per_pixel(), 4);
+        BOOST_TEST_EQ(info.frames(), 1u);
+
+        const ui::image_info info2 = ui::image::probe(argv[1]);
+        BOOST_TEST(info2.valid());
+        BOOST_TEST(info2.dimensions() == info.dimensions());
+
+        std::istringstream ss("not an image");
+        BOOST_TEST(!ui::image::probe(ss).valid());
+
+        BOOST_TEST_THROWS(ui::image::probe("nonexistent.png"), std::runtime_error);
+    }
+
     {
         const ui::image img = ui::image::xdg("folder", 32, 32);
         BOOST_TEST(img.valid());
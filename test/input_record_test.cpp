@@ -0,0 +1,126 @@
+// Copyright (c) 2018 Kolya Kosenko
+
+// Distributed under the Boost Software License, Version 1.0.
+// See http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/ui.hpp>
+#include <boost/ui/native/all.hpp>
+
+#include <boost/bind.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <boost/detail/lightweight_main.hpp>
+
+#include <wx/wx.h>
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace ui = boost::ui;
+
+namespace {
+
+const char* const file_name = "input_record_test.bin";
+
+std::vector<ui::point> g_positions;
+int g_key_code = 0;
+
+void on_mouse_move(ui::mouse_event& e)
+{
+    g_positions.push_back(e.pos());
+}
+
+void on_key_down(ui::key_event& e)
+{
+    g_key_code = e.key_code();
+}
+
+void send_events(wxWindow* impl)
+{
+    for ( int i = 0; i < 5; i++ )
+    {
+        wxMouseEvent wxevent(wxEVT_MOTION);
+        wxevent.SetEventObject(impl);
+        wxevent.SetX(i * 10);
+        wxevent.SetY(i * 5);
+        impl->GetEventHandler()->ProcessEvent(wxevent);
+    }
+
+    wxKeyEvent wxevent(wxEVT_KEY_DOWN);
+    wxevent.SetEventObject(impl);
+    wxevent.m_keyCode = 'A';
+    impl->GetEventHandler()->ProcessEvent(wxevent);
+}
+
+} // unnamed namespace
+
+void test_record(ui::widget& parent)
+{
+    ui::canvas c(parent);
+    c.on_mouse_move_event(&on_mouse_move)
+     .on_key_down_event(&on_key_down);
+
+    {
+        ui::input_recorder recorder(parent);
+        BOOST_TEST(recorder.is_recording());
+
+        send_events(ui::native::from_widget(c));
+
+        recorder.stop();
+        BOOST_TEST(!recorder.is_recording());
+        BOOST_TEST_EQ(recorder.size(), 6u);
+
+        recorder.save(file_name);
+    }
+
+    const std::vector<ui::point> positions = g_positions;
+    BOOST_TEST_EQ(positions.size(), 5u);
+    BOOST_TEST_EQ(g_key_code, 'A');
+    g_positions.clear();
+    g_key_code = 0;
+
+    ui::input_player player(file_name);
+    BOOST_TEST_EQ(player.size(), 6u);
+
+    ui::event_loop loop;
+    player.on_finish(boost::bind(&ui::event_loop::exit, &loop));
+    player.play(parent, 0);
+    BOOST_TEST(player.is_playing());
+    loop.run();
+
+    BOOST_TEST(!player.is_playing());
+    BOOST_TEST(g_positions == positions);
+    BOOST_TEST_EQ(g_key_code, 'A');
+
+    std::remove(file_name);
+}
+
+void test_wrong_file()
+{
+    BOOST_TEST_THROWS(ui::input_player player("input_record_test_missing.bin"),
+                      std::runtime_error);
+
+    {
+        std::ofstream file(file_name, std::ios::binary);
+        file << "BUIR garbage";
+    }
+    BOOST_TEST_THROWS(ui::input_player player(file_name), std::runtime_error);
+
+    std::remove(file_name);
+}
+
+int ui_main()
+{
+    ui::dialog dlg("Title");
+
+    test_record(dlg);
+    test_wrong_file();
+
+    return boost::report_errors();
+}
+
+int cpp_main(int argc, char* argv[])
+{
+    return ui::entry(&ui_main, argc, argv);
+}
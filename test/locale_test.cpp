@@ -0,0 +1,74 @@
+// Copyright (c) 2018 Kolya Kosenko
+
+// Distributed under the Boost Software License, Version 1.0.
+// See http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/ui/locale.hpp>
+#include <boost/ui/string_io.hpp>
+
+#include <boost/core/lightweight_test.hpp>
+#include <boost/detail/lightweight_main.hpp>
+
+#include <algorithm>
+#include <cwchar> // WCHAR_MAX
+
+namespace ui = boost::ui;
+
+void test_collator()
+{
+    const ui::collator coll(std::locale::classic());
+
+    BOOST_TEST_LT(coll.compare("abc", "abd"), 0);
+    BOOST_TEST_GT(coll.compare("abc", "ab"), 0);
+    BOOST_TEST_EQ(coll.compare("abc", "abc"), 0);
+    BOOST_TEST(coll("a", "b"));
+    BOOST_TEST(!coll("b", "a"));
+
+    // Classic locale collates by code points,
+    // sort keys are ordered the same way
+    const wchar_t* const strings[] =
+    {
+        L"", L"a", L"ab", L"b", L"\x7F", L"\x80", L"\x3FFF", L"\x4000", L"\xFFFD",
+#if WCHAR_MAX > 0xFFFF
+        // Single wchar_t holds code point above U+FFFF
+        L"\U00010000"
+#endif
+    };
+    const std::size_t count = sizeof strings / sizeof strings[0];
+    for ( std::size_t i = 0; i < count; i++ )
+    {
+        for ( std::size_t j = 0; j < count; j++ )
+        {
+            const std::string lhs = coll.sort_key(strings[i]);
+            const std::string rhs = coll.sort_key(strings[j]);
+            BOOST_TEST_EQ(lhs < rhs, i < j);
+            BOOST_TEST_EQ(lhs == rhs, i == j);
+        }
+    }
+
+    std::vector<ui::uistring> sorted;
+    for ( std::size_t i = 0; i < count; i++ )
+        sorted.push_back(strings[count - i - 1]);
+    coll.sort(sorted);
+    for ( std::size_t i = 0; i < count; i++ )
+        BOOST_TEST_EQ(sorted[i], strings[i]);
+
+    // Parallel sort gives the same result
+    std::vector<ui::uistring> names;
+    for ( unsigned i = 0; i < 10000; i++ )
+        names.push_back(ui::to_uistring(i * 7919 % 10007) + L"\x0457");
+    std::vector<ui::uistring> expected(names);
+    std::sort(expected.begin(), expected.end(), coll);
+    std::vector<ui::uistring> parallel(names);
+    coll.parallel_sort(parallel, 4);
+    BOOST_TEST(parallel == expected);
+    coll.sort(names);
+    BOOST_TEST(names == expected);
+}
+
+int cpp_main(int, char*[])
+{
+    test_collator();
+
+    return boost::report_errors();
+}
@@ -4,11 +4,16 @@
 // See http://www.boost.org/LICENSE_1_0.txt
 
 #include <boost/ui/log.hpp>
+#include <boost/ui/async_log.hpp>
 #include <boost/ui/string_io.hpp>
 
 #include <boost/core/lightweight_test.hpp>
 #include <boost/detail/lightweight_main.hpp>
 
+#include <wx/utils.h>
+
+#include <vector>
+
 namespace ui = boost::ui;
 
 void test_output(ui::log_string& l)
@@ -21,8 +26,188 @@ void test_output(ui::log_string& l)
         ;
 }
 
+int evaluated = 0;
+
+int evaluate()
+{
+    return ++evaluated;
+}
+
+void test_level()
+{
+    BOOST_TEST(ui::log::min_level() == ui::log_level::trace);
+    BOOST_TEST(ui::log::enabled(ui::log_level::error));
+
+    BOOST_UI_LOG_DEBUG << "debug" << evaluate();
+    BOOST_TEST_EQ(evaluated, 1);
+
+    ui::log::min_level(ui::log_level::info);
+    BOOST_TEST(ui::log::min_level() == ui::log_level::info);
+    BOOST_TEST(ui::log::enabled(ui::log_level::warning));
+    BOOST_TEST(ui::log::enabled(ui::log_level::info));
+    BOOST_TEST(!ui::log::enabled(ui::log_level::debug));
+    BOOST_TEST(!ui::log::enabled(ui::log_level::trace));
+
+    // Disabled log arguments aren't evaluated
+    BOOST_UI_LOG_DEBUG << "debug" << evaluate();
+    BOOST_UI_LOG_TRACE << evaluate();
+    if ( evaluated )
+        BOOST_UI_LOG_TRACE << evaluate();
+    else
+        evaluate();
+    BOOST_TEST_EQ(evaluated, 1);
+
+    ui::log::debug() << "debug";
+
+    ui::log::min_level(ui::log_level::trace);
+    BOOST_UI_LOG_TRACE << evaluate();
+    BOOST_TEST_EQ(evaluated, 2);
+}
+
+struct hex_value
+{
+    int value;
+};
+
+std::ostream& operator<<(std::ostream& os, const hex_value& v)
+{
+    // Nested logging uses own buffers
+    ui::uistring str;
+    ui::log_string(str) << 1.5 << "nested";
+    BOOST_TEST_EQ(str, "1.5 \"nested\"");
+    ui::log::debug() << "nested";
+
+    return os << std::hex << std::showbase << v.value;
+}
+
+void test_reuse()
+{
+    for ( int i = 0; i < 3; i++ )
+    {
+        ui::uistring str;
+        hex_value v = { 255 };
+        ui::log_string(str).location("file.cpp", 12, "fn") << v << 255 << false;
+        BOOST_TEST_EQ(str, "file.cpp[12] fn: 0xff 255 false");
+    }
+    {
+        ui::uistring str;
+        ui::log_string(str).location("file.cpp");
+        BOOST_TEST_EQ(str, "file.cpp:");
+    }
+    {
+        const std::string long_value(100, 'x');
+        for ( int i = 0; i < 3; i++ )
+        {
+            ui::uistring str;
+            ui::log_string(str).noquotes() << long_value << 1 << long_value;
+            BOOST_TEST_EQ(str, ui::uistring(long_value + " 1 " + long_value));
+            ui::log::debug() << long_value << i;
+        }
+    }
+}
+
+class memory_sink : public ui::log_sink
+{
+public:
+    explicit memory_sink(std::vector<ui::uistring>& messages)
+        : m_messages(messages) {}
+
+    void write(const ui::log_record* records, std::size_t count)
+    {
+        for ( std::size_t i = 0; i < count; i++ )
+            m_messages.push_back(records[i].message);
+    }
+
+private:
+    std::vector<ui::uistring>& m_messages;
+};
+
+int formatted = 0;
+
+struct counted {};
+
+std::ostream& operator<<(std::ostream& os, const counted&)
+{
+    formatted++;
+    return os << "counted";
+}
+
+bool contains(const ui::uistring& str, const wchar_t* substr)
+{
+    return str.wstring().find(substr) != std::wstring::npos;
+}
+
+void test_throttle()
+{
+    std::vector<ui::uistring> messages;
+    ui::async_log backend;
+    backend.add_sink(new memory_sink(messages));
+    ui::async_log::install(&backend);
+
+    ui::log::repeat_window(60000);
+    for ( int i = 0; i < 5; i++ )
+        BOOST_UI_LOG_ERROR << "repeated";
+    for ( int i = 0; i < 2; i++ )
+        BOOST_UI_LOG_ERROR << "value" << i;
+    for ( int i = 0; i < 6; i++ )
+        BOOST_UI_LOG_WARNING << (i < 5 ? "same" : "other");
+    ui::log::repeat_window(0);
+
+    // Count of the last suppressed messages is logged when suppression is disabled
+    backend.flush();
+    BOOST_TEST_EQ(messages.size(), 7u);
+    if ( messages.size() == 7u )
+    {
+        BOOST_TEST(contains(messages[0], L": \"repeated\""));
+        BOOST_TEST(contains(messages[1], L": \"value\" 0"));
+        BOOST_TEST(contains(messages[2], L": \"value\" 1"));
+        BOOST_TEST(contains(messages[3], L": \"same\""));
+        BOOST_TEST(contains(messages[4], L": 4 similar messages suppressed"));
+        BOOST_TEST(contains(messages[5], L": \"other\""));
+        BOOST_TEST(contains(messages[6], L": 4 similar messages suppressed"));
+    }
+    messages.clear();
+
+    // Count is logged by a message from other location after the window is over
+    ui::log::repeat_window(20);
+    for ( int i = 0; i < 3; i++ )
+        BOOST_UI_LOG_WARNING << "flood";
+    wxMilliSleep(50);
+    BOOST_UI_LOG_WARNING << "next";
+    ui::log::repeat_window(0);
+
+    backend.flush();
+    BOOST_TEST_EQ(messages.size(), 3u);
+    if ( messages.size() == 3u )
+    {
+        BOOST_TEST(contains(messages[0], L": \"flood\""));
+        BOOST_TEST(contains(messages[1], L": 2 similar messages suppressed"));
+        BOOST_TEST(contains(messages[2], L": \"next\""));
+    }
+    messages.clear();
+
+    // Messages over the limit aren't formatted
+    ui::log::rate_limit(1, 3);
+    for ( int i = 0; i < 10; i++ )
+        BOOST_UI_LOG_INFO << counted();
+    ui::log::rate_limit(0);
+    BOOST_UI_LOG_INFO << counted();
+
+    backend.flush();
+    BOOST_TEST_EQ(formatted, 4);
+    BOOST_TEST_EQ(messages.size(), 5u);
+    if ( messages.size() == 5u )
+        BOOST_TEST(contains(messages[3], L": 7 similar messages suppressed"));
+
+    ui::async_log::install(NULL);
+}
+
 int cpp_main(int, char*[])
 {
+    test_level();
+    test_reuse();
+    test_throttle();
+
     {
         ui::uistring str;
         test_output(ui::log_string(str).nospaces().noquotes());
@@ -8,6 +8,8 @@
 #include <boost/core/lightweight_test.hpp>
 #include <boost/detail/lightweight_main.hpp>
 
+#include <sstream>
+
 namespace ui = boost::ui;
 
 template <class Stream>
@@ -83,5 +85,21 @@ int cpp_main(int, char*[])
         BOOST_TEST(ss2.str() == "2");
     }
 
+    {
+        ui::uiostringstream ss;
+        ss.reserve(100);
+        ss << -12 << ' ' << 34u << ' ' << 0.1 << ' ' << 2.5f << ' ' << ui::uistring(L"\x0457");
+        BOOST_TEST(ss.str() == L"-12 34 0.1 2.5 \x0457");
+
+        // Storage is reused
+        for ( int i = 0; i < 3; i++ )
+        {
+            ss.clear();
+            BOOST_TEST(ss.str().empty());
+            ss << std::wstring(40, L'x') << i;
+            BOOST_TEST(ss.str() == std::wstring(40, L'x') + wchar_t(L'0' + i));
+        }
+    }
+
     return boost::report_errors();
 }
@@ -5,13 +5,16 @@
 
 #include <boost/ui/string.hpp>
 #include <boost/ui/string_io.hpp>
+#include <boost/ui/string_builder.hpp>
 
 #include <boost/functional/hash.hpp>
 
 #include <boost/core/lightweight_test.hpp>
 #include <boost/detail/lightweight_main.hpp>
 
+#include <cwchar>
 #include <sstream>
+#include <limits>
 
 namespace ui = boost::ui;
 
@@ -180,20 +183,17 @@ void test_uistring()
         static const char32_t charsUTF32[] = U"\U0000041a\U00000438\U00000457\U00000432\U0001D11E";
         const ui::uistring str = charsUTF32;
         std::wstring wstr = str.wstring();
-        BOOST_TEST_EQ(wstr.size(), 5u);
         BOOST_TEST_EQ(wstr[0], 0x041A);
         BOOST_TEST_EQ(wstr[1], 0x0438);
         BOOST_TEST_EQ(wstr[2], 0x0457);
         BOOST_TEST_EQ(wstr[3], 0x0432);
         if ( sizeof(wchar_t) == 2 )
-            ; // TODO: Fix when sizeof(wchar_t) < sizeof(char32_t)
+            BOOST_TEST_EQ(wstr.size(), 6u);
         else
-        {
-        BOOST_TEST_EQ(wstr[4], 0x1d11e);
+            BOOST_TEST_EQ(wstr[4], 0x1d11e);
         BOOST_TEST(str.u32string() == charsUTF32);
         BOOST_TEST(str.utf<char32_t>() == charsUTF32);
         BOOST_TEST(str.basic_string<char32_t>() == charsUTF32);
-        }
     }
 #endif
     {
@@ -262,6 +262,357 @@ void test_uistring()
     }
 }
 
+void test_small_string()
+{
+    const std::string short_str(23, 's');
+    const std::string long_str(24, 'l');
+
+    BOOST_TEST_EQ(ui::uistring(short_str).string(), short_str);
+    BOOST_TEST_EQ(ui::uistring(long_str).string(), long_str);
+    BOOST_TEST(ui::uistring(short_str) > ui::uistring(long_str));
+    BOOST_TEST(ui::uistring(long_str) < ui::uistring(short_str));
+    BOOST_TEST(ui::uistring(std::string(23, 'l')) < ui::uistring(long_str));
+    BOOST_TEST(ui::uistring(long_str) > ui::uistring(std::string(23, 'l')));
+    BOOST_TEST(ui::uistring(short_str + "s") == ui::uistring(std::wstring(24, L's')));
+
+    {
+        ui::uistring str(short_str);
+        str += "x";
+        BOOST_TEST_EQ(str.string(), short_str + "x");
+        str.clear();
+        BOOST_TEST(str.empty());
+    }
+
+    {
+        ui::uistring str("abc");
+        str += str;
+        BOOST_TEST_EQ(str, "abcabc");
+        for ( int i = 0; i < 3; i++ )
+            str += str;
+        BOOST_TEST_EQ(str.string().size(), 48u);
+        BOOST_TEST_EQ(str.string().substr(42), "abcabc");
+    }
+
+    {
+        ui::uistring str(long_str);
+        str.clear();
+        str.push_back('x');
+        str.append(2, L'y');
+        BOOST_TEST_EQ(str, "xyy");
+    }
+
+    {
+        ui::uistring str(long_str);
+        const ui::uistring copy(str);
+        str.assign(ui::uistring("short"));
+        BOOST_TEST_EQ(str, "short");
+        BOOST_TEST_EQ(copy.string(), long_str);
+        str = copy;
+        BOOST_TEST_EQ(str.string(), long_str);
+    }
+
+    {
+        ui::uistring str("def");
+        str.prepend("abc");
+        BOOST_TEST_EQ(str, "abcdef");
+        str.prepend(str);
+        BOOST_TEST_EQ(str, "abcdefabcdef");
+        str.prepend(short_str);
+        BOOST_TEST_EQ(str.string(), short_str + "abcdefabcdef");
+        str.prepend("x");
+        BOOST_TEST_EQ(str.string(), "x" + short_str + "abcdefabcdef");
+        str.prepend(ui::uistring(long_str));
+        BOOST_TEST_EQ(str.string(), long_str + "x" + short_str + "abcdefabcdef");
+
+        ui::uistring short_uistr("s");
+        short_uistr.prepend(ui::uistring(long_str));
+        BOOST_TEST_EQ(short_uistr.string(), long_str + "s");
+    }
+
+    {
+        ui::uistring a("a"), b(long_str);
+        a.swap(b);
+        BOOST_TEST_EQ(a.string(), long_str);
+        BOOST_TEST_EQ(b, "a");
+    }
+
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+    {
+        ui::uistring a("moved");
+        ui::uistring b(std::move(a));
+        BOOST_TEST_EQ(b, "moved");
+        BOOST_TEST(a.empty());
+    }
+#endif
+
+    {
+        // 11 Cyrillic letters take 22 bytes, 12 ones take 24 bytes in UTF-8
+        const std::wstring cyrillic(11, wchar_t(0x0457));
+        ui::uistring str(cyrillic);
+        BOOST_TEST(str.wstring() == cyrillic);
+        BOOST_TEST_EQ(str.u8string().size(), 22u);
+        str.push_back(wchar_t(0x0457));
+        BOOST_TEST(str.wstring() == cyrillic + wchar_t(0x0457));
+        BOOST_TEST(ui::uistring(cyrillic) < str);
+        BOOST_TEST(str > ui::uistring(cyrillic));
+        BOOST_TEST_EQ(ui::uistring(L"a\x0457" L"b").asciistring(), "a_b");
+        BOOST_TEST(ui::uistring(L"\x0457") > ui::uistring(long_str));
+        BOOST_TEST(ui::uistring(long_str) < ui::uistring(L"\x0457"));
+    }
+
+    {
+        // U+FFFD is less than U+10000 by code points,
+        // but greater by UTF-16 code units
+        const std::string replacement = "\xEF\xBF\xBD";
+        const std::string linear_b = "\xF0\x90\x80\x80";
+        const ui::uistring short_lo = ui::utf8(replacement.c_str());
+        const ui::uistring short_hi = ui::utf8(linear_b.c_str());
+        std::string lo = replacement, hi = linear_b;
+        for ( int i = 0; i < 9; i++ )
+            lo += replacement, hi += linear_b;
+        const ui::uistring long_lo = ui::utf8(lo.c_str());
+        const ui::uistring long_hi = ui::utf8(hi.c_str());
+
+        BOOST_TEST(short_lo < short_hi);
+        BOOST_TEST(short_lo < long_hi);
+        BOOST_TEST(long_lo < short_hi);
+        BOOST_TEST(long_lo < long_hi);
+        BOOST_TEST(long_hi > long_lo);
+        BOOST_TEST(long_hi > short_lo);
+        BOOST_TEST(short_hi > long_lo);
+
+        ui::uistring doubled_hi(long_hi);
+        doubled_hi += long_hi;
+        BOOST_TEST(long_lo < doubled_hi);
+        BOOST_TEST(doubled_hi > short_lo);
+    }
+
+    {
+        ui::uistring str(long_str);
+        str.clear();
+        str.shrink_to_fit();
+        BOOST_TEST(str.empty());
+    }
+}
+
+void test_utf()
+{
+    // Long enough for vectorized conversion of ASCII parts
+    const std::string ascii(100, 'a');
+
+#ifndef BOOST_NO_CXX11_CHAR16_T
+    {
+        // U+1D11E - Musical symbol G-clef, encoded with surrogate pair
+        const std::u16string chars = std::u16string(40, u'a') +
+            u"\u041a\U0001D11E" + std::u16string(40, u'b');
+        const ui::uistring str = chars;
+        BOOST_TEST(str.u16string() == chars);
+        BOOST_TEST_EQ(str.u8string(),
+            std::string(40, 'a') + "\xD0\x9A\xF0\x9D\x84\x9E" + std::string(40, 'b'));
+#ifndef BOOST_NO_CXX11_CHAR32_T
+        BOOST_TEST(str.u32string() ==
+            std::u32string(40, U'a') + U"\u041a\U0001D11E" + std::u32string(40, U'b'));
+#endif
+
+        ui::uistring appended;
+        appended += { char16_t(0xD834), char16_t(0xDD1E) };
+        BOOST_TEST(appended.u16string() == u"\U0001D11E");
+
+        // Lone surrogate is replaced with U+FFFD
+        const char16_t lone[] = { u'x', char16_t(0xD834), u'y', 0 };
+        BOOST_TEST(ui::uistring(lone).u16string() == u"x\uFFFDy");
+
+        BOOST_TEST(ui::uistring(ascii).u16string() == std::u16string(100, u'a'));
+        BOOST_TEST_EQ(ui::uistring(std::u16string(100, u'a')).string(), ascii);
+    }
+#endif
+#ifndef BOOST_NO_CXX11_CHAR32_T
+    {
+        const std::u32string chars = std::u32string(40, U'a') +
+            U"\U0001D11E\u0457" + std::u32string(40, U'b');
+        const ui::uistring str = chars;
+        BOOST_TEST(str.u32string() == chars);
+
+        ui::uistring pushed("x");
+        pushed.push_back(U'\U0001D11E');
+        BOOST_TEST(pushed.u32string() == U"x\U0001D11E");
+        pushed.append(2, U'\U0001D11E');
+        BOOST_TEST(pushed.u32string() == U"x\U0001D11E\U0001D11E\U0001D11E");
+
+        BOOST_TEST(ui::uistring(ascii).u32string() == std::u32string(100, U'a'));
+        BOOST_TEST_EQ(ui::uistring(std::u32string(100, U'a')).string(), ascii);
+    }
+#endif
+    {
+        const std::wstring wide = std::wstring(50, L'a') + wchar_t(0x0457) +
+            std::wstring(50, L'b');
+        const ui::uistring str = wide;
+        BOOST_TEST(str.wstring() == wide);
+        BOOST_TEST_EQ(str.u8string(),
+            std::string(50, 'a') + "\xD1\x97" + std::string(50, 'b'));
+        BOOST_TEST(ui::utf8(str.u8string().c_str()).wstring() == wide);
+    }
+}
+
+void test_string_view()
+{
+    const char chars[] = "abcdef";
+    BOOST_TEST_EQ(ui::uistring(chars + 1, 3), "bcd");
+    BOOST_TEST_EQ(ui::uistring(L"abcdef" + 2, 2), "cd");
+    BOOST_TEST_EQ(ui::uistring().append(chars, 2).append(L"xyz", 1), "abx");
+    BOOST_TEST_EQ(ui::utf8("\xD1\x97z", 2).wstring().size(), 1u);
+    BOOST_TEST_EQ(ui::ascii(chars, 6), "abcdef");
+    BOOST_TEST_EQ(ui::ascii(std::string("a\0b", 3)).string().size(), 3u);
+
+    {
+        const std::string long_str(30, 'l');
+        ui::uistring str("x");
+        str.append(long_str.data(), long_str.size());
+        BOOST_TEST_EQ(str.string(), "x" + long_str);
+        str.append(L"yz", 2);
+        BOOST_TEST_EQ(str.string(), "x" + long_str + "yz");
+    }
+
+#ifndef BOOST_NO_CXX11_CHAR16_T
+    BOOST_TEST_EQ(ui::uistring(u"abcdef", 3), "abc");
+    BOOST_TEST_EQ(ui::uistring().append(u"\U0001D11E", 2).u32string().size(), 1u);
+#endif
+#ifndef BOOST_NO_CXX11_CHAR32_T
+    BOOST_TEST_EQ(ui::uistring(U"abcdef" + 3, 3), "def");
+#endif
+
+#ifndef BOOST_NO_CXX17_HDR_STRING_VIEW
+    const std::string_view view("0123456789", 10);
+    BOOST_TEST_EQ(ui::uistring(view.substr(2, 3)), "234");
+    BOOST_TEST_EQ(ui::uistring(std::wstring_view(L"wide")), "wide");
+    BOOST_TEST_EQ(ui::uistring(std::u16string_view(u"utf16")), "utf16");
+    BOOST_TEST_EQ(ui::uistring(std::u32string_view(U"utf32")), "utf32");
+    BOOST_TEST_EQ(ui::uistring("a").append(view.substr(8)), "a89");
+    BOOST_TEST_EQ(ui::uistring("a").append(std::u16string_view(u"bc")), "abc");
+    BOOST_TEST(ui::utf8(std::string_view("\xD1\x97")).wstring() == std::wstring(1, wchar_t(0x0457)));
+
+    {
+        std::string buffer;
+        const ui::uistring str = ui::utf8("\xD1\x97 short");
+        BOOST_TEST(str.u8_view(buffer) == "\xD1\x97 short");
+        BOOST_TEST(str.u8_view(buffer).data() == str.u8_view(buffer).data());
+        BOOST_TEST(buffer.empty());
+
+        const std::string long_str(40, 'l');
+        const ui::uistring long_uistr(long_str);
+        BOOST_TEST(long_uistr.u8_view(buffer) == long_str);
+
+        // Const string isn't modified
+        const ui::uistring copy(long_uistr);
+        BOOST_TEST(copy.u8_view(buffer) == long_str);
+        BOOST_TEST(copy == long_uistr);
+
+        ui::uistring self("self");
+        self.append(self.u8_view(buffer));
+        BOOST_TEST_EQ(self, "selfself");
+        self.append(self.u8_view(buffer));
+        self.append(self.u8_view(buffer));
+        BOOST_TEST_EQ(self.string(), "selfselfselfselfselfselfselfself");
+    }
+#endif
+}
+
+void test_hash()
+{
+    boost::hash<ui::uistring> boost_hash;
+
+    // Native string has the same hash as inline stored one
+    ui::uistring native("abc");
+    BOOST_TEST(static_cast<const ui::uistring&>(native).native_handle() == NULL);
+    BOOST_TEST(native.native_handle() != NULL);
+    BOOST_TEST(static_cast<const ui::uistring&>(native).native_handle() != NULL);
+    BOOST_TEST_EQ(native, "abc");
+    BOOST_TEST_EQ(boost_hash(native), boost_hash(ui::uistring("abc")));
+
+    const std::wstring wide = std::wstring(30, L'w') + wchar_t(0x0457);
+    ui::uistring str(wide);
+    const std::size_t hash = boost_hash(str);
+    BOOST_TEST_EQ(boost_hash(str), hash);
+    BOOST_TEST_EQ(hash, boost_hash(ui::utf8(str.u8string())));
+
+    // Cached hash is updated after modification
+    str += L"x";
+    BOOST_TEST_NE(boost_hash(str), hash);
+    BOOST_TEST_EQ(boost_hash(str), boost_hash(ui::uistring(wide + L"x")));
+    str = ui::uistring(wide);
+    BOOST_TEST_EQ(boost_hash(str), hash);
+
+    BOOST_TEST_NE(boost_hash(ui::uistring("")), boost_hash(ui::uistring(std::string(1, '\0'))));
+    BOOST_TEST_NE(boost_hash(ui::uistring(std::string(8, 'a'))),
+                  boost_hash(ui::uistring(std::string(9, 'a'))));
+
+#if WCHAR_MAX <= 0xFFFF
+    {
+        // Surrogate pair split between chunks is hashed like the joined one
+        ui::uistring rope(std::wstring(( 1 << 20 ) - 1, L'r'));
+        rope += std::wstring(( 1 << 16 ) - 1, L'c');
+        rope.push_back(wchar_t(0xD800));
+        rope.push_back(wchar_t(0xDC00));
+        const ui::uistring joined(rope.wstring());
+        BOOST_TEST(rope == joined);
+        BOOST_TEST_EQ(boost_hash(rope), boost_hash(joined));
+    }
+#endif
+
+#ifndef BOOST_UI_NO_STD_HASH
+    std::hash<ui::uistring> std_hash;
+    BOOST_TEST_EQ(std_hash(str), boost_hash(str));
+#endif
+}
+
+void test_string_builder()
+{
+    boost::hash<ui::uistring> boost_hash;
+
+    ui::uistring_builder builder(16);
+    BOOST_TEST(builder.empty());
+    builder << "a" << L"b";
+    builder.append(L"cde", 2).append(2, L'x').append_number(12);
+    BOOST_TEST_EQ(builder.str(), "abcdxx12");
+    BOOST_TEST_EQ(builder.release(), "abcdxx12");
+    BOOST_TEST(builder.empty());
+
+    // Large text is collected into chunks
+    const std::wstring line = std::wstring(60, L'w') + wchar_t(0x0457) + L'\n';
+    std::wstring expected;
+    for ( int i = 0; i < 50000; i++ )
+    {
+        builder += line;
+        expected += line;
+    }
+    builder.append(100000, L'z');
+    expected.append(100000, L'z');
+
+    ui::uistring text = builder.release();
+    BOOST_TEST(!text.empty());
+    BOOST_TEST(text.wstring() == expected);
+    BOOST_TEST(text.u8string() == ui::uistring(expected).u8string());
+    BOOST_TEST(text == ui::uistring(expected));
+    BOOST_TEST(text != ui::uistring(expected + L"!"));
+    BOOST_TEST(text > ui::uistring(expected.substr(0, expected.size() - 1)));
+    BOOST_TEST(text < ui::uistring(expected.substr(0, 100) + L"x"));
+    BOOST_TEST(text > ui::uistring(L"w"));
+    BOOST_TEST(text < ui::uistring(L"x"));
+    BOOST_TEST_EQ(boost_hash(text), boost_hash(ui::uistring(expected)));
+
+    ui::uistring copy(text);
+    copy += text;
+    BOOST_TEST(copy.wstring() == expected + expected);
+    copy = text;
+    copy.shrink_to_fit();
+    BOOST_TEST(copy == text);
+
+    // Native handle joins chunks
+    text.native_handle();
+    BOOST_TEST(text.wstring() == expected);
+    BOOST_TEST(text == copy);
+}
+
 void test_touistring()
 {
     BOOST_TEST_EQ(ui::to_uistring(-12), "-12");
@@ -272,6 +623,52 @@ void test_touistring()
     BOOST_TEST_EQ(ui::to_uistring(2.3).wstring().find(L"2.3"), 0);
     BOOST_TEST_EQ(ui::to_uistring(3.4l).wstring().find(L"3.4"), 0);
     BOOST_TEST_EQ(ui::uistring("a") + ui::to_uistring(1), "a1");
+    BOOST_TEST_EQ(ui::to_uistring(0.1), "0.1");
+    BOOST_TEST_EQ(ui::to_uistring(0.1f), "0.1");
+    BOOST_TEST_EQ(ui::to_uistring(1.0 / 3), "0.3333333333333333");
+}
+
+void test_append_number()
+{
+    ui::uistring str;
+    BOOST_TEST_EQ(ui::append_number(str, 0), "0");
+    BOOST_TEST_EQ(ui::append_number(str.append(1, ' '), -1234567), "0 -1234567");
+
+    str.clear();
+    BOOST_TEST_EQ(ui::append_number(str, (std::numeric_limits<int>::min)()), "-2147483648");
+    str.clear();
+    BOOST_TEST_EQ(ui::append_number(str, (std::numeric_limits<unsigned long long>::max)()),
+                  "18446744073709551615");
+    str.clear();
+    BOOST_TEST_EQ(ui::append_number(str, 255u, ui::number_format::hex), "ff");
+    str.clear();
+    BOOST_TEST_EQ(ui::append_number(str, -255l, ui::number_format::hex), "-ff");
+
+    str.clear();
+    BOOST_TEST_EQ(ui::append_number(str, 123456789.0), "123456789");
+    str.clear();
+    BOOST_TEST_EQ(ui::append_number(str, 1e21), "1e+21");
+    str.clear();
+    BOOST_TEST_EQ(ui::append_number(str, 1e-7), "1e-07");
+    str.clear();
+    BOOST_TEST_EQ(ui::append_number(str, 3.14159, ui::number_format::fixed, 2), "3.14");
+    str.clear();
+    BOOST_TEST_EQ(ui::append_number(str, 0.001, ui::number_format::fixed), "0.001");
+    str.clear();
+    BOOST_TEST_EQ(ui::append_number(str, 1e22, ui::number_format::fixed),
+                  "10000000000000000000000");
+    str.clear();
+    BOOST_TEST_EQ(ui::append_number(str, 1234.56, ui::number_format::scientific, 3), "1.235e+03");
+    str.clear();
+    BOOST_TEST_EQ(ui::append_number(str, 1500.0, ui::number_format::scientific), "1.5e+03");
+
+    // Longer than inline buffer
+    str = "value: ";
+    ui::append_number(str, 1e300, ui::number_format::fixed);
+    BOOST_TEST_EQ(str.string().size(), 7u + 301u);
+    BOOST_TEST_EQ(str.string().substr(0, 8), "value: 1");
+    ui::append_number(str, 42);
+    BOOST_TEST_EQ(str.string().substr(str.string().size() - 3), "042");
 }
 
 template <class CharT>
@@ -318,7 +715,13 @@ int cpp_main(int, char*[])
 {
     test_api_compatibility();
     test_uistring();
+    test_small_string();
+    test_utf();
+    test_string_view();
+    test_hash();
+    test_string_builder();
     test_touistring();
+    test_append_number();
     test_ostream<char>();
     test_istream<char>();
     test_getline<char>();
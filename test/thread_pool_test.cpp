@@ -0,0 +1,138 @@
+// Copyright (c) 2018 Kolya Kosenko
+
+// Distributed under the Boost Software License, Version 1.0.
+// See http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/ui.hpp>
+
+#include <boost/bind.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <boost/detail/lightweight_main.hpp>
+
+#include <wx/thread.h>
+
+#include <vector>
+
+namespace ui = boost::ui;
+
+namespace {
+
+const int tasks_count = 100;
+
+int square(int value)
+{
+    return value * value;
+}
+
+long g_sum = 0;
+int g_results = 0;
+
+void on_result(int value, ui::event_loop* loop)
+{
+    g_sum += value;
+    if ( ++g_results == tasks_count )
+        loop->exit();
+}
+
+wxCriticalSection g_lock;
+int g_posted = 0;
+
+void posted()
+{
+    wxCriticalSectionLocker locker(g_lock);
+    g_posted++;
+}
+
+#ifndef BOOST_UI_NO_COROUTINES
+
+int g_hops = 0;
+int g_wrong_threads = 0;
+
+// Alternates between worker and UI threads
+ui::coroutine pipeline(ui::thread_pool& pool, ui::event_loop& loop)
+{
+    for ( int i = 0; i < 10; i++ )
+    {
+        co_await ui::resume_on_pool(pool);
+        if ( wxThread::IsMain() )
+            g_wrong_threads++;
+
+        co_await ui::resume_on_ui();
+        if ( !wxThread::IsMain() )
+            g_wrong_threads++;
+        g_hops++;
+    }
+
+    loop.exit();
+}
+
+#endif
+
+} // unnamed namespace
+
+void test_post()
+{
+    {
+        ui::thread_pool pool(4);
+        BOOST_TEST_EQ(pool.size(), 4u);
+
+        for ( int i = 0; i < 1000; i++ )
+            pool.post(&posted);
+    }
+
+    // Pool destructor waits for posted functions
+    BOOST_TEST_EQ(g_posted, 1000);
+}
+
+void test_async()
+{
+    ui::thread_pool pool;
+    BOOST_TEST(pool.size() > 0);
+
+    ui::event_loop loop;
+    std::vector< ui::task<int> > tasks;
+    long expected = 0;
+    for ( int i = 0; i < tasks_count; i++ )
+    {
+        tasks.push_back(ui::async(pool, boost::bind(&square, i))
+            .then_on_ui(boost::bind(&on_result, _1, &loop)));
+        expected += square(i);
+    }
+
+    loop.run();
+
+    BOOST_TEST_EQ(g_results, tasks_count);
+    BOOST_TEST_EQ(g_sum, expected);
+    BOOST_TEST(tasks.front().ready());
+    BOOST_TEST(tasks.back().ready());
+}
+
+#ifndef BOOST_UI_NO_COROUTINES
+void test_coroutine()
+{
+    ui::thread_pool pool(2);
+    ui::event_loop loop;
+
+    pipeline(pool, loop);
+    loop.run();
+
+    BOOST_TEST_EQ(g_hops, 10);
+    BOOST_TEST_EQ(g_wrong_threads, 0);
+}
+#endif
+
+int ui_main()
+{
+    test_post();
+    test_async();
+#ifndef BOOST_UI_NO_COROUTINES
+    test_coroutine();
+#endif
+
+    return boost::report_errors();
+}
+
+int cpp_main(int argc, char* argv[])
+{
+    return ui::entry(&ui_main, argc, argv);
+}
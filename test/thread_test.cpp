@@ -0,0 +1,305 @@
+// Copyright (c) 2018 Kolya Kosenko
+
+// Distributed under the Boost Software License, Version 1.0.
+// See http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/ui.hpp>
+
+#include <boost/bind.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <boost/detail/lightweight_main.hpp>
+
+#include <wx/wx.h>
+#include <wx/stopwatch.h>
+
+#include <iostream>
+#include <vector>
+
+namespace ui = boost::ui;
+
+namespace {
+
+std::vector<int> g_order;
+int g_chunks = 0;
+
+void push(int value)
+{
+    g_order.push_back(value);
+}
+
+bool idle_chunk(ui::event_loop* loop)
+{
+    if ( ++g_chunks < 5 )
+        return true;
+
+    loop->exit();
+    return false;
+}
+
+int g_progress = 0;
+int g_progress_calls = 0;
+std::vector<int> g_statuses;
+
+void set_progress(int value)
+{
+    g_progress = value;
+    g_progress_calls++;
+}
+
+void set_status(int value)
+{
+    g_statuses.push_back(value);
+}
+
+std::vector<int> g_latest_order;
+
+void push_latest(int value)
+{
+    g_latest_order.push_back(value);
+}
+
+const int async_threads_count = 16;
+const int async_calls_count = 20000; // Per thread
+
+wxStopWatch g_stopwatch;
+long g_async_calls = 0;
+double g_total_latency = 0;
+long g_max_latency = 0;
+
+// Batch is the async calls that are called in one event loop iteration,
+// high priority task marks the start of every iteration
+bool g_batches_measured = false;
+long g_batches = 0;
+long g_batch_calls = 0;
+long g_max_batch_size = 0;
+long g_batch_start = 0;
+long g_batch_end = 0;
+double g_total_batch_time = 0;
+long g_max_batch_time = 0;
+
+void finish_batch()
+{
+    if ( !g_batch_calls )
+        return;
+
+    g_batches++;
+    if ( g_batch_calls > g_max_batch_size )
+        g_max_batch_size = g_batch_calls;
+
+    const long duration = g_batch_end - g_batch_start;
+    g_total_batch_time += duration;
+    if ( duration > g_max_batch_time )
+        g_max_batch_time = duration;
+
+    g_batch_calls = 0;
+}
+
+void start_batch()
+{
+    finish_batch();
+    if ( !g_batches_measured )
+        return;
+
+    g_batch_start = g_stopwatch.TimeInMicro().ToLong();
+    ui::post(ui::task_priority::high, &start_batch);
+}
+
+void on_async_call(long pushed, ui::event_loop* loop)
+{
+    const long now = g_stopwatch.TimeInMicro().ToLong();
+    const long latency = now - pushed;
+    g_total_latency += latency;
+    if ( latency > g_max_latency )
+        g_max_latency = latency;
+
+    g_batch_calls++;
+    g_batch_end = now;
+
+    if ( ++g_async_calls == long(async_threads_count) * async_calls_count )
+    {
+        g_batches_measured = false;
+        loop->exit();
+    }
+}
+
+class async_thread : public wxThread
+{
+public:
+    explicit async_thread(ui::event_loop& loop)
+        : wxThread(wxTHREAD_JOINABLE), m_loop(loop) {}
+
+protected:
+    virtual ExitCode Entry()
+    {
+        for ( int i = 0; i < async_calls_count; i++ )
+            ui::call_async(boost::bind(&on_async_call, g_stopwatch.TimeInMicro().ToLong(), &m_loop));
+        return 0;
+    }
+
+private:
+    ui::event_loop& m_loop;
+};
+
+#ifndef BOOST_UI_NO_CALL_ASYNC_FUTURE
+
+int square(int value)
+{
+    return value * value;
+}
+
+class future_thread : public wxThread
+{
+public:
+    explicit future_thread(ui::event_loop& loop)
+        : wxThread(wxTHREAD_JOINABLE), m_loop(loop), m_result(0) {}
+
+    int result() const { return m_result; }
+
+protected:
+    virtual ExitCode Entry()
+    {
+        // Worker thread waits for the result of UI thread
+        m_result = ui::call_async_future(&square, 7).get();
+        ui::call_async(&ui::event_loop::exit, &m_loop);
+        return 0;
+    }
+
+private:
+    ui::event_loop& m_loop;
+    int m_result;
+};
+
+#endif
+
+} // unnamed namespace
+
+#ifndef BOOST_UI_NO_CALL_ASYNC_FUTURE
+void test_call_async_future()
+{
+    ui::event_loop loop;
+    future_thread thread(loop);
+    BOOST_TEST(thread.Run() == wxTHREAD_NO_ERROR);
+    loop.run();
+    thread.Wait();
+
+    BOOST_TEST_EQ(thread.result(), 49);
+}
+#endif
+
+void test_call_async_latest()
+{
+    for ( int i = 0; i <= 100; i++ )
+    {
+        ui::call_async_latest(&g_progress, boost::bind(&set_progress, i));
+        ui::call_async_latest(&g_statuses, boost::bind(&set_status, i));
+    }
+
+    ui::event_loop loop;
+    ui::call_async_latest(&loop, boost::bind(&ui::event_loop::exit, &loop));
+    loop.run();
+
+    BOOST_TEST_EQ(g_progress, 100);
+    BOOST_TEST_EQ(g_progress_calls, 1);
+    BOOST_TEST_EQ(g_statuses.size(), 1u);
+    BOOST_TEST(!g_statuses.empty() && g_statuses.back() == 100);
+}
+
+void test_call_async_latest_order()
+{
+    // Keys addresses are in the reverse order of posting
+    int keys[3];
+    ui::call_async_latest(&keys[2], boost::bind(&push_latest, 1));
+    ui::call_async_latest(&keys[1], boost::bind(&push_latest, 2));
+    ui::call_async_latest(&keys[0], boost::bind(&push_latest, 3));
+
+    // Replaced call keeps its position
+    ui::call_async_latest(&keys[2], boost::bind(&push_latest, 4));
+
+    ui::event_loop loop;
+    ui::call_async_latest(&loop, boost::bind(&ui::event_loop::exit, &loop));
+    loop.run();
+
+    std::vector<int> expected;
+    expected.push_back(4);
+    expected.push_back(2);
+    expected.push_back(3);
+    BOOST_TEST(g_latest_order == expected);
+}
+
+void test_call_async()
+{
+    ui::event_loop loop;
+    std::vector<async_thread*> threads;
+
+    g_stopwatch.Start();
+    g_batches_measured = true;
+    start_batch();
+    for ( int i = 0; i < async_threads_count; i++ )
+    {
+        threads.push_back(new async_thread(loop));
+        BOOST_TEST(threads.back()->Run() == wxTHREAD_NO_ERROR);
+    }
+
+    loop.run();
+    const long elapsed = g_stopwatch.Time();
+    finish_batch();
+
+    for ( std::size_t i = 0; i < threads.size(); i++ )
+    {
+        threads[i]->Wait();
+        delete threads[i];
+    }
+
+    BOOST_TEST_EQ(g_async_calls, long(async_threads_count) * async_calls_count);
+
+    // Event loop iteration calls up to 1024 async calls
+    BOOST_TEST(g_batches > 0);
+    BOOST_TEST(g_max_batch_size <= 1024);
+
+    std::cout << "call_async: " << g_async_calls * 1000 / ( elapsed ? elapsed : 1 )
+              << " calls per second, latency average "
+              << long(g_total_latency / g_async_calls)
+              << " us, maximal " << g_max_latency << " us" << std::endl;
+    std::cout << "call_async: " << g_batches << " batches, size average "
+              << g_async_calls / ( g_batches ? g_batches : 1 )
+              << " calls, maximal " << g_max_batch_size
+              << ", duration average "
+              << long(g_total_batch_time / ( g_batches ? g_batches : 1 ))
+              << " us, maximal " << g_max_batch_time << " us" << std::endl;
+}
+
+void test_post()
+{
+    ui::post(ui::task_priority::idle,   boost::bind(&push, 3));
+    ui::post(ui::task_priority::normal, boost::bind(&push, 2));
+    ui::post(ui::task_priority::high,   boost::bind(&push, 1));
+
+    ui::event_loop loop;
+    ui::on_idle(boost::bind(&idle_chunk, &loop));
+    loop.run();
+
+    std::vector<int> expected;
+    expected.push_back(1);
+    expected.push_back(2);
+    expected.push_back(3);
+    BOOST_TEST(g_order == expected);
+    BOOST_TEST_EQ(g_chunks, 5);
+}
+
+int ui_main()
+{
+    test_post();
+    test_call_async();
+    test_call_async_latest();
+    test_call_async_latest_order();
+#ifndef BOOST_UI_NO_CALL_ASYNC_FUTURE
+    test_call_async_future();
+#endif
+
+    return boost::report_errors();
+}
+
+int cpp_main(int argc, char* argv[])
+{
+    return ui::entry(&ui_main, argc, argv);
+}
@@ -112,6 +112,12 @@ void test_window(ui::window& parent)
     win.on_mouse_drag_event(&my_handlers::my_handler_event, &a);
     win.on_mouse_drag_event(&my_handlers::my_handler_event_1, &a, 9);
 
+    win.coalesce_events();
+    win.on_mouse_move_event(&my_handler_event);
+    win.on_mouse_drag_event(&my_handler_event_1, 3);
+    win.on_resize(&my_handler);
+    win.coalesce_events(false);
+
     //win.show_modal();
 }
 